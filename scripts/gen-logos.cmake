@@ -0,0 +1,345 @@
+# Generates the builtin logo tables, so that printing and looking up builtin logos needs no parsing at runtime.
+#
+#   cmake -DLOGO_DIR=<src/logo/ascii> -DBUILTIN_C=<src/logo/builtin.c> -DOUTPUT_DIR=<dir> -P gen-logos.cmake
+#
+# logo_builtin.h:       FASTFETCH_DATATEXT_LOGO_<NAME>, the text of every logo with its pre-split lines (see `FFLogoText`)
+# logo_builtin_index.h: ffLogoBuiltinIndex, a perfect hash of the names in builtin.c (see `FFLogoBuiltinIndex`)
+
+cmake_minimum_required(VERSION 3.12.0)
+
+# Keep in sync with `FF_LOGO_SPAN_DOLLAR` in src/logo/logo.h
+set(SPAN_DOLLAR 10)
+
+set(HEX_DIGITS 0 1 2 3 4 5 6 7 8 9 a b c d e f)
+set(index 0)
+foreach(digit ${HEX_DIGITS})
+    set(HEX_VALUE_${digit} ${index})
+    math(EXPR index "${index} + 1")
+endforeach()
+
+function(encode_c_string STR OUTVAR)
+    string(REGEX REPLACE "\n$" "" TEMP "${STR}")  # Remove trailing newline
+    string(REPLACE "\\" "\\\\" TEMP "${TEMP}")    # Escape backslashes
+    string(REPLACE "\n" "\\n" TEMP "${TEMP}")     # Replace newlines with \n
+    string(REPLACE "\"" "\\\"" TEMP "${TEMP}")    # Replace quotes with \"
+    set(${OUTVAR} "\"${TEMP}\"" PARENT_SCOPE)
+endfunction()
+
+# Appends `values` to the C array initializer `out`, 16 values per line
+function(append_values OUTVAR)
+    set(result "${${OUTVAR}}")
+    set(count 0)
+    foreach(value ${ARGN})
+        if(count EQUAL 0)
+            string(APPEND result "\n   ")
+        endif()
+        string(APPEND result " ${value},")
+        math(EXPR count "(${count} + 1) % 16")
+    endforeach()
+    set(${OUTVAR} "${result}" PARENT_SCOPE)
+endfunction()
+
+# Splits the logo into lines of spans, replicating what `logoLineCacheBuild` does with color replacement enabled.
+# Works on the hex dump of the file, so that `;`, `[` and `\` need no escaping. Each byte is written as `xx `.
+# Outputs an empty string if the logo uses something the layout can't express; it is parsed at runtime then
+function(logo_layout FILE OUTVAR)
+    set(${OUTVAR} "" PARENT_SCOPE)
+
+    file(READ "${FILE}" hex HEX)
+    string(REGEX REPLACE "0a$" "" hex "${hex}")
+    string(REGEX REPLACE "(..)" "\\1 " hex "${hex}")
+    if(hex STREQUAL "" OR " ${hex}" MATCHES " (09|0d|1b) ") # Tabs and escape codes
+        return()
+    endif()
+
+    string(REPLACE "0a " ";" lines "${hex}")
+    set(layout "")
+    set(lineCount 0)
+    set(offset 0)
+    foreach(line IN LISTS lines)
+        string(REGEX MATCHALL "24 3[1-9] |24 24 |24 [0-7][0-9a-f] |(([013-9a-f][0-9a-f]|2[0-35-9a-f]) )+|24 " tokens "${line}")
+        set(width 0)
+        set(pipeWidth 0)
+        set(spans "")
+        set(spanCount 0)
+        set(mergeable FALSE) # If the next text can be appended to the last span
+        foreach(token IN LISTS tokens)
+            string(LENGTH "${token}" length)
+            math(EXPR length "${length} / 3")
+            if(token MATCHES "^24 3([1-9]) $")
+                list(APPEND spans ${CMAKE_MATCH_1} 0 0)
+                math(EXPR spanCount "${spanCount} + 1")
+                set(mergeable TRUE)
+            elseif(token STREQUAL "24 24 ")
+                math(EXPR textOffset "${offset} + 1")
+                list(APPEND spans 0 ${textOffset} 1)
+                math(EXPR spanCount "${spanCount} + 1")
+                math(EXPR width "${width} + 1")
+                math(EXPR pipeWidth "${pipeWidth} + 1")
+                set(mergeable TRUE)
+            elseif(token MATCHES "^24 .. $")
+                # `$` followed by a char that isn't a color index. Printed as is, but both chars are dropped when piping
+                list(APPEND spans ${SPAN_DOLLAR} ${offset} 2)
+                math(EXPR spanCount "${spanCount} + 1")
+                math(EXPR width "${width} + 2")
+                set(mergeable FALSE)
+            elseif(token STREQUAL "24 ")
+                return() # `$` followed by a multibyte char or at the end of a line
+            else()
+                # Every byte that doesn't continue a UTF-8 sequence is a cell
+                string(REGEX MATCHALL "[89ab]. " continuations "${token}")
+                list(LENGTH continuations cells)
+                math(EXPR cells "${length} - ${cells}")
+                math(EXPR width "${width} + ${cells}")
+                math(EXPR pipeWidth "${pipeWidth} + ${cells}")
+                if(mergeable)
+                    # Extend the text of the last span
+                    list(LENGTH spans last)
+                    math(EXPR last "${last} - 1")
+                    list(GET spans ${last} spanLength)
+                    if(spanLength EQUAL 0)
+                        math(EXPR lastOffset "${last} - 1")
+                        list(REMOVE_AT spans ${lastOffset})
+                        list(INSERT spans ${lastOffset} ${offset})
+                    endif()
+                    list(REMOVE_AT spans ${last})
+                    math(EXPR spanLength "${spanLength} + ${length}")
+                    list(APPEND spans ${spanLength})
+                else()
+                    list(APPEND spans 0 ${offset} ${length})
+                    math(EXPR spanCount "${spanCount} + 1")
+                endif()
+                set(mergeable FALSE)
+            endif()
+            math(EXPR offset "${offset} + ${length}")
+        endforeach()
+        list(APPEND layout ${width} ${pipeWidth} ${spanCount} ${spans})
+        math(EXPR lineCount "${lineCount} + 1")
+        math(EXPR offset "${offset} + 1") # Newline
+    endforeach()
+
+    if(offset GREATER 65536)
+        return()
+    endif()
+    set(${OUTVAR} ${lineCount} ${layout} PARENT_SCOPE)
+endfunction()
+
+# FNV-1a of the ASCII lower case name. Keep in sync with `logoHashName` in src/logo/logo.c
+function(hash_name NAME SEED OUTVAR)
+    string(HEX "${NAME}" hex)
+    string(REGEX MATCHALL ".." bytes "${hex}")
+    set(hash ${SEED})
+    foreach(byte ${bytes})
+        string(SUBSTRING "${byte}" 0 1 high)
+        string(SUBSTRING "${byte}" 1 1 low)
+        math(EXPR value "${HEX_VALUE_${high}} * 16 + ${HEX_VALUE_${low}}")
+        if(value GREATER 64 AND value LESS 91)
+            math(EXPR value "${value} + 32")
+        endif()
+        math(EXPR hash "((${hash} ^ ${value}) * 16777619) & 4294967295")
+    endforeach()
+    set(${OUTVAR} ${hash} PARENT_SCOPE)
+endfunction()
+
+function(next_power_of_two VALUE OUTVAR)
+    set(result 1)
+    while(result LESS VALUE)
+        math(EXPR result "${result} * 2")
+    endwhile()
+    set(${OUTVAR} ${result} PARENT_SCOPE)
+endfunction()
+
+#############
+# Logo text #
+#############
+
+file(GLOB LOGO_FILES "${LOGO_DIR}/*.txt")
+list(SORT LOGO_FILES)
+set(LOGO_BUILTIN_H "#pragma once\n#pragma GCC diagnostic ignored \"-Wtrigraphs\"\n\n// Generated by scripts/gen-logos.cmake. Do not edit\n\n")
+foreach(file ${LOGO_FILES})
+    file(READ "${file}" content)
+    encode_c_string("${content}" content)
+    logo_layout("${file}" layout)
+    get_filename_component(name "${file}" NAME_WE)
+    string(TOUPPER "${name}" name)
+    if(layout STREQUAL "")
+        string(APPEND LOGO_BUILTIN_H "#define FASTFETCH_DATATEXT_LOGO_${name} { .chars = ${content} }\n")
+    else()
+        string(REPLACE ";" ", " layout "${layout}")
+        string(APPEND LOGO_BUILTIN_H "#define FASTFETCH_DATATEXT_LOGO_${name} { .chars = ${content}, .layout = (const uint16_t[]) { ${layout} } }\n")
+    endif()
+endforeach()
+
+##############
+# Name index #
+##############
+
+# Collect the names of every logo, in the order `logoGetBuiltin` checks them
+file(STRINGS "${BUILTIN_C}" sourceLines ENCODING UTF-8 REGEX "^static const FFlogo [A-Z]\\[\\] = |^ +\\.names = ")
+set(keys "")
+foreach(sourceLine IN LISTS sourceLines)
+    if(sourceLine MATCHES "^static const FFlogo ([A-Z])\\[\\]")
+        set(letter ${CMAKE_MATCH_1})
+        string(TOLOWER ${letter} lowerLetter)
+        set(logoIndex 0)
+        continue()
+    endif()
+
+    string(REGEX REPLACE "}.*$" "" sourceLine "${sourceLine}") # Strip trailing comments
+    string(REGEX MATCHALL "\"[^\"]+\"" names "${sourceLine}")
+    foreach(name ${names})
+        string(REGEX REPLACE "^\"|\"$" "" name "${name}")
+        string(SUBSTRING "${name}" 0 1 first)
+        if(NOT first STREQUAL letter AND NOT first STREQUAL lowerLetter)
+            continue() # Never matched, the first char selects the letter
+        endif()
+
+        # Small logos are also matched with the `_small` suffix removed
+        set(variants "${name}")
+        string(LENGTH "${name}" length)
+        if(length GREATER 6)
+            math(EXPR length "${length} - 6")
+            string(SUBSTRING "${name}" 0 ${length} stripped)
+            list(APPEND variants "${stripped}")
+        endif()
+
+        foreach(variant ${variants})
+            string(TOLOWER "${variant}" key)
+            string(HEX "${key}" key) # Usable in variable names
+            if(NOT DEFINED CANDIDATES_${key})
+                list(APPEND keys ${key})
+                set(KEY_NAME_${key} "${variant}")
+            endif()
+            list(FIND CANDIDATES_${key} "&${letter}[${logoIndex}]" found)
+            if(found LESS 0)
+                list(APPEND CANDIDATES_${key} "&${letter}[${logoIndex}]")
+            endif()
+        endforeach()
+    endforeach()
+    math(EXPR logoIndex "${logoIndex} + 1")
+endforeach()
+
+list(LENGTH keys keyCount)
+if(keyCount EQUAL 0)
+    message(FATAL_ERROR "No logo names found in ${BUILTIN_C}")
+endif()
+math(EXPR slotCount "${keyCount} * 2")
+next_power_of_two(${slotCount} slotCount)
+math(EXPR slotMask "${slotCount} - 1")
+math(EXPR bucketCount "${keyCount} / 2")
+next_power_of_two(${bucketCount} bucketCount)
+math(EXPR bucketMask "${bucketCount} - 1")
+
+# Hash and displace: the keys of every bucket are moved together by xor-ing the same displacement,
+# the largest buckets first. Retries with another seed if two keys of a bucket always collide
+set(seed 2166136261)
+while(TRUE)
+    foreach(bucket RANGE ${bucketMask})
+        set(BUCKET_${bucket} "")
+    endforeach()
+    set(maxBucketSize 0)
+    foreach(key ${keys})
+        hash_name("${KEY_NAME_${key}}" ${seed} hash)
+        math(EXPR bucket "${hash} & ${bucketMask}")
+        math(EXPR HASH_${key} "(${hash} >> 16) & ${slotMask}")
+        list(APPEND BUCKET_${bucket} ${key})
+        list(LENGTH BUCKET_${bucket} size)
+        if(size GREATER maxBucketSize)
+            set(maxBucketSize ${size})
+        endif()
+    endforeach()
+
+    foreach(slot RANGE ${slotMask})
+        set(SLOT_${slot} "")
+    endforeach()
+    foreach(bucket RANGE ${bucketMask})
+        set(DISPLACEMENT_${bucket} 0)
+    endforeach()
+    set(ok TRUE)
+    set(size ${maxBucketSize})
+    while(ok AND size GREATER 0)
+        foreach(bucket RANGE ${bucketMask})
+            list(LENGTH BUCKET_${bucket} bucketSize)
+            if(NOT bucketSize EQUAL size)
+                continue()
+            endif()
+
+            set(found FALSE)
+            foreach(displacement RANGE ${slotMask})
+                set(slots "")
+                foreach(key ${BUCKET_${bucket}})
+                    math(EXPR slot "${HASH_${key}} ^ ${displacement}")
+                    if(NOT SLOT_${slot} STREQUAL "" OR slot IN_LIST slots)
+                        set(slots "")
+                        break()
+                    endif()
+                    list(APPEND slots ${slot})
+                endforeach()
+                if(NOT slots STREQUAL "")
+                    set(found ${displacement}) # The loop variable is restored after the loop
+                    break()
+                endif()
+            endforeach()
+            if(found STREQUAL "FALSE")
+                set(ok FALSE)
+                break()
+            endif()
+
+            set(DISPLACEMENT_${bucket} ${found})
+            foreach(key ${BUCKET_${bucket}})
+                list(FIND BUCKET_${bucket} ${key} keyIndex)
+                list(GET slots ${keyIndex} slot)
+                set(SLOT_${slot} ${key})
+            endforeach()
+        endforeach()
+        math(EXPR size "${size} - 1")
+    endwhile()
+
+    if(ok)
+        break()
+    endif()
+    math(EXPR seed "(${seed} + 1) & 4294967295")
+endwhile()
+
+# Every slot points to a NULL terminated list of logos in `candidates`. Slot 0 points to an empty list
+set(displacements "")
+foreach(bucket RANGE ${bucketMask})
+    list(APPEND displacements ${DISPLACEMENT_${bucket}})
+endforeach()
+set(candidates "NULL")
+set(candidateCount 1)
+set(slots "")
+foreach(slot RANGE ${slotMask})
+    set(key "${SLOT_${slot}}")
+    if(key STREQUAL "")
+        list(APPEND slots 0)
+    else()
+        list(APPEND slots ${candidateCount})
+        list(APPEND candidates ${CANDIDATES_${key}} NULL)
+        list(LENGTH candidates candidateCount)
+    endif()
+endforeach()
+
+set(LOGO_BUILTIN_INDEX_H "#pragma once\n\n// Generated by scripts/gen-logos.cmake. Do not edit\n\n")
+string(APPEND LOGO_BUILTIN_INDEX_H "static const uint16_t ffLogoBuiltinIndexDisplacements[] = {")
+append_values(LOGO_BUILTIN_INDEX_H ${displacements})
+string(APPEND LOGO_BUILTIN_INDEX_H "\n};\n\nstatic const uint16_t ffLogoBuiltinIndexSlots[] = {")
+append_values(LOGO_BUILTIN_INDEX_H ${slots})
+string(APPEND LOGO_BUILTIN_INDEX_H "\n};\n\nstatic const FFlogo* const ffLogoBuiltinIndexCandidates[] = {")
+append_values(LOGO_BUILTIN_INDEX_H ${candidates})
+string(APPEND LOGO_BUILTIN_INDEX_H "\n};\n\nconst FFLogoBuiltinIndex ffLogoBuiltinIndex = {
+    .seed = ${seed}u,
+    .bucketMask = ${bucketMask},
+    .slotMask = ${slotMask},
+    .displacements = ffLogoBuiltinIndexDisplacements,
+    .slots = ffLogoBuiltinIndexSlots,
+    .candidates = ffLogoBuiltinIndexCandidates,
+};\n")
+
+# Only touch the outputs if they changed, to avoid rebuilding builtin.c
+file(WRITE "${OUTPUT_DIR}/logo_builtin.h.tmp" "${LOGO_BUILTIN_H}")
+file(WRITE "${OUTPUT_DIR}/logo_builtin_index.h.tmp" "${LOGO_BUILTIN_INDEX_H}")
+foreach(output logo_builtin.h logo_builtin_index.h)
+    execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT_DIR}/${output}.tmp" "${OUTPUT_DIR}/${output}")
+    file(REMOVE "${OUTPUT_DIR}/${output}.tmp")
+endforeach()
@@ -13,7 +13,7 @@ class PciVendorModel:
         self.name = name
         self.devices = []
 
-def main(keep_vendor_list: set, pci_ids_path: str):
+def main(keep_vendor_list: set, pci_ids_path: str, output_path: str = None):
     vendors = []
     with open(pci_ids_path, 'r') as f:
         full_text = f.read()
@@ -58,6 +58,11 @@ typedef struct FFPciVendor
     if keep_vendor_list:
         vendors = [vendor for vendor in vendors if vendor.id in keep_vendor_list]
 
+    # Both vendors and devices are looked up with bsearch
+    vendors.sort(key=lambda vendor: vendor.id)
+    for vendor in vendors:
+        vendor.devices.sort(key=lambda device: device.id)
+
     for vendor in vendors:
         if vendor.devices:
             piece = ',\n    '.join('{{ 0x{:04X}, "{}" }}'.format(device.id, device.name.replace('"', '\\"')) for device in vendor.devices)
@@ -76,10 +81,14 @@ const FFPciVendor ffPciVendors[] = {{
     {{}},
 }};"""
 
-    print(code)
+    if output_path:
+        with open(output_path, 'w') as f:
+            f.write(code + '\n')
+    else:
+        print(code)
 
 if __name__ == '__main__':
-    len(sys.argv) == 2 or sys.exit('Usage: gen-pciids.py </path/to/pci.ids>')
+    len(sys.argv) in (2, 3) or sys.exit('Usage: gen-pciids.py </path/to/pci.ids> [</path/to/output.c.inc>]')
 
     # From <src/detection/gpu/gpu.c>
     main({
@@ -95,4 +104,4 @@ if __name__ == '__main__':
         0x1ab8, # Parallel
         0x1414, # Microsoft
         0x108e, # Oracle
-    }, sys.argv[1])
+    }, sys.argv[1], sys.argv[2] if len(sys.argv) == 3 else None)
@@ -21,6 +21,7 @@ typedef struct FFPlatform {
 
     uint32_t pid;
 #ifndef _WIN32
+    uint32_t ppid; // The process that launched fastfetch. Differs from `getppid()` for requests served by `--daemon`
     uint32_t uid;
 #else
     FFstrbuf sid;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "fastfetch.h"
+
+// Persistent detection result cache, stored in `<cacheDir>/fastfetch/results/<id>.bin`.
+// A cached result is only used if its invalidation key is identical to the key computed by the current run.
+// Payload is a sequence of typed fields, which must be read back in the order they were written.
+typedef struct FFCache {
+    FFstrbuf key;
+    FFstrbuf data;
+    uint32_t cursor; // Read position in `data`
+} FFCache;
+
+void ffCacheInit(FFCache* cache);
+void ffCacheDestroy(FFCache* cache);
+
+// Invalidation keys. Must be added before calling `ffCacheLoad` or `ffCacheStore`
+void ffCacheKeyAddBootId(FFCache* cache);
+void ffCacheKeyAddKernelRelease(FFCache* cache);
+void ffCacheKeyAddFile(FFCache* cache, const char* path); // mtime of the file, or 0 if it doesn't exist
+void ffCacheKeyAddS(FFCache* cache, const char* value);   // Anything else the result depends on, such as environment variables
+
+// `version`: layout of the payload. Must be increased whenever the fields written for `id` change.
+// Returns false if the cache is disabled, missing, outdated or stored with another version
+bool ffCacheLoad(FFCache* cache, const char* id, uint32_t version);
+bool ffCacheStore(FFCache* cache, const char* id, uint32_t version);
+
+void ffCachePutU32(FFCache* cache, uint32_t value);
+void ffCachePutDouble(FFCache* cache, double value);
+void ffCachePutStrbuf(FFCache* cache, const FFstrbuf* value);
+bool ffCacheGetU32(FFCache* cache, uint32_t* value);
+bool ffCacheGetDouble(FFCache* cache, double* value);
+bool ffCacheGetStrbuf(FFCache* cache, FFstrbuf* value);
+
+// Returns false if the file doesn't exist or isn't accessible
+bool ffCacheGetFileMtime(const char* path, uint64_t* mtimeMs);
+
+static inline void ffCachePutU16(FFCache* cache, uint16_t value) {
+    ffCachePutU32(cache, value);
+}
+
+static inline bool ffCacheGetU16(FFCache* cache, uint16_t* value) {
+    uint32_t result;
+    if (!ffCacheGetU32(cache, &result) || result > UINT16_MAX) {
+        return false;
+    }
+    *value = (uint16_t) result;
+    return true;
+}
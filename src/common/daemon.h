@@ -0,0 +1,13 @@
+#pragma once
+
+#include "fastfetch.h"
+
+// Serves invocations of `fastfetch --connect` over an AF_UNIX socket. `socketPath` can be NULL to use the default one.
+// Every request is handled in a forked child, which inherits the warm detection state of the daemon
+// and calls `handler` with the arguments, environment, working directory and stdio of the client.
+// Only returns on error
+const char* ffDaemonServe(const char* socketPath, int (*handler)(int argc, char** argv));
+
+// Forwards the invocation to a running daemon. Returns false if no daemon is listening;
+// otherwise exits with the exit code of the request
+bool ffDaemonConnect(const char* socketPath, int argc, char** argv);
@@ -9,6 +9,8 @@ typedef struct FFformatarg {
 } FFformatarg;
 
 void ffFormatAppendFormatArg(FFstrbuf* buffer, const FFformatarg* formatarg);
+// Format strings are compiled on first use and cached per `formatstr`
 bool ffParseFormatString(FFstrbuf* buffer, const FFstrbuf* formatstr, uint32_t numArgs, const FFformatarg* arguments);
+void ffFormatDestroyPrograms(void);
 #define FF_PARSE_FORMAT_STRING_CHECKED(buffer, formatstr, arguments) \
     ffParseFormatString((buffer), (formatstr), sizeof(arguments) / sizeof(*arguments), (arguments));
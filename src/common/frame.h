@@ -0,0 +1,16 @@
+#pragma once
+
+#include "fastfetch.h"
+#include "common/output.h"
+
+// Incremental redraw for --dynamic-interval.
+// Every frame is rendered off-screen, then only the lines that differ from the previous frame are written to stdout.
+// Output of modules whose result can't change is recorded in the first frame and replayed in later ones
+void ffFrameBegin(void);
+void ffFrameEnd(void);
+
+// Modules are numbered in the order they are printed in a frame.
+// Returns NULL if no frame is rendered, or if the module must be detected again
+const FFOutputCapture* ffFrameGetModuleOutput(uint32_t moduleIndex, bool* succeeded);
+void ffFrameSetModuleOutput(uint32_t moduleIndex, const FFOutputCapture* capture, bool succeeded);
+bool ffFrameIsRendering(void);
@@ -298,6 +298,7 @@ static void getCwd(FFPlatform* platform) {
 
 void ffPlatformInitImpl(FFPlatform* platform) {
     platform->pid = (uint32_t) getpid();
+    platform->ppid = (uint32_t) getppid();
     platform->uid = getuid();
     struct passwd* pwd = getpwuid(platform->uid);
 
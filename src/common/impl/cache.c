@@ -0,0 +1,186 @@
+#include "common/cache.h"
+#include "common/io.h"
+#include "common/time.h"
+#include "detection/uptime/uptime.h"
+
+#include <inttypes.h>
+
+#ifdef __APPLE__
+    #define st_mtim st_mtimespec
+#endif
+
+#define FF_CACHE_MAGIC "FFC2"
+
+void ffCacheInit(FFCache* cache) {
+    ffStrbufInit(&cache->key);
+    ffStrbufInit(&cache->data);
+    cache->cursor = 0;
+}
+
+void ffCacheDestroy(FFCache* cache) {
+    ffStrbufDestroy(&cache->key);
+    ffStrbufDestroy(&cache->data);
+}
+
+bool ffCacheGetFileMtime(const char* path, uint64_t* mtimeMs) {
+#ifndef _WIN32
+    struct stat st;
+    if (stat(path, &st) < 0) {
+        return false;
+    }
+
+    *mtimeMs = (uint64_t) st.st_mtim.tv_sec * 1000ull + (uint64_t) st.st_mtim.tv_nsec / 1000000ull;
+#else
+    FF_AUTO_CLOSE_FD HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    FILE_BASIC_INFORMATION fileInfo;
+    IO_STATUS_BLOCK iosb;
+    if (!NT_SUCCESS(NtQueryInformationFile(handle, &iosb, &fileInfo, sizeof(fileInfo), FileBasicInformation))) {
+        return false;
+    }
+
+    *mtimeMs = ffFileTimeToUnixMs((uint64_t) fileInfo.LastWriteTime.QuadPart);
+#endif
+    return true;
+}
+
+void ffCacheKeyAddBootId(FFCache* cache) {
+#ifdef __linux__
+    char bootId[64];
+    ssize_t len = ffReadFileData("/proc/sys/kernel/random/boot_id", ARRAY_SIZE(bootId), bootId);
+    if (len > 0) {
+        ffStrbufAppendNS(&cache->key, (uint32_t) len, bootId);
+        return;
+    }
+#endif
+
+    // Boot time is calculated from the current time and the uptime, it may differ slightly between runs
+    FFUptimeResult uptime = {};
+    ffDetectUptime(&uptime);
+    ffStrbufAppendF(&cache->key, "boot=%" PRIu64 "\n", uptime.bootTime / 10000);
+}
+
+void ffCacheKeyAddKernelRelease(FFCache* cache) {
+    ffStrbufAppendF(&cache->key, "release=%s\n", instance.state.platform.sysinfo.release.chars);
+}
+
+void ffCacheKeyAddFile(FFCache* cache, const char* path) {
+    uint64_t mtime = 0;
+    ffCacheGetFileMtime(path, &mtime);
+    ffStrbufAppendF(&cache->key, "%s=%" PRIu64 "\n", path, mtime);
+}
+
+void ffCacheKeyAddS(FFCache* cache, const char* value) {
+    ffStrbufAppendS(&cache->key, value ?: "");
+    ffStrbufAppendC(&cache->key, '\n');
+}
+
+static void getCachePath(FFstrbuf* path, const char* id) {
+    ffStrbufSet(path, &instance.state.platform.cacheDir);
+    ffStrbufEnsureEndsWithC(path, '/');
+    ffStrbufAppendF(path, "fastfetch/results/%s.bin", id);
+}
+
+bool ffCacheLoad(FFCache* cache, const char* id, uint32_t version) {
+    if (!instance.config.general.detectionCache) {
+        return false;
+    }
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getCachePath(&path, id);
+
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    if (!ffReadFileBuffer(path.chars, &content)) {
+        return false;
+    }
+
+    // FF_CACHE_MAGIC | u32 version | u32 keyLength | key | u32 dataLength | data
+    const uint32_t magicLength = (uint32_t) strlen(FF_CACHE_MAGIC);
+    uint32_t fileVersion, keyLength, dataLength;
+    if (content.length < magicLength + sizeof(fileVersion) + sizeof(keyLength) || memcmp(content.chars, FF_CACHE_MAGIC, magicLength) != 0) {
+        return false;
+    }
+    memcpy(&fileVersion, content.chars + magicLength, sizeof(fileVersion));
+    if (fileVersion != version) { // Stored with a different payload layout
+        return false;
+    }
+    memcpy(&keyLength, content.chars + magicLength + sizeof(fileVersion), sizeof(keyLength));
+
+    uint32_t offset = magicLength + (uint32_t) sizeof(fileVersion) + (uint32_t) sizeof(keyLength);
+    if (keyLength != cache->key.length || content.length - offset < keyLength + sizeof(dataLength) ||
+        memcmp(content.chars + offset, cache->key.chars, keyLength) != 0) {
+        return false;
+    }
+    offset += keyLength;
+    memcpy(&dataLength, content.chars + offset, sizeof(dataLength));
+    offset += (uint32_t) sizeof(dataLength);
+
+    if (content.length - offset != dataLength) { // Truncated or written concurrently
+        return false;
+    }
+
+    ffStrbufSetNS(&cache->data, dataLength, content.chars + offset);
+    cache->cursor = 0;
+    return true;
+}
+
+bool ffCacheStore(FFCache* cache, const char* id, uint32_t version) {
+    if (!instance.config.general.detectionCache) {
+        return false;
+    }
+
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreateA(cache->key.length + cache->data.length + 16);
+    ffStrbufAppendS(&content, FF_CACHE_MAGIC);
+    ffStrbufAppendNS(&content, sizeof(version), (const char*) &version);
+    ffStrbufAppendNS(&content, sizeof(cache->key.length), (const char*) &cache->key.length);
+    ffStrbufAppend(&content, &cache->key);
+    ffStrbufAppendNS(&content, sizeof(cache->data.length), (const char*) &cache->data.length);
+    ffStrbufAppend(&content, &cache->data);
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getCachePath(&path, id);
+    return ffWriteFileBuffer(path.chars, &content);
+}
+
+void ffCachePutU32(FFCache* cache, uint32_t value) {
+    ffStrbufAppendNS(&cache->data, sizeof(value), (const char*) &value);
+}
+
+void ffCachePutDouble(FFCache* cache, double value) {
+    ffStrbufAppendNS(&cache->data, sizeof(value), (const char*) &value);
+}
+
+void ffCachePutStrbuf(FFCache* cache, const FFstrbuf* value) {
+    ffCachePutU32(cache, value->length);
+    ffStrbufAppend(&cache->data, value);
+}
+
+static bool getBytes(FFCache* cache, uint32_t length, void* result) {
+    if (cache->data.length - cache->cursor < length) {
+        return false;
+    }
+    memcpy(result, cache->data.chars + cache->cursor, length);
+    cache->cursor += length;
+    return true;
+}
+
+bool ffCacheGetU32(FFCache* cache, uint32_t* value) {
+    return getBytes(cache, sizeof(*value), value);
+}
+
+bool ffCacheGetDouble(FFCache* cache, double* value) {
+    return getBytes(cache, sizeof(*value), value);
+}
+
+bool ffCacheGetStrbuf(FFCache* cache, FFstrbuf* value) {
+    uint32_t length;
+    if (!ffCacheGetU32(cache, &length) || cache->data.length - cache->cursor < length) {
+        return false;
+    }
+    ffStrbufSetNS(value, length, cache->data.chars + cache->cursor);
+    cache->cursor += length;
+    return true;
+}
@@ -1,6 +1,6 @@
 #include "common/commandoption.h"
-#include "common/color.h"
 #include "common/printing.h"
+#include "common/scheduler.h"
 #include "common/time.h"
 #include "common/jsonconfig.h"
 #include "common/stringUtils.h"
@@ -157,41 +157,70 @@ static void genJsonResult(FFdata* data, FFModuleBaseInfo* baseInfo, void* option
     }
 }
 
-static bool parseStructureCommand(
-    FFdata* data,
-    const char* line,
-    void (*fn)(FFdata*, FFModuleBaseInfo* baseInfo, void* options)) {
+static FFModuleBaseInfo* findModule(const char* line) {
     if (ffCharIsEnglishAlphabet(line[0])) {
         for (FFModuleBaseInfo** modules = ffModuleInfos[toupper(line[0]) - 'A']; *modules; ++modules) {
             FFModuleBaseInfo* baseInfo = *modules;
             if (ffStrEqualsIgnCase(line, baseInfo->name)) {
-                uint8_t optionBuf[FF_OPTION_MAX_SIZE];
-                baseInfo->initOptions(optionBuf);
-                if (data->resultDoc != NULL) {
-                    fn(data, baseInfo, optionBuf);
-                } else {
-                    baseInfo->printModule(optionBuf);
-                }
-                baseInfo->destroyOptions(optionBuf);
-                return true;
+                return baseInfo;
             }
         }
     }
+    return NULL;
+}
 
-    if (data->resultDoc) {
-        yyjson_mut_doc* doc = data->resultDoc;
-        yyjson_mut_val* module = yyjson_mut_arr_add_obj(doc, doc->root);
-        yyjson_mut_obj_add_str(doc, module, "type", line);
-        yyjson_mut_obj_add_str(doc, module, "error", "Unknown module type");
-    } else {
-        ffPrintError(line, 0, NULL, FF_PRINT_TYPE_NO_CUSTOM_KEY, "<no implementation provided>");
+static bool parseStructureCommand(
+    FFdata* data,
+    const char* line,
+    void (*fn)(FFdata*, FFModuleBaseInfo* baseInfo, void* options)) {
+    FFModuleBaseInfo* baseInfo = findModule(line);
+    if (baseInfo) {
+        uint8_t optionBuf[FF_OPTION_MAX_SIZE];
+        baseInfo->initOptions(optionBuf);
+        fn(data, baseInfo, optionBuf);
+        baseInfo->destroyOptions(optionBuf);
+        return true;
     }
+
+    yyjson_mut_doc* doc = data->resultDoc;
+    yyjson_mut_val* module = yyjson_mut_arr_add_obj(doc, doc->root);
+    yyjson_mut_obj_add_str(doc, module, "type", line);
+    yyjson_mut_obj_add_str(doc, module, "error", "Unknown module type");
     return false;
 }
 
+static void printStructure(FFdata* data) {
+    FFScheduler scheduler;
+    ffSchedulerInit(&scheduler);
+
+    char* moduleType = NULL;
+    size_t moduleLen = 0;
+    while (ffStrbufGetdelim(&moduleType, &moduleLen, ':', &data->structure)) {
+        if (ffStrbufSeparatedContainIgnCaseS(&data->structureDisabled, moduleType, ':')) {
+            continue;
+        }
+
+        FFModuleBaseInfo* baseInfo = findModule(moduleType);
+        if (baseInfo) {
+            ffSchedulerAdd(&scheduler, baseInfo, NULL);
+        } else {
+            // Keep the error in place
+            ffSchedulerRun(&scheduler);
+            ffPrintError(moduleType, 0, NULL, FF_PRINT_TYPE_NO_CUSTOM_KEY, "<no implementation provided>");
+        }
+    }
+
+    ffSchedulerDestroy(&scheduler);
+}
+
 void ffPrintCommandOption(FFdata* data) {
+    if (!data->resultDoc) {
+        printStructure(data);
+        return;
+    }
+
     // Parse the structure and call the modules
-    int32_t thres = instance.config.display.stat;
+    bool stat = instance.config.display.stat >= 0;
 
     char* moduleType = NULL;
     size_t moduleLen = 0;
@@ -201,35 +230,17 @@ void ffPrintCommandOption(FFdata* data) {
         }
 
         double ms = 0;
-        if (thres >= 0) {
+        if (stat) {
             ms = ffTimeGetTick();
         }
 
         parseStructureCommand(data, moduleType, genJsonResult);
 
-        if (thres >= 0) {
+        if (stat) {
             ms = ffTimeGetTick() - ms;
-
-            if (data->resultDoc) {
-                yyjson_mut_val* moduleJson = yyjson_mut_arr_get_last(data->resultDoc->root);
-                yyjson_mut_obj_add_real(data->resultDoc, moduleJson, "stat", ms);
-            } else {
-                char str[64];
-                int len = snprintf(str, sizeof str, "%.3fms", ms);
-                if (thres > 0) {
-                    snprintf(str, sizeof str, "\e[%sm%.3fms\e[m", (ms <= thres ? FF_COLOR_FG_GREEN : ms <= 2 * thres ? FF_COLOR_FG_YELLOW
-                                                                                                                     : FF_COLOR_FG_RED),
-                        ms);
-                }
-                printf("\e7\e[1A\e[9999999C\e[%dD%s\e8", len - 1, str); // Save; Up 1; Right 9999999; Left <len - 1>; Print <str>; Load
-            }
-        }
-
-#if defined(_WIN32)
-        if (!data->resultDoc && !instance.config.display.noBuffer) {
-            fflush(stdout);
+            yyjson_mut_val* moduleJson = yyjson_mut_arr_get_last(data->resultDoc->root);
+            yyjson_mut_obj_add_real(data->resultDoc, moduleJson, "stat", ms);
         }
-#endif
     }
 }
 
@@ -0,0 +1,477 @@
+#include "common/daemon.h"
+
+#ifdef _WIN32
+
+const char* ffDaemonServe(FF_A_UNUSED const char* socketPath, FF_A_UNUSED int (*handler)(int argc, char** argv)) {
+    return "Daemon mode is not supported on this platform";
+}
+
+bool ffDaemonConnect(FF_A_UNUSED const char* socketPath, FF_A_UNUSED int argc, FF_A_UNUSED char** argv) {
+    return false;
+}
+
+#else
+
+    #include "common/init.h"
+    #include "common/io.h"
+    #include "common/time.h"
+    #include "detection/cpuusage/cpuusage.h"
+    #include "detection/diskio/diskio.h"
+    #include "detection/netio/netio.h"
+    #include "detection/os/os.h"
+    #include "modules/modules.h"
+
+    #include <errno.h>
+    #include <poll.h>
+    #include <signal.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <sys/wait.h>
+
+extern char** environ;
+
+    #define FF_DAEMON_MAGIC 0x31444646u // "FFD1"
+    #define FF_DAEMON_SAMPLE_INTERVAL 1000 // ms
+    #define FF_DAEMON_MAX_PAYLOAD (1 << 20)
+
+typedef struct FFDaemonRequest {
+    uint32_t magic;
+    uint32_t ppid;
+    uint32_t argc;
+    uint32_t payloadLength; // cwd, argv and environ, each NUL terminated
+} FFDaemonRequest;
+
+typedef struct FFDaemonClient {
+    pid_t pid;
+    int fd;
+    bool killed;
+} FFDaemonClient;
+
+static void getSocketPath(FFstrbuf* path, const char* socketPath) {
+    if (socketPath) {
+        ffStrbufSetS(path, socketPath);
+        return;
+    }
+
+    const char* runtimeDir = getenv("XDG_RUNTIME_DIR");
+    if (runtimeDir && *runtimeDir) {
+        ffStrbufSetS(path, runtimeDir);
+        ffStrbufEnsureEndsWithC(path, '/');
+    } else {
+        ffStrbufSet(path, &instance.state.platform.cacheDir);
+        mkdir(path->chars, S_IRWXU);
+        ffStrbufAppendS(path, "fastfetch/");
+        mkdir(path->chars, S_IRWXU);
+    }
+    ffStrbufAppendS(path, "fastfetch.sock");
+}
+
+static int connectSocket(const FFstrbuf* path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (path->length >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    memcpy(addr.sun_path, path->chars, path->length + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= (size_t) written;
+    }
+    return true;
+}
+
+static bool readAll(int fd, char* data, size_t length) {
+    while (length > 0) {
+        ssize_t nRead = read(fd, data, length);
+        if (nRead <= 0) {
+            if (nRead < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += nRead;
+        length -= (size_t) nRead;
+    }
+    return true;
+}
+
+bool ffDaemonConnect(const char* socketPath, int argc, char** argv) {
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getSocketPath(&path, socketPath);
+
+    FF_AUTO_CLOSE_FD int fd = connectSocket(&path);
+    if (fd < 0) {
+        return false;
+    }
+
+    FF_STRBUF_AUTO_DESTROY payload = ffStrbufCreateA(4096);
+    ffStrbufAppend(&payload, &instance.state.platform.cwd);
+    ffStrbufAppendC(&payload, '\0');
+    for (int i = 0; i < argc; ++i) {
+        ffStrbufAppendS(&payload, argv[i]);
+        ffStrbufAppendC(&payload, '\0');
+    }
+    for (char** env = environ; *env; ++env) {
+        ffStrbufAppendS(&payload, *env);
+        ffStrbufAppendC(&payload, '\0');
+    }
+
+    FFDaemonRequest request = {
+        .magic = FF_DAEMON_MAGIC,
+        .ppid = (uint32_t) getppid(),
+        .argc = (uint32_t) argc,
+        .payloadLength = payload.length,
+    };
+
+    // Pass our stdio to the daemon, so that the output goes to our terminal directly
+    int stdFds[3] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+    char control[CMSG_SPACE(sizeof(stdFds))] = {};
+    struct iovec iov = { .iov_base = &request, .iov_len = sizeof(request) };
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control,
+        .msg_controllen = sizeof(control),
+    };
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(stdFds));
+    memcpy(CMSG_DATA(cmsg), stdFds, sizeof(stdFds));
+
+    if (sendmsg(fd, &msg, 0) != (ssize_t) sizeof(request) || !writeAll(fd, payload.chars, payload.length)) {
+        return false;
+    }
+
+    int32_t exitCode;
+    if (!readAll(fd, (char*) &exitCode, sizeof(exitCode))) {
+        fputs("Error: lost connection to fastfetch daemon\n", stderr);
+        exit(1);
+    }
+    exit(exitCode);
+}
+
+static int signalPipe[2] = { -1, -1 };
+
+static void sigchldHandler(FF_A_UNUSED int signal) {
+    int savedErrno = errno;
+    ssize_t FF_A_UNUSED written = write(signalPipe[1], "", 1);
+    errno = savedErrno;
+}
+
+static void setCloexec(int fd) {
+    fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+}
+
+static bool checkPeer(int fd) {
+    #if defined(SO_PEERCRED) && defined(__linux__)
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0 && cred.uid == (uid_t) instance.state.platform.uid;
+    #else
+    uid_t uid;
+    gid_t gid;
+    return getpeereid(fd, &uid, &gid) == 0 && uid == (uid_t) instance.state.platform.uid;
+    #endif
+}
+
+static bool receiveRequest(int fd, FFDaemonRequest* request, int stdFds[3], FFstrbuf* payload) {
+    char control[CMSG_SPACE(sizeof(int) * 3)] = {};
+    struct iovec iov = { .iov_base = request, .iov_len = sizeof(*request) };
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control,
+        .msg_controllen = sizeof(control),
+    };
+
+    if (recvmsg(fd, &msg, 0) != (ssize_t) sizeof(*request)) {
+        return false;
+    }
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(sizeof(int) * 3)) {
+        return false;
+    }
+    memcpy(stdFds, CMSG_DATA(cmsg), sizeof(int) * 3);
+
+    if (request->magic != FF_DAEMON_MAGIC || request->argc == 0 || request->payloadLength == 0 || request->payloadLength > FF_DAEMON_MAX_PAYLOAD) {
+        return false;
+    }
+
+    ffStrbufEnsureFixedLengthFree(payload, request->payloadLength);
+    if (!readAll(fd, payload->chars, request->payloadLength)) {
+        return false;
+    }
+    payload->length = request->payloadLength;
+    payload->chars[payload->length] = '\0';
+    return payload->chars[payload->length - 1] == '\0';
+}
+
+// Runs in the forked child
+static void runRequest(const FFDaemonRequest* request, const int stdFds[3], FFstrbuf* payload, int (*handler)(int argc, char** argv)) {
+    struct sigaction action = { .sa_handler = SIG_DFL };
+    sigaction(SIGCHLD, &action, NULL);
+    sigaction(SIGPIPE, &action, NULL);
+
+    for (int i = 0; i < 3; ++i) {
+        dup2(stdFds[i], i);
+        close(stdFds[i]);
+    }
+
+    char* p = payload->chars;
+    char* end = payload->chars + payload->length;
+    const char* cwd = p;
+    p += strlen(p) + 1;
+
+    FF_LIST_AUTO_DESTROY args = ffListCreate();
+    for (uint32_t i = 0; i < request->argc && p < end; ++i) {
+        *FF_LIST_ADD(char*, args) = p;
+        p += strlen(p) + 1;
+    }
+    uint32_t argc = args.length;
+    *FF_LIST_ADD(char*, args) = NULL;
+
+    FFlist env = ffListCreate(); // Must be kept alive until exit
+    while (p < end) {
+        *FF_LIST_ADD(char*, env) = p;
+        p += strlen(p) + 1;
+    }
+    *FF_LIST_ADD(char*, env) = NULL;
+    environ = (char**) env.data;
+
+    if (chdir(cwd) < 0) {
+        fprintf(stderr, "Error: failed to change directory to %s\n", cwd);
+        exit(1);
+    }
+
+    // Reinitialize everything that depends on the environment of the client
+    ffDestroyInstance();
+    ffInitInstance();
+    instance.state.platform.ppid = request->ppid;
+
+    exit(handler((int) argc, (char**) args.data));
+}
+
+static void sampleRateModules(FFCPUUsageOptions* cpuUsageOptions, FFDiskIOOptions* diskIOOptions, FFNetIOOptions* netIOOptions) {
+    FF_LIST_AUTO_DESTROY cpuUsage = ffListCreate();
+    ffGetCpuUsageResult(cpuUsageOptions, &cpuUsage, NULL);
+
+    FF_LIST_AUTO_DESTROY diskIO = ffListCreate();
+    ffDetectDiskIO(&diskIO, diskIOOptions);
+    FF_LIST_FOR_EACH (FFDiskIOResult, dev, diskIO) {
+        ffStrbufDestroy(&dev->name);
+        ffStrbufDestroy(&dev->devPath);
+    }
+
+    FF_LIST_AUTO_DESTROY netIO = ffListCreate();
+    ffDetectNetIO(&netIO, netIOOptions);
+    FF_LIST_FOR_EACH (FFNetIOResult, inf, netIO) {
+        ffStrbufDestroy(&inf->name);
+    }
+}
+
+const char* ffDaemonServe(const char* socketPath, int (*handler)(int argc, char** argv)) {
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getSocketPath(&path, socketPath);
+
+    int fd = connectSocket(&path);
+    if (fd >= 0) {
+        close(fd);
+        return "Another fastfetch daemon is already running";
+    }
+    unlink(path.chars);
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (path.length >= sizeof(addr.sun_path)) {
+        return "Socket path is too long";
+    }
+    memcpy(addr.sun_path, path.chars, path.length + 1);
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        return "socket() failed";
+    }
+    setCloexec(listenFd);
+
+    mode_t oldMask = umask(077);
+    int ret = bind(listenFd, (struct sockaddr*) &addr, sizeof(addr));
+    umask(oldMask);
+    if (ret < 0) {
+        close(listenFd);
+        return "bind() failed";
+    }
+    if (listen(listenFd, 16) < 0) {
+        close(listenFd);
+        return "listen() failed";
+    }
+
+    if (pipe(signalPipe) < 0) {
+        close(listenFd);
+        return "pipe() failed";
+    }
+    setCloexec(signalPipe[0]);
+    setCloexec(signalPipe[1]);
+    fcntl(signalPipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(signalPipe[1], F_SETFL, O_NONBLOCK);
+
+    struct sigaction action = { .sa_handler = sigchldHandler };
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGCHLD, &action, NULL);
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &action, NULL);
+
+    fprintf(stderr, "fastfetch daemon listening on %s\n", path.chars);
+
+    // Warm up detection state that doesn't depend on the client
+    ffDetectOS();
+
+    FFCPUUsageOptions cpuUsageOptions;
+    ffInitCPUUsageOptions(&cpuUsageOptions);
+    cpuUsageOptions.waitTime = 0;
+    FFDiskIOOptions diskIOOptions;
+    ffInitDiskIOOptions(&diskIOOptions);
+    diskIOOptions.waitTime = 1; // At least 1 ms between samples
+    FFNetIOOptions netIOOptions;
+    ffInitNetIOOptions(&netIOOptions);
+    netIOOptions.waitTime = 1;
+
+    ffPrepareCPUUsage();
+    ffPrepareDiskIO(&diskIOOptions);
+    ffPrepareNetIO(&netIOOptions);
+    uint64_t lastSample = ffTimeGetNow();
+
+    FF_LIST_AUTO_DESTROY clients = ffListCreate(); // FFDaemonClient
+    FF_LIST_AUTO_DESTROY pollFds = ffListCreate(); // struct pollfd
+    FF_STRBUF_AUTO_DESTROY payload = ffStrbufCreate();
+
+    while (true) {
+        ffListClear(&pollFds);
+        *FF_LIST_ADD(struct pollfd, pollFds) = (struct pollfd) { .fd = listenFd, .events = POLLIN };
+        *FF_LIST_ADD(struct pollfd, pollFds) = (struct pollfd) { .fd = signalPipe[0], .events = POLLIN };
+        FF_LIST_FOR_EACH (FFDaemonClient, client, clients) {
+            // Clients never send anything after the request. Readable means disconnected
+            *FF_LIST_ADD(struct pollfd, pollFds) = (struct pollfd) { .fd = client->killed ? -1 : client->fd, .events = POLLIN };
+        }
+
+        uint64_t elapsed = ffTimeGetNow() - lastSample;
+        int timeout = elapsed >= FF_DAEMON_SAMPLE_INTERVAL ? 0 : (int) (FF_DAEMON_SAMPLE_INTERVAL - elapsed);
+        if (poll((struct pollfd*) pollFds.data, pollFds.length, timeout) < 0 && errno != EINTR) {
+            return "poll() failed";
+        }
+
+        if (ffTimeGetNow() - lastSample >= FF_DAEMON_SAMPLE_INTERVAL) {
+            sampleRateModules(&cpuUsageOptions, &diskIOOptions, &netIOOptions);
+            lastSample = ffTimeGetNow();
+        }
+
+        struct pollfd* fds = (struct pollfd*) pollFds.data;
+
+        for (uint32_t i = 0; i < clients.length; ++i) {
+            FFDaemonClient* client = FF_LIST_GET(FFDaemonClient, clients, i);
+            if (!client->killed && fds[i + 2].revents) {
+                // The client was interrupted. Don't keep its request running, e.g. with `--dynamic-interval`
+                kill(client->pid, SIGTERM);
+                client->killed = true;
+            }
+        }
+
+        if (fds[1].revents & POLLIN) {
+            char buf[64];
+            while (read(signalPipe[0], buf, sizeof(buf)) > 0) {
+            }
+
+            int status;
+            pid_t pid;
+            while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+                for (uint32_t i = 0; i < clients.length; ++i) {
+                    FFDaemonClient* client = FF_LIST_GET(FFDaemonClient, clients, i);
+                    if (client->pid != pid) {
+                        continue;
+                    }
+
+                    int32_t exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+                    writeAll(client->fd, (const char*) &exitCode, sizeof(exitCode));
+                    close(client->fd);
+                    memmove(client, client + 1, (clients.length - i - 1) * sizeof(*client));
+                    --clients.length;
+                    break;
+                }
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int conn = accept(listenFd, NULL, NULL);
+            if (conn < 0) {
+                continue;
+            }
+            setCloexec(conn);
+
+            // Don't let a stuck client block the daemon
+            struct timeval tv = { .tv_sec = 1 };
+            setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+            FFDaemonRequest request;
+            int stdFds[3] = { -1, -1, -1 };
+            if (!checkPeer(conn) || !receiveRequest(conn, &request, stdFds, &payload)) {
+                for (int i = 0; i < 3; ++i) {
+                    if (stdFds[i] >= 0) {
+                        close(stdFds[i]);
+                    }
+                }
+                close(conn);
+                continue;
+            }
+
+            pid_t pid = fork();
+            if (pid == 0) {
+                close(listenFd);
+                close(signalPipe[0]);
+                close(signalPipe[1]);
+                close(conn);
+                FF_LIST_FOR_EACH (FFDaemonClient, client, clients) {
+                    close(client->fd);
+                }
+                runRequest(&request, stdFds, &payload, handler); // Never returns
+            }
+
+            for (int i = 0; i < 3; ++i) {
+                close(stdFds[i]);
+            }
+
+            if (pid < 0) {
+                int32_t exitCode = 1;
+                writeAll(conn, (const char*) &exitCode, sizeof(exitCode));
+                close(conn);
+                continue;
+            }
+
+            *FF_LIST_ADD(FFDaemonClient, clients) = (FFDaemonClient) {
+                .pid = pid,
+                .fd = conn,
+                .killed = false,
+            };
+        }
+    }
+}
+
+#endif
@@ -4,6 +4,7 @@
 
     #include "common/thread.h"
     #include "common/stringUtils.h"
+    #include "common/trace.h"
 
 static bool loadLibSymbols(FFDBusLibrary* lib) {
     FF_LIBRARY_LOAD(dbus, false, "libdbus-1" FF_LIBRARY_EXTENSION, 4);
@@ -27,16 +28,20 @@ static const FFDBusLibrary* loadLib(void) {
     static FFDBusLibrary lib;
     static bool loaded = false;
     static bool loadSuccess = false;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
 
     if (!loaded) {
         loaded = true;
         loadSuccess = loadLibSymbols(&lib);
     }
 
+    ffThreadMutexUnlock(&mutex);
     return loadSuccess ? &lib : NULL;
 }
 
 const char* ffDBusLoadData(DBusBusType busType, FFDBusData* data) {
+    FF_TRACE_SCOPE("dbus", "connect", busType == DBUS_BUS_SYSTEM ? "system" : "session");
     data->lib = loadLib();
     if (data->lib == NULL) {
         return "Failed to load DBus library";
@@ -253,6 +258,7 @@ bool ffDBusGetInt(FFDBusData* dbus, DBusMessageIter* iter, int64_t* result) {
 }
 
 DBusMessage* ffDBusGetMethodReply(FFDBusData* dbus, const char* busName, const char* objectPath, const char* interface, const char* method, const char* arg1, const char* arg2) {
+    FF_TRACE_SCOPE("dbus", "call", method);
     DBusMessage* message = dbus->lib->ffdbus_message_new_method_call(busName, objectPath, interface, method);
     if (message == NULL) {
         return NULL;
@@ -274,6 +280,7 @@ DBusMessage* ffDBusGetMethodReply(FFDBusData* dbus, const char* busName, const c
 }
 
 DBusMessage* ffDBusGetProperty(FFDBusData* dbus, const char* busName, const char* objectPath, const char* interface, const char* property) {
+    FF_TRACE_SCOPE("dbus", "get", property);
     DBusMessage* message = dbus->lib->ffdbus_message_new_method_call(busName, objectPath, "org.freedesktop.DBus.Properties", "Get");
     if (message == NULL) {
         return NULL;
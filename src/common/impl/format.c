@@ -4,6 +4,7 @@
 #include "common/textModifier.h"
 #include "common/stringUtils.h"
 #include "common/library.h"
+#include "common/thread.h"
 
 #include <inttypes.h>
 
@@ -99,15 +100,6 @@ static uint32_t getArgumentIndex(const char* placeholderValue, uint32_t numArgs,
     return UINT32_MAX;
 }
 
-static inline void appendInvalidPlaceholder(FFstrbuf* buffer, const char* start, const FFstrbuf* placeholderValue, uint32_t index, uint32_t formatStringLength) {
-    ffStrbufAppendS(buffer, start);
-    ffStrbufAppend(buffer, placeholderValue);
-
-    if (index < formatStringLength) {
-        ffStrbufAppendC(buffer, '}');
-    }
-}
-
 static inline bool formatArgSet(const FFformatarg* arg) {
     return arg->value != NULL && ((arg->type == FF_ARG_TYPE_DOUBLE && *(double*) arg->value > 0.0) || (arg->type == FF_ARG_TYPE_FLOAT && *(float*) arg->value > 0.0) || (arg->type == FF_ARG_TYPE_INT && *(int32_t*) arg->value > 0) || (arg->type == FF_ARG_TYPE_STRBUF && ((FFstrbuf*) arg->value)->length > 0) || (arg->type == FF_ARG_TYPE_STRING && ffStrSet((char*) arg->value)) || (arg->type == FF_ARG_TYPE_UINT8 && *(uint8_t*) arg->value > 0) || (arg->type == FF_ARG_TYPE_UINT16 && *(uint16_t*) arg->value > 0) || (arg->type == FF_ARG_TYPE_UINT && *(uint32_t*) arg->value > 0) || (arg->type == FF_ARG_TYPE_UINT64 && *(uint64_t*) arg->value > 0) || (arg->type == FF_ARG_TYPE_BOOL && *(bool*) arg->value) || (arg->type == FF_ARG_TYPE_LIST && ((FFlist*) arg->value)->length > 0));
 }
@@ -532,36 +524,140 @@ static bool parseQuickJSString(FFstrbuf* buffer, const char* script, uint32_t sc
 }
 #endif
 
-static bool parseFormatString(FFstrbuf* buffer, const FFstrbuf* formatstr, uint32_t numArgs, const FFformatarg* arguments) {
-    uint32_t argCounter = 0;
+// Format strings are compiled once into a list of ops, which is executed for every print.
+// Literal spans, placeholder parameters and jump targets of conditionals are resolved when compiling;
+// argument names are looked up when executing, because they depend on the arguments passed
+typedef enum FF_A_PACKED FFformatOpType {
+    FF_FORMAT_OP_LITERAL,     // text
+    FF_FORMAT_OP_STOP,        // {-}
+    FF_FORMAT_OP_END_IF,      // {?}
+    FF_FORMAT_OP_END_NOT_IF,  // {/}
+    FF_FORMAT_OP_COLOR,       // {#} or {#color}, text is the escape sequence
+    FF_FORMAT_OP_IF,          // {?arg}
+    FF_FORMAT_OP_NOT_IF,      // {/arg}
+    FF_FORMAT_OP_CONSTANT,    // {$N}
+    FF_FORMAT_OP_ENV,         // {$NAME}
+    FF_FORMAT_OP_ARG,         // {arg}, {arg:N}, {arg<N}, {arg>N} or {arg~start,end}
+    FF_FORMAT_OP_INVALID_ARG, // {arg} with invalid parameters, still advances the argument counter
+} FFformatOpType;
+
+typedef enum FF_A_PACKED FFformatRefType {
+    FF_FORMAT_REF_INVALID,
+    FF_FORMAT_REF_AUTO,  // use arg counter
+    FF_FORMAT_REF_INDEX, // 1-based index
+    FF_FORMAT_REF_NAME,  // name is stored in strings
+} FFformatRefType;
+
+typedef struct FFformatOp {
+    FFformatOpType type;
+    FFformatRefType refType;
+    char sep;           // '\0', ':', '<', '>' or '~'
+    bool flag;          // ellipsis for truncation and padding; end index given for substrings; valid index for constants
+    uint32_t ref;       // argument index, or offset of the argument or env var name
+    uint32_t hint;      // index of the argument the name matched when compiling
+    int32_t param1;     // truncation length, substring start or constant index
+    int32_t param2;     // substring end
+    uint32_t jump;      // op to continue with if the condition is not met
+    uint32_t srcOffset; // start of the op in the format string
+    uint32_t textOffset;
+    uint32_t textLength; // literal text, or the placeholder itself to print if it turns out to be invalid
+} FFformatOp;
+
+typedef struct FFformatProgram {
+    FFstrbuf source;
+    FFstrbuf strings;
+    FFlist ops; // List of FFformatOp
+} FFformatProgram;
+
+static FFThreadMutex programsMutex = FF_THREAD_MUTEX_INITIALIZER;
+static FFlist programs; // List of FFformatProgram*, one per distinct format string. Never modified once compiled
+
+static uint32_t addString(FFformatProgram* program, uint32_t length, const char* str) {
+    uint32_t offset = program->strings.length;
+    ffStrbufAppendNS(&program->strings, length, str);
+    ffStrbufAppendC(&program->strings, '\0');
+    return offset;
+}
 
-    uint32_t numOpenIfs = 0;
-    uint32_t numOpenNotIfs = 0;
+static FFformatOp* addOp(FFformatProgram* program, FFformatOpType type, uint32_t srcStart, uint32_t srcEnd) {
+    FFformatOp* op = FF_LIST_ADD(FFformatOp, program->ops);
+    *op = (FFformatOp) {
+        .type = type,
+        .srcOffset = srcStart,
+        .textLength = srcEnd - srcStart,
+    };
+    op->textOffset = addString(program, op->textLength, program->source.chars + srcStart);
+    return op;
+}
+
+static void addLiteral(FFformatProgram* program, uint32_t* literalOffset, uint32_t* literalStart, uint32_t nextStart) {
+    if (program->strings.length > *literalOffset) {
+        FFformatOp* op = FF_LIST_ADD(FFformatOp, program->ops);
+        *op = (FFformatOp) {
+            .type = FF_FORMAT_OP_LITERAL,
+            .srcOffset = *literalStart,
+            .textOffset = *literalOffset,
+            .textLength = program->strings.length - *literalOffset,
+        };
+    }
+    *literalOffset = program->strings.length;
+    *literalStart = nextStart;
+}
+
+// Same rules as `getArgumentIndex`, except that names are looked up when executing
+static void compileArgRef(FFformatProgram* program, FFformatOp* op, uint32_t length, const char* value, uint32_t numArgs, const FFformatarg* arguments) {
+    char firstChar = length > 0 ? value[0] : '\0';
+    if (firstChar == '\0') {
+        op->refType = FF_FORMAT_REF_AUTO;
+    } else if (firstChar >= '0' && firstChar <= '9') {
+        char* pEnd = NULL;
+        op->ref = (uint32_t) strtoul(value, &pEnd, 10);
+        op->refType = pEnd == value + length ? FF_FORMAT_REF_INDEX : FF_FORMAT_REF_INVALID;
+    } else if (ffCharIsEnglishAlphabet(firstChar)) {
+        op->refType = FF_FORMAT_REF_NAME;
+        op->ref = addString(program, length, value);
+        op->hint = getArgumentIndex(program->strings.chars + op->ref, numArgs, arguments);
+    } else {
+        op->refType = FF_FORMAT_REF_INVALID;
+    }
+}
+
+static void compileFormatString(FFformatProgram* program, uint32_t numArgs, const FFformatarg* arguments) {
+    const FFstrbuf* formatstr = &program->source;
 
     FF_STRBUF_AUTO_DESTROY placeholderValue = ffStrbufCreate();
 
+    uint32_t literalOffset = 0;
+    uint32_t literalStart = 0;
+
     for (uint32_t i = 0; i < formatstr->length; ++i) {
-        // if we don't have a placeholder start just copy the chars over to output buffer
+        // Skipping a conditional continues right after the next "{?}" or "{/}", so an op must start there
+        if (i >= 3 && formatstr->chars[i - 1] == '}' && (formatstr->chars[i - 2] == '?' || formatstr->chars[i - 2] == '/') && formatstr->chars[i - 3] == '{') {
+            addLiteral(program, &literalOffset, &literalStart, i);
+        }
+
+        // if we don't have a placeholder start just copy the chars over to the literal
         if (formatstr->chars[i] != '{') {
-            ffStrbufAppendC(buffer, formatstr->chars[i]);
+            ffStrbufAppendC(&program->strings, formatstr->chars[i]);
             continue;
         }
 
-        // jump to next char, the start of the placeholder value
-        ++i;
+        uint32_t placeholderStart = i++;
 
         // unmatched trailing '{'
         if (i >= formatstr->length) {
-            ffStrbufAppendC(buffer, '{');
+            ffStrbufAppendC(&program->strings, '{');
             break;
         }
 
         // double {{ elvaluates to a single { and doesn't count as start
         if (formatstr->chars[i] == '{') {
-            ffStrbufAppendC(buffer, '{');
+            ffStrbufAppendC(&program->strings, '{');
             continue;
         }
 
+        addLiteral(program, &literalOffset, &literalStart, placeholderStart);
+
         ffStrbufClear(&placeholderValue);
 
         {
@@ -570,231 +666,311 @@ static bool parseFormatString(FFstrbuf* buffer, const FFstrbuf* formatstr, uint3
             i = iEnd;
         }
 
+        uint32_t placeholderEnd = i < formatstr->length ? i + 1 : i;
         char firstChar = placeholderValue.chars[0];
 
-        if (placeholderValue.length == 1) {
-            // test if for stop, if so break the loop
-            if (firstChar == '-') {
-                break;
+        if (placeholderValue.length == 1 && (firstChar == '-' || firstChar == '?' || firstChar == '/' || firstChar == '#')) {
+            FFformatOp* op = addOp(program,
+                firstChar == '-' ? FF_FORMAT_OP_STOP : firstChar == '?' ? FF_FORMAT_OP_END_IF : firstChar == '/' ? FF_FORMAT_OP_END_NOT_IF : FF_FORMAT_OP_COLOR,
+                placeholderStart,
+                placeholderEnd);
+            if (firstChar == '#') {
+                op->textLength = (uint32_t) strlen(FASTFETCH_TEXT_MODIFIER_RESET);
+                op->textOffset = addString(program, op->textLength, FASTFETCH_TEXT_MODIFIER_RESET);
+            }
+        } else if (firstChar == '?' || firstChar == '/') {
+            FFformatOp* op = addOp(program, firstChar == '?' ? FF_FORMAT_OP_IF : FF_FORMAT_OP_NOT_IF, placeholderStart, placeholderEnd);
+            compileArgRef(program, op, placeholderValue.length - 1, placeholderValue.chars + 1, numArgs, arguments);
+
+            // Source position for now, resolved to an op index when the whole string is compiled
+            op->jump = ffStrbufNextIndexS(formatstr, i, firstChar == '?' ? "{?}" : "{/}") + 3;
+        } else if (firstChar == '#') {
+            FF_STRBUF_AUTO_DESTROY color = ffStrbufCreateS("\e[");
+            ffOptionParseColorNoClear(placeholderValue.chars + 1, &color);
+            ffStrbufAppendC(&color, 'm');
+
+            FFformatOp* op = addOp(program, FF_FORMAT_OP_COLOR, placeholderStart, placeholderEnd);
+            op->textLength = color.length;
+            op->textOffset = addString(program, color.length, color.chars);
+        } else if (firstChar == '$') {
+            char* pend = NULL;
+            int32_t indexSigned = (int32_t) strtol(placeholderValue.chars + 1, &pend, 10);
+            if (pend == placeholderValue.chars + 1) {
+                FFformatOp* op = addOp(program, FF_FORMAT_OP_ENV, placeholderStart, placeholderEnd);
+                op->ref = addString(program, placeholderValue.length - 1, placeholderValue.chars + 1);
+            } else {
+                FFformatOp* op = addOp(program, FF_FORMAT_OP_CONSTANT, placeholderStart, placeholderEnd);
+                op->param1 = indexSigned;
+                op->flag = *pend == '\0';
+            }
+        } else {
+            char* pSep = placeholderValue.chars;
+            while (*pSep && *pSep != ':' && *pSep != '<' && *pSep != '>' && *pSep != '~') {
+                ++pSep;
             }
 
-            // test for end of an if, if so do nothing
-            if (firstChar == '?') {
-                if (numOpenIfs == 0) {
-                    appendInvalidPlaceholder(buffer, "{", &placeholderValue, i, formatstr->length);
-                } else {
-                    --numOpenIfs;
-                }
+            FFformatOp* op = addOp(program, FF_FORMAT_OP_ARG, placeholderStart, placeholderEnd);
+            op->sep = *pSep;
 
-                continue;
+            if (op->sep == '~') {
+                char* pEnd = NULL;
+                op->param1 = (int32_t) strtol(pSep + 1, &pEnd, 10);
+                if (*pEnd == ',') {
+                    op->flag = true;
+                    op->param2 = (int32_t) strtol(pEnd + 1, &pEnd, 10);
+                }
+                if (*pEnd) {
+                    op->type = FF_FORMAT_OP_INVALID_ARG;
+                }
+            } else if (op->sep) {
+                char* pEnd = NULL;
+                op->param1 = (int32_t) strtol(pSep + 1, &pEnd, 10);
+                if (*pEnd) {
+                    op->type = FF_FORMAT_OP_INVALID_ARG;
+                }
+                if (op->param1 < 0) {
+                    op->flag = true;
+                    op->param1 = -op->param1;
+                }
             }
 
-            // test for end of a not if, if so do nothing
-            if (firstChar == '/') {
-                if (numOpenNotIfs == 0) {
-                    appendInvalidPlaceholder(buffer, "{", &placeholderValue, i, formatstr->length);
-                } else {
-                    --numOpenNotIfs;
-                }
+            compileArgRef(program, op, (uint32_t) (pSep - placeholderValue.chars), placeholderValue.chars, numArgs, arguments);
+        }
 
-                continue;
-            }
+        literalOffset = program->strings.length;
+        literalStart = placeholderEnd;
+    }
 
-            // test for end of a color, if so do nothing
-            if (firstChar == '#') {
-                if (!instance.config.display.pipe) {
-                    ffStrbufAppendS(buffer, FASTFETCH_TEXT_MODIFIER_RESET);
-                }
+    addLiteral(program, &literalOffset, &literalStart, formatstr->length);
 
-                continue;
+    FF_LIST_FOR_EACH (FFformatOp, op, program->ops) {
+        if (op->type != FF_FORMAT_OP_IF && op->type != FF_FORMAT_OP_NOT_IF) {
+            continue;
+        }
+
+        uint32_t target = op->jump;
+        op->jump = program->ops.length;
+        for (uint32_t i = 0; i < program->ops.length; ++i) {
+            if (FF_LIST_GET(FFformatOp, program->ops, i)->srcOffset >= target) {
+                op->jump = i;
+                break;
             }
         }
+    }
+}
 
-        // test for if, if so evaluate it
-        if (firstChar == '?') {
-            ffStrbufSubstrAfter(&placeholderValue, 0);
+static const FFformatProgram* getFormatProgram(const FFstrbuf* formatstr, uint32_t numArgs, const FFformatarg* arguments) {
+    ffThreadMutexLock(&programsMutex);
 
-            uint32_t index = getArgumentIndex(placeholderValue.chars, numArgs, arguments);
+    // Keyed by content, so that identical format strings of different modules and frames share one program.
+    // Name hints are verified when the program runs, so they don't depend on the arguments of the first caller
+    FF_LIST_FOR_EACH (FFformatProgram*, item, programs) {
+        if (ffStrbufEqual(&(*item)->source, formatstr)) {
+            ffThreadMutexUnlock(&programsMutex);
+            return *item;
+        }
+    }
 
-            // testing for an invalid index
-            if (index > numArgs || index < 1) {
-                appendInvalidPlaceholder(buffer, "{?", &placeholderValue, i, formatstr->length);
-                continue;
-            }
+    FFformatProgram* program = malloc(sizeof(*program));
+    ffStrbufInitCopy(&program->source, formatstr);
+    ffStrbufInit(&program->strings);
+    ffListInit(&program->ops);
+    compileFormatString(program, numArgs, arguments);
+    *FF_LIST_ADD(FFformatProgram*, programs) = program;
 
-            // continue normally if an format arg is set and the value is > 0
-            if (formatArgSet(&arguments[index - 1])) {
-                ++numOpenIfs;
-                continue;
-            }
+    ffThreadMutexUnlock(&programsMutex);
+    return program;
+}
 
-            // fastforward to the end of the if without printing the in between
-            i = ffStrbufNextIndexS(formatstr, i, "{?}") + 2; // 2 is the length of "{?}" - 1 because the loop will increment it again directly after continue
-            continue;
+void ffFormatDestroyPrograms(void) {
+    FF_LIST_FOR_EACH (FFformatProgram*, item, programs) {
+        ffStrbufDestroy(&(*item)->source);
+        ffStrbufDestroy(&(*item)->strings);
+        ffListDestroy(&(*item)->ops);
+        free(*item);
+    }
+    ffListDestroy(&programs);
+}
+
+static uint32_t resolveArgRef(const FFformatProgram* program, const FFformatOp* op, uint32_t numArgs, const FFformatarg* arguments) {
+    switch (op->refType) {
+        case FF_FORMAT_REF_AUTO:
+            return 0;
+        case FF_FORMAT_REF_INDEX:
+            return op->ref > numArgs ? UINT32_MAX : op->ref;
+        case FF_FORMAT_REF_NAME: {
+            const char* name = program->strings.chars + op->ref;
+            if (op->hint >= 1 && op->hint <= numArgs && arguments[op->hint - 1].name && ffStrEqualsIgnCase(name, arguments[op->hint - 1].name)) {
+                return op->hint;
+            }
+            return getArgumentIndex(name, numArgs, arguments);
         }
+        default:
+            return UINT32_MAX;
+    }
+}
 
-        // test for not if, if so evaluate it
-        if (firstChar == '/') {
-            ffStrbufSubstrAfter(&placeholderValue, 0);
+// Appends the argument to `buffer` and applies truncation, padding or substring in place, to avoid temporary strings
+static void appendArg(FFstrbuf* buffer, const FFformatOp* op, const FFformatarg* arg, const char* placeholder) {
+    uint32_t start = buffer->length;
+    ffFormatAppendFormatArg(buffer, arg);
 
-            uint32_t index = getArgumentIndex(placeholderValue.chars, numArgs, arguments);
+    if (!op->sep) {
+        return;
+    }
 
-            // testing for an invalid index
-            if (index > numArgs || index < 1) {
-                appendInvalidPlaceholder(buffer, "{/", &placeholderValue, i, formatstr->length);
-                continue;
-            }
+    uint32_t length = buffer->length - start;
 
-            // continue normally if an format arg is not set or the value is 0
-            if (!formatArgSet(&arguments[index - 1])) {
-                ++numOpenNotIfs;
-                continue;
+    if (op->sep == '~') {
+        int32_t begin = op->param1;
+        if (begin < 0) {
+            begin = (int32_t) length + begin;
+        }
+        if (begin < 0 || (uint32_t) begin >= length) {
+            ffStrbufSubstrBefore(buffer, start);
+            if (op->flag) {
+                ffStrbufAppendNS(buffer, op->textLength, placeholder);
             }
-
-            // fastforward to the end of the if without printing the in between
-            i = ffStrbufNextIndexS(formatstr, i, "{/}") + 2; // 2 is the length of "{/}" - 1 because the loop will increment it again directly after continue
-            continue;
+            return;
         }
 
-        // test for color, if so evaluate it
-        if (firstChar == '#') {
-            if (!instance.config.display.pipe) {
-                ffStrbufAppendS(buffer, "\e[");
-                ffOptionParseColorNoClear(placeholderValue.chars + 1, buffer);
-                ffStrbufAppendC(buffer, 'm');
+        int32_t end = (int32_t) length;
+        if (op->flag) {
+            end = op->param2;
+            if (end < 0) {
+                end = (int32_t) length + end;
+            }
+            if ((uint32_t) end > length) {
+                end = (int32_t) length;
+            }
+            if (end < begin) {
+                end = begin;
             }
-            continue;
         }
 
-        // test for constant or env var, if so evaluate it
-        if (firstChar == '$') {
-            char* pend = NULL;
-            int32_t indexSigned = (int32_t) strtol(placeholderValue.chars + 1, &pend, 10);
-            if (pend == placeholderValue.chars + 1) {
-                // treat placeholder as an environment variable
-                char* envValue = getenv(placeholderValue.chars + 1);
-                if (envValue) {
-                    ffStrbufAppendS(buffer, envValue);
-                } else {
-                    appendInvalidPlaceholder(buffer, "{", &placeholderValue, i, formatstr->length);
-                }
-            } else {
-                // treat placeholder as a constant
-                uint32_t index = (uint32_t) (indexSigned < 0 ? (int32_t) instance.config.display.constants.length + indexSigned : indexSigned - 1);
+        memmove(buffer->chars + start, buffer->chars + start + begin, (size_t) (end - begin));
+        ffStrbufSubstrBefore(buffer, start + (uint32_t) (end - begin));
+        return;
+    }
 
-                if (*pend != '\0' || instance.config.display.constants.length <= index) {
-                    appendInvalidPlaceholder(buffer, "{", &placeholderValue, i, formatstr->length);
-                } else {
-                    FFstrbuf* item = FF_LIST_GET(FFstrbuf, instance.config.display.constants, index);
-                    ffStrbufAppend(buffer, item);
-                }
+    uint32_t truncLength = (uint32_t) op->param1;
+    bool ellipsis = op->flag;
+
+    if (length > truncLength) {
+        uint32_t newLength = truncLength;
+        if (op->sep == ':') {
+            while (newLength > 0 && isspace((unsigned char) buffer->chars[start + newLength - 1])) {
+                --newLength;
             }
-            continue;
+        } else if (ellipsis) {
+            --newLength;
         }
+        ffStrbufSubstrBefore(buffer, start + newLength);
 
-        char* pSep = placeholderValue.chars;
-        char cSep = '\0';
-        while (*pSep && *pSep != ':' && *pSep != '<' && *pSep != '>' && *pSep != '~') {
-            ++pSep;
+        if (ellipsis) {
+            ffStrbufAppendS(buffer, "…");
         }
-        if (*pSep) {
-            cSep = *pSep;
-            *pSep = '\0';
-        } else {
-            pSep = NULL;
+    } else if (length < truncLength) {
+        if (op->sep == '<') {
+            ffStrbufAppendNC(buffer, truncLength - length, ' ');
+        } else if (op->sep == '>') {
+            ffStrbufInsertNC(buffer, start, truncLength - length, ' ');
         }
+    }
+}
 
-        uint32_t index = getArgumentIndex(placeholderValue.chars, numArgs, arguments);
+static bool parseFormatString(FFstrbuf* buffer, const FFstrbuf* formatstr, uint32_t numArgs, const FFformatarg* arguments) {
+    const FFformatProgram* program = getFormatProgram(formatstr, numArgs, arguments);
 
-        // test for invalid index
-        if (index == 0) {
-            index = ++argCounter;
-        }
+    uint32_t argCounter = 0;
 
-        if (index > numArgs) {
-            if (pSep) {
-                *pSep = cSep;
-            }
-            appendInvalidPlaceholder(buffer, "{", &placeholderValue, i, formatstr->length);
-            continue;
-        }
+    uint32_t numOpenIfs = 0;
+    uint32_t numOpenNotIfs = 0;
 
-        if (!cSep) {
-            ffFormatAppendFormatArg(buffer, &arguments[index - 1]);
-        } else if (cSep == '~') {
-            FF_STRBUF_AUTO_DESTROY tempString = ffStrbufCreate();
-            ffFormatAppendFormatArg(&tempString, &arguments[index - 1]);
+    for (uint32_t pc = 0; pc < program->ops.length;) {
+        const FFformatOp* op = FF_LIST_GET(FFformatOp, program->ops, pc);
+        ++pc;
+        const char* text = program->strings.chars + op->textOffset;
 
-            char* pEnd = NULL;
-            int32_t start = (int32_t) strtol(pSep + 1, &pEnd, 10);
-            if (start < 0) {
-                start = (int32_t) tempString.length + start;
-            }
-            if (start >= 0 && (uint32_t) start < tempString.length) {
-                if (*pEnd == '\0') {
-                    ffStrbufAppendNS(buffer, tempString.length - (uint32_t) start, &tempString.chars[start]);
-                } else if (*pEnd == ',') {
-                    int32_t end = (int32_t) strtol(pEnd + 1, &pEnd, 10);
-                    if (!*pEnd) {
-                        if (end < 0) {
-                            end = (int32_t) tempString.length + end;
-                        }
-                        if ((uint32_t) end > tempString.length) {
-                            end = (int32_t) tempString.length;
-                        }
-                        if (end > start) {
-                            ffStrbufAppendNS(buffer, (uint32_t) (end - start), &tempString.chars[start]);
-                        }
+        switch (op->type) {
+            case FF_FORMAT_OP_LITERAL:
+                ffStrbufAppendNS(buffer, op->textLength, text);
+                break;
+            case FF_FORMAT_OP_STOP:
+                pc = program->ops.length;
+                break;
+            case FF_FORMAT_OP_END_IF:
+                if (numOpenIfs == 0) {
+                    ffStrbufAppendNS(buffer, op->textLength, text);
+                } else {
+                    --numOpenIfs;
+                }
+                break;
+            case FF_FORMAT_OP_END_NOT_IF:
+                if (numOpenNotIfs == 0) {
+                    ffStrbufAppendNS(buffer, op->textLength, text);
+                } else {
+                    --numOpenNotIfs;
+                }
+                break;
+            case FF_FORMAT_OP_COLOR:
+                if (!instance.config.display.pipe) {
+                    ffStrbufAppendNS(buffer, op->textLength, text);
+                }
+                break;
+            case FF_FORMAT_OP_IF:
+            case FF_FORMAT_OP_NOT_IF: {
+                uint32_t index = resolveArgRef(program, op, numArgs, arguments);
+
+                // testing for an invalid index
+                if (index > numArgs || index < 1) {
+                    ffStrbufAppendNS(buffer, op->textLength, text);
+                } else if (formatArgSet(&arguments[index - 1]) == (op->type == FF_FORMAT_OP_IF)) {
+                    if (op->type == FF_FORMAT_OP_IF) {
+                        ++numOpenIfs;
+                    } else {
+                        ++numOpenNotIfs;
                     }
+                } else {
+                    // fastforward to the end of the if without printing the in between
+                    pc = op->jump;
                 }
+                break;
             }
+            case FF_FORMAT_OP_CONSTANT: {
+                int32_t indexSigned = op->param1;
+                uint32_t index = (uint32_t) (indexSigned < 0 ? (int32_t) instance.config.display.constants.length + indexSigned : indexSigned - 1);
 
-            if (*pEnd) {
-                *pSep = cSep;
-                appendInvalidPlaceholder(buffer, "{", &placeholderValue, i, formatstr->length);
-                continue;
-            }
-        } else {
-            char* pEnd = NULL;
-            int32_t truncLength = (int32_t) strtol(pSep + 1, &pEnd, 10);
-            if (*pEnd != '\0') {
-                *pSep = cSep;
-                appendInvalidPlaceholder(buffer, "{", &placeholderValue, i, formatstr->length);
-                continue;
-            }
-
-            bool ellipsis = false;
-            if (truncLength < 0) {
-                ellipsis = true;
-                truncLength = -truncLength;
+                if (!op->flag || instance.config.display.constants.length <= index) {
+                    ffStrbufAppendNS(buffer, op->textLength, text);
+                } else {
+                    ffStrbufAppend(buffer, FF_LIST_GET(FFstrbuf, instance.config.display.constants, index));
+                }
+                break;
             }
-
-            FF_STRBUF_AUTO_DESTROY tempString = ffStrbufCreate();
-            ffFormatAppendFormatArg(&tempString, &arguments[index - 1]);
-            if (tempString.length == (uint32_t) truncLength) {
-                ffStrbufAppend(buffer, &tempString);
-            } else if (tempString.length > (uint32_t) truncLength) {
-                if (cSep == ':') {
-                    ffStrbufSubstrBefore(&tempString, (uint32_t) truncLength);
-                    ffStrbufTrimRightSpace(&tempString);
+            case FF_FORMAT_OP_ENV: {
+                const char* envValue = getenv(program->strings.chars + op->ref);
+                if (envValue) {
+                    ffStrbufAppendS(buffer, envValue);
                 } else {
-                    ffStrbufSubstrBefore(&tempString, (uint32_t) (!ellipsis ? truncLength : truncLength - 1));
+                    ffStrbufAppendNS(buffer, op->textLength, text);
                 }
-                ffStrbufAppend(buffer, &tempString);
+                break;
+            }
+            case FF_FORMAT_OP_ARG:
+            case FF_FORMAT_OP_INVALID_ARG: {
+                uint32_t index = resolveArgRef(program, op, numArgs, arguments);
 
-                if (ellipsis) {
-                    ffStrbufAppendS(buffer, "…");
+                if (index == 0) {
+                    index = ++argCounter;
                 }
-            } else if (cSep == ':') {
-                ffStrbufAppend(buffer, &tempString);
-            } else {
-                if (cSep == '<') {
-                    ffStrbufAppend(buffer, &tempString);
-                    ffStrbufAppendNC(buffer, (uint32_t) truncLength - tempString.length, ' ');
+
+                if (index > numArgs || op->type == FF_FORMAT_OP_INVALID_ARG) {
+                    ffStrbufAppendNS(buffer, op->textLength, text);
                 } else {
-                    ffStrbufAppendNC(buffer, (uint32_t) truncLength - tempString.length, ' ');
-                    ffStrbufAppend(buffer, &tempString);
+                    appendArg(buffer, op, &arguments[index - 1], text);
                 }
+                break;
             }
         }
     }
@@ -0,0 +1,137 @@
+#include "common/frame.h"
+#include "logo/logo.h"
+
+#include <stdio.h>
+
+typedef struct FFFrameModule {
+    FFOutputCapture capture;
+    bool recorded;
+    bool succeeded;
+} FFFrameModule;
+
+static struct {
+    FFOutputCapture current;
+    FFstrbuf previous; // Content of the previous frame, a line per row
+    FFlist modules;    // FFFrameModule
+    uint32_t rows;     // Number of rows of the previous frame
+    uint32_t count;    // Number of frames written
+    bool rendering;
+} frame;
+
+void ffFrameBegin(void) {
+    if (frame.count > 0) {
+        ffLogoRewind();
+    } else {
+        ffOutputCaptureInit(&frame.current);
+        ffStrbufInit(&frame.previous);
+        ffListInit(&frame.modules);
+    }
+
+    frame.rendering = true;
+    ffOutputSetGlobalCapture(&frame.current);
+}
+
+void ffFrameEnd(void) {
+    ffOutputSetGlobalCapture(NULL);
+    frame.rendering = false;
+
+    FFstrbuf* current = &frame.current.buffer;
+    if (current->length > 0 && !ffStrbufEndsWithC(current, '\n')) {
+        ffStrbufAppendC(current, '\n');
+    }
+
+    FF_STRBUF_AUTO_DESTROY output = ffStrbufCreateA(current->length / 4 + 64);
+
+    // Go back to the first row of the previous frame
+    if (frame.rows > 0) {
+        ffStrbufAppendF(&output, "\e[%uF", frame.rows);
+    }
+
+    const char* prev = frame.previous.chars;
+    const char* prevEnd = prev + frame.previous.length;
+    const char* curEnd = current->chars + current->length;
+    uint32_t rows = 0;
+    uint32_t unchanged = 0;
+
+    for (const char* line = current->chars; line < curEnd; ++rows) {
+        const char* eol = memchr(line, '\n', (size_t) (curEnd - line));
+        uint32_t length = (uint32_t) (eol - line);
+
+        bool same = false;
+        if (prev < prevEnd) {
+            const char* prevEol = memchr(prev, '\n', (size_t) (prevEnd - prev));
+            same = (uint32_t) (prevEol - prev) == length && memcmp(prev, line, length) == 0;
+            prev = prevEol + 1;
+        }
+
+        if (same) {
+            // Moving the cursor down is much cheaper than reprinting the line
+            ++unchanged;
+        } else {
+            ffStrbufAppendNC(&output, unchanged, '\n');
+            unchanged = 0;
+            ffStrbufAppendS(&output, "\e[2K"); // Clear the old line, content may be printed out of order with a logo on the right
+            ffStrbufAppendNS(&output, length, line);
+            ffStrbufAppendC(&output, '\n');
+        }
+
+        line = eol + 1;
+    }
+    ffStrbufAppendNC(&output, unchanged, '\n');
+
+    if (rows < frame.rows) {
+        ffStrbufAppendS(&output, "\e[J"); // Clear the remaining rows of the previous frame
+    }
+
+    ffOutputWriteStrbuf(&output);
+    ffOutputFlush();
+
+    FFstrbuf temp = frame.previous;
+    frame.previous = *current;
+    *current = temp;
+    ffStrbufClear(current);
+    frame.current.logoLines.length = 0;
+
+    frame.rows = rows;
+    ++frame.count;
+}
+
+bool ffFrameIsRendering(void) {
+    return frame.rendering;
+}
+
+const FFOutputCapture* ffFrameGetModuleOutput(uint32_t moduleIndex, bool* succeeded) {
+    if (!frame.rendering || moduleIndex >= frame.modules.length) {
+        return NULL;
+    }
+
+    FFFrameModule* module = FF_LIST_GET(FFFrameModule, frame.modules, moduleIndex);
+    if (!module->recorded) {
+        return NULL;
+    }
+
+    *succeeded = module->succeeded;
+    return &module->capture;
+}
+
+void ffFrameSetModuleOutput(uint32_t moduleIndex, const FFOutputCapture* capture, bool succeeded) {
+    if (!frame.rendering) {
+        return;
+    }
+
+    while (frame.modules.length <= moduleIndex) {
+        FFFrameModule* module = FF_LIST_ADD(FFFrameModule, frame.modules);
+        ffOutputCaptureInit(&module->capture);
+        module->recorded = false;
+        module->succeeded = false;
+    }
+
+    FFFrameModule* module = FF_LIST_GET(FFFrameModule, frame.modules, moduleIndex);
+    ffStrbufSet(&module->capture.buffer, &capture->buffer);
+    module->capture.logoLines.length = 0;
+    FF_LIST_FOR_EACH (uint32_t, offset, capture->logoLines) {
+        *FF_LIST_ADD(uint32_t, module->capture.logoLines) = *offset;
+    }
+    module->recorded = true;
+    module->succeeded = succeeded;
+}
@@ -1,5 +1,7 @@
 #include "fastfetch.h"
 #include "common/init.h"
+#include "common/output.h"
+#include "common/format.h"
 #include "common/parsing.h"
 #include "common/thread.h"
 #include "common/textModifier.h"
@@ -64,6 +66,8 @@ static volatile UINT oldCp = CP_UTF8;
 #endif
 
 static void resetConsole(void) {
+    ffOutputFlush();
+
     if (ffDisableLinewrap) {
         fputs("\033[?7h", stdout);
     }
@@ -136,21 +140,22 @@ void ffStart(void) {
 #endif
 
     // reset everything to default before we start printing
+    // Written together with the first printed module
     if (!instance.config.display.pipe) {
-        fputs(FASTFETCH_TEXT_MODIFIER_RESET, stdout);
+        ffOutputWriteS(FASTFETCH_TEXT_MODIFIER_RESET);
     }
 
     if (ffHideCursor) {
-        fputs("\033[?25l", stdout);
+        ffOutputWriteS("\033[?25l");
     }
 
     if (ffDisableLinewrap) {
-        fputs("\033[?7l", stdout);
+        ffOutputWriteS("\033[?7l");
     }
 
     if (instance.state.dynamicInterval > 0) {
-        fputs("\033[?1049h\033[H", stdout); // Enable alternate buffer
-        fflush(stdout);
+        ffOutputWriteS("\033[?1049h\033[H"); // Enable alternate buffer
+        ffOutputFlush();
     }
 }
 
@@ -166,9 +171,11 @@ static void destroyConfig(void) {
 
 static void destroyState(void) {
     ffPlatformDestroy(&instance.state.platform);
+    ffFormatDestroyPrograms();
 }
 
 void ffDestroyInstance(void) {
+    ffOutputFlush();
     destroyConfig();
     destroyState();
 }
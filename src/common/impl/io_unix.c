@@ -2,6 +2,8 @@
 #include "fastfetch.h"
 #include "common/stringUtils.h"
 #include "common/time.h"
+#include "common/output.h"
+#include "common/thread.h"
 
 #include <fcntl.h>
 #include <termios.h>
@@ -30,6 +32,70 @@ static void createSubfolders(const char* fileName) {
     }
 }
 
+FFstrbuf ffIoRootPrefix;
+FFlist* ffIoRecordedPaths;
+
+#ifdef FF_HAVE_THREADS
+static FFThreadMutex ioRecordMutex = FF_THREAD_MUTEX_INITIALIZER;
+#endif
+
+static void recordPath(const char* path, const char* fileName, bool listDir) {
+    FF_STRBUF_AUTO_DESTROY result = ffStrbufCreateS(path);
+    if (fileName) {
+        ffStrbufEnsureEndsWithC(&result, '/');
+        ffStrbufAppendS(&result, fileName);
+    }
+    if (listDir) {
+        ffStrbufEnsureEndsWithC(&result, '/');
+    }
+
+#ifdef FF_HAVE_THREADS
+    ffThreadMutexLock(&ioRecordMutex);
+#endif
+    if (ffIoRecordedPaths) {
+        ffStrbufInitMove(FF_LIST_ADD(FFstrbuf, *ffIoRecordedPaths), &result);
+    }
+#ifdef FF_HAVE_THREADS
+    ffThreadMutexUnlock(&ioRecordMutex);
+#endif
+}
+
+const char* ffIoHookPath(const char* path, bool listDir, FFstrbuf* buffer) {
+    if (path[0] != '/') {
+        return path;
+    }
+
+    if (ffIoRecordedPaths) {
+        recordPath(path, NULL, listDir);
+        return path;
+    }
+
+    ffStrbufSet(buffer, &ffIoRootPrefix);
+    ffStrbufAppendS(buffer, path);
+    return buffer->chars;
+}
+
+void ffIoHookRelative(int dfd, const char* fileName) {
+#ifdef __linux__
+    if (fileName[0] == '/') {
+        recordPath(fileName, NULL, false);
+        return;
+    }
+
+    char procPath[32];
+    snprintf(procPath, ARRAY_SIZE(procPath), "/proc/self/fd/%d", dfd);
+    char dirPath[PATH_MAX];
+    ssize_t length = readlink(procPath, dirPath, ARRAY_SIZE(dirPath) - 1);
+    if (length <= 0) {
+        return;
+    }
+    dirPath[length] = '\0';
+    recordPath(dirPath, fileName, false);
+#else
+    FF_UNUSED(dfd, fileName);
+#endif
+}
+
 bool ffWriteFileData(const char* fileName, size_t dataSize, const void* data) {
     int openFlagsModes = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
     mode_t openFlagsRights = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
@@ -141,7 +207,7 @@ void restoreTerm(void) {
     tcsetattr(ftty, TCSAFLUSH, &oldTerm);
 }
 
-const char* ffGetTerminalResponse(const char* request, int nParams, const char* format, ...) {
+static const char* getTerminalResponse(const char* request, int nParams, const char* format, va_list args) {
     if (ftty < 0) {
         ftty = open("/dev/tty", O_RDWR | O_NOCTTY | O_CLOEXEC);
         if (ftty < 0) {
@@ -183,14 +249,10 @@ const char* ffGetTerminalResponse(const char* request, int nParams, const char*
     char buffer[1024];
     size_t bytesRead = 0;
 
-    va_list args;
-    va_start(args, format);
-
     while (true) {
         ssize_t nRead = read(ftty, buffer + bytesRead, sizeof(buffer) - bytesRead - 1);
 
         if (nRead <= 0) {
-            va_end(args);
             return "read(STDIN_FILENO, buffer, sizeof(buffer) - 1) failed";
         }
 
@@ -203,7 +265,6 @@ const char* ffGetTerminalResponse(const char* request, int nParams, const char*
         va_end(cargs);
 
         if (ret <= 0) {
-            va_end(args);
             return "vsscanf(buffer, format, args) failed";
         }
         if (ret >= nParams) {
@@ -211,12 +272,21 @@ const char* ffGetTerminalResponse(const char* request, int nParams, const char*
         }
     }
 
-    va_end(args);
-
     return NULL;
 }
 
-bool ffSuppressIO(bool suppress) {
+const char* ffGetTerminalResponse(const char* request, int nParams, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    // The terminal is shared with module output, which may be flushed from other threads
+    ffOutputLock();
+    const char* error = getTerminalResponse(request, nParams, format, args);
+    ffOutputUnlock();
+    va_end(args);
+    return error;
+}
+
+static bool suppressIO(bool suppress) {
 #ifndef NDEBUG
     if (instance.config.display.debugMode) {
         return false;
@@ -243,7 +313,7 @@ bool ffSuppressIO(bool suppress) {
         return false;
     }
 
-    fflush(stdout);
+    ffOutputFlush();
     fflush(stderr);
 
     dup2(suppress ? nullFile : origOut, STDOUT_FILENO);
@@ -251,6 +321,15 @@ bool ffSuppressIO(bool suppress) {
     return true;
 }
 
+bool ffSuppressIO(bool suppress) {
+    // The output lock is only held for the redirection itself. Nothing else is detected meanwhile,
+    // as modules suppressing IO are serialized (see `FFModuleBaseInfo::serialized`)
+    ffOutputLock();
+    bool result = suppressIO(suppress);
+    ffOutputUnlock();
+    return result;
+}
+
 void listFilesRecursively(uint32_t baseLength, FFstrbuf* folder, uint8_t indentation, const char* folderName, bool pretty) {
     int dfd = open(folder->chars, O_RDONLY | O_CLOEXEC | O_DIRECTORY); // Ownership of dfd will be transformed to dir
     if (dfd < 0) {
@@ -1,6 +1,7 @@
 #include "fastfetch.h"
 #include "common/io.h"
 #include "common/stringUtils.h"
+#include "common/output.h"
 #include "common/windows/nt.h"
 #include "common/windows/unicode.h"
 
@@ -144,6 +145,17 @@ static bool createSubfolders(wchar_t* fileName) {
     return true;
 }
 
+// Snapshots are only supported on Unix-like systems
+FFstrbuf ffIoRootPrefix;
+FFlist* ffIoRecordedPaths;
+
+const char* ffIoHookPath(const char* path, FF_A_UNUSED bool listDir, FF_A_UNUSED FFstrbuf* buffer) {
+    return path;
+}
+
+void ffIoHookRelative(FF_A_UNUSED HANDLE dfd, FF_A_UNUSED const char* fileName) {
+}
+
 bool ffWriteFileData(const char* fileName, size_t dataSize, const void* data) {
     wchar_t fileNameW[MAX_PATH];
     ULONG len = 0;
@@ -290,7 +302,7 @@ bool ffPathExpandEnv(const char* in, FFstrbuf* out) {
     return true;
 }
 
-bool ffSuppressIO(bool suppress) {
+static bool suppressIO(bool suppress) {
 #ifndef NDEBUG
     if (instance.config.display.debugMode) {
         return false;
@@ -322,7 +334,7 @@ bool ffSuppressIO(bool suppress) {
         return false;
     }
 
-    fflush(stdout);
+    ffOutputFlush();
     fflush(stderr);
 
     SetStdHandle(STD_OUTPUT_HANDLE, suppress ? hNullFile : hOrigOut);
@@ -333,6 +345,15 @@ bool ffSuppressIO(bool suppress) {
     return true;
 }
 
+bool ffSuppressIO(bool suppress) {
+    // The output lock is only held for the redirection itself. Nothing else is detected meanwhile,
+    // as modules suppressing IO are serialized (see `FFModuleBaseInfo::serialized`)
+    ffOutputLock();
+    bool result = suppressIO(suppress);
+    ffOutputUnlock();
+    return result;
+}
+
 void listFilesRecursively(uint32_t baseLength, FFstrbuf* folder, uint8_t indentation, const char* folderName, bool pretty) {
     uint32_t folderLength = folder->length;
 
@@ -384,7 +405,7 @@ void ffListFilesRecursively(const char* path, bool pretty) {
     listFilesRecursively(folder.length, &folder, 0, NULL, pretty);
 }
 
-const char* ffGetTerminalResponse(const char* request, int nParams, const char* format, ...) {
+static const char* getTerminalResponse(const char* request, int nParams, const char* format, va_list args) {
     HANDLE hInput = GetStdHandle(STD_INPUT_HANDLE);
     FF_AUTO_CLOSE_FD HANDLE hConin = INVALID_HANDLE_VALUE;
     DWORD inputMode = 0;
@@ -433,22 +454,17 @@ const char* ffGetTerminalResponse(const char* request, int nParams, const char*
         }
     }
 
-    va_list args;
-    va_start(args, format);
-
     char buffer[1024];
     uint32_t bytesRead = 0;
 
     while (true) {
         DWORD bytes = 0;
         if (!ReadFile(hInput, buffer + bytesRead, (DWORD) (sizeof(buffer) - 1 - bytesRead), &bytes, NULL) || bytes == 0) {
-            va_end(args);
             return "ReadFile() failed";
         }
 
         bytesRead += bytes;
         if (__builtin_expect(bytesRead >= sizeof(buffer) - 1, false)) {
-            va_end(args);
             return "terminal response buffer overflow";
         }
         buffer[bytesRead] = '\0';
@@ -459,7 +475,6 @@ const char* ffGetTerminalResponse(const char* request, int nParams, const char*
         va_end(cargs);
 
         if (ret <= 0) {
-            va_end(args);
             return "vsscanf(buffer, format, args) failed";
         }
         if (ret >= nParams) {
@@ -471,11 +486,20 @@ const char* ffGetTerminalResponse(const char* request, int nParams, const char*
         SetConsoleMode(hInput, inputMode);
     }
 
-    va_end(args);
-
     return NULL;
 }
 
+const char* ffGetTerminalResponse(const char* request, int nParams, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    // The terminal is shared with module output, which may be flushed from other threads
+    ffOutputLock();
+    const char* error = getTerminalResponse(request, nParams, format, args);
+    ffOutputUnlock();
+    va_end(args);
+    return error;
+}
+
 FFNativeFD ffGetNullFD(void) {
     static FFNativeFD hNullFile = INVALID_HANDLE_VALUE;
     if (hNullFile != INVALID_HANDLE_VALUE) {
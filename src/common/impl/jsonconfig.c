@@ -3,6 +3,7 @@
 #include "common/jsonconfig.h"
 #include "common/printing.h"
 #include "common/io.h"
+#include "common/scheduler.h"
 #include "common/time.h"
 #include "common/stringUtils.h"
 #include "detection/version/version.h"
@@ -87,35 +88,44 @@ const char* ffJsonConfigParseEnum(yyjson_val* val, int* result, FFKeyValuePair p
     }
 }
 
-static bool parseModuleJsonObject(const char* type, yyjson_val* jsonVal, yyjson_mut_doc* jsonDoc) {
+static FFModuleBaseInfo* findModule(const char* type) {
     if (!ffCharIsEnglishAlphabet(type[0])) {
-        return false;
+        return NULL;
     }
 
     for (FFModuleBaseInfo** modules = ffModuleInfos[toupper(type[0]) - 'A']; *modules; ++modules) {
         FFModuleBaseInfo* baseInfo = *modules;
         if (ffStrEqualsIgnCase(type, baseInfo->name)) {
-            uint8_t optionBuf[FF_OPTION_MAX_SIZE];
-            baseInfo->initOptions(optionBuf);
-            if (jsonVal) {
-                baseInfo->parseJsonObject(optionBuf, jsonVal);
-            }
-            bool succeeded;
-            if (jsonDoc) {
-                yyjson_mut_val* module = yyjson_mut_arr_add_obj(jsonDoc, jsonDoc->root);
-                yyjson_mut_obj_add_str(jsonDoc, module, "type", baseInfo->name);
-                if (baseInfo->generateJsonResult) {
-                    succeeded = baseInfo->generateJsonResult(optionBuf, jsonDoc, module);
-                } else {
-                    yyjson_mut_obj_add_str(jsonDoc, module, "error", "Unsupported for JSON format");
-                    succeeded = false;
-                }
-            } else {
-                succeeded = baseInfo->printModule(optionBuf);
-            }
-            baseInfo->destroyOptions(optionBuf);
-            return succeeded;
+            return baseInfo;
+        }
+    }
+    return NULL;
+}
+
+static bool parseModuleJsonObject(const char* type, yyjson_val* jsonVal, yyjson_mut_doc* jsonDoc, FFScheduler* scheduler) {
+    FFModuleBaseInfo* baseInfo = findModule(type);
+    if (baseInfo) {
+        if (!jsonDoc) {
+            ffSchedulerAdd(scheduler, baseInfo, jsonVal);
+            return true; // Unknown until the scheduler is run
+        }
+
+        uint8_t optionBuf[FF_OPTION_MAX_SIZE];
+        baseInfo->initOptions(optionBuf);
+        if (jsonVal) {
+            baseInfo->parseJsonObject(optionBuf, jsonVal);
+        }
+        bool succeeded;
+        yyjson_mut_val* module = yyjson_mut_arr_add_obj(jsonDoc, jsonDoc->root);
+        yyjson_mut_obj_add_str(jsonDoc, module, "type", baseInfo->name);
+        if (baseInfo->generateJsonResult) {
+            succeeded = baseInfo->generateJsonResult(optionBuf, jsonDoc, module);
+        } else {
+            yyjson_mut_obj_add_str(jsonDoc, module, "error", "Unsupported for JSON format");
+            succeeded = false;
         }
+        baseInfo->destroyOptions(optionBuf);
+        return succeeded;
     }
 
     if (jsonDoc) {
@@ -123,21 +133,24 @@ static bool parseModuleJsonObject(const char* type, yyjson_val* jsonVal, yyjson_
         yyjson_mut_obj_add_strcpy(jsonDoc, module, "type", type);
         yyjson_mut_obj_add_str(jsonDoc, module, "error", "Unknown module type");
     } else {
+        // Keep the error in place
+        ffSchedulerRun(scheduler);
         FFModuleArgs moduleArgs;
-        ffOptionInitModuleArg(&moduleArgs, "");
+        ffOptionInitModuleArg(&moduleArgs, "");
         ffPrintError(type, 0, &moduleArgs, FF_PRINT_TYPE_DEFAULT, "Unknown module type");
         ffOptionDestroyModuleArg(&moduleArgs);
     }
     return false;
 }
 
-static void prepareModuleJsonObject(const char* type, yyjson_val* module) {
+// `samplingOnly`: only take the first samples of modules measuring rates over a time window
+static void prepareModuleJsonObject(const char* type, yyjson_val* module, bool samplingOnly) {
     switch (type[0]) {
         case 'c':
         case 'C': {
             if (ffStrEqualsIgnCase(type, FF_CPUUSAGE_MODULE_NAME)) {
                 ffPrepareCPUUsage();
-            } else if (ffStrEqualsIgnCase(type, FF_COMMAND_MODULE_NAME)) {
+            } else if (!samplingOnly && ffStrEqualsIgnCase(type, FF_COMMAND_MODULE_NAME)) {
                 FF_A_CLEANUP(ffDestroyCommandOptions) FFCommandOptions options;
                 ffInitCommandOptions(&options);
                 if (module) {
@@ -173,7 +186,7 @@ static void prepareModuleJsonObject(const char* type, yyjson_val* module) {
         }
         case 'p':
         case 'P': {
-            if (ffStrEqualsIgnCase(type, FF_PUBLICIP_MODULE_NAME)) {
+            if (!samplingOnly && ffStrEqualsIgnCase(type, FF_PUBLICIP_MODULE_NAME)) {
                 FF_A_CLEANUP(ffDestroyPublicIpOptions) FFPublicIPOptions options;
                 ffInitPublicIpOptions(&options);
                 if (module) {
@@ -185,7 +198,7 @@ static void prepareModuleJsonObject(const char* type, yyjson_val* module) {
         }
         case 'w':
         case 'W': {
-            if (ffStrEqualsIgnCase(type, FF_WEATHER_MODULE_NAME)) {
+            if (!samplingOnly && ffStrEqualsIgnCase(type, FF_WEATHER_MODULE_NAME)) {
                 FF_A_CLEANUP(ffDestroyWeatherOptions) FFWeatherOptions options;
                 ffInitWeatherOptions(&options);
                 if (module) {
@@ -219,7 +232,7 @@ static bool matchesJsonArray(const char* str, yyjson_val* val) {
     return false;
 }
 
-static const char* printJsonConfig(FFdata* data, bool prepare) {
+static const char* printJsonConfig(FFdata* data, bool prepare, bool samplingOnly, FFScheduler* scheduler) {
     yyjson_mut_doc* jsonDoc = data->resultDoc;
     yyjson_val* const root = yyjson_doc_get_root(data->configDoc);
     assert(root);
@@ -237,12 +250,12 @@ static const char* printJsonConfig(FFdata* data, bool prepare) {
     }
 
     bool succeeded = true;
-    int32_t thres = instance.config.display.stat;
+    bool stat = !prepare && jsonDoc && instance.config.display.stat >= 0;
     yyjson_val* item;
     size_t idx, max;
     yyjson_arr_foreach (modules, idx, max, item) {
         double ms = 0;
-        if (!prepare && thres >= 0) {
+        if (stat) {
             ms = ffTimeGetTick();
         }
 
@@ -282,6 +295,9 @@ static const char* printJsonConfig(FFdata* data, bool prepare) {
                     if (!unsafe_yyjson_is_bool(previousSucceeded)) {
                         return "Property 'succeeded' in 'condition' must be a boolean";
                     }
+                    if (!jsonDoc && !prepare) {
+                        succeeded = ffSchedulerRun(scheduler);
+                    }
                     if (succeeded != unsafe_yyjson_get_bool(previousSucceeded)) {
                         continue;
                     }
@@ -304,33 +320,16 @@ static const char* printJsonConfig(FFdata* data, bool prepare) {
         }
 
         if (prepare) {
-            prepareModuleJsonObject(type, module);
+            prepareModuleJsonObject(type, module, samplingOnly);
         } else {
-            succeeded = parseModuleJsonObject(type, module, jsonDoc);
+            succeeded = parseModuleJsonObject(type, module, jsonDoc, scheduler);
         }
 
-        if (!prepare && thres >= 0) {
+        if (stat) {
             ms = ffTimeGetTick() - ms;
-            if (jsonDoc) {
-                yyjson_mut_val* moduleJson = yyjson_mut_arr_get_last(jsonDoc->root);
-                yyjson_mut_obj_add_real(jsonDoc, moduleJson, "stat", ms);
-            } else {
-                char str[64];
-                int len = snprintf(str, sizeof str, "%.3fms", ms);
-                if (thres > 0) {
-                    snprintf(str, sizeof str, "\e[%sm%.3fms\e[m", (ms <= thres ? FF_COLOR_FG_GREEN : ms <= 2 * thres ? FF_COLOR_FG_YELLOW
-                                                                                                                     : FF_COLOR_FG_RED),
-                        ms);
-                }
-                printf("\e7\e[1A\e[9999999C\e[%dD%s\e8", len - 1, str); // Save; Up 1; Right 9999999; Left <len - 1>; Print <str>; Load
-            }
-        }
-
-#if defined(_WIN32)
-        if (!instance.config.display.noBuffer && !jsonDoc) {
-            fflush(stdout);
+            yyjson_mut_val* moduleJson = yyjson_mut_arr_get_last(jsonDoc->root);
+            yyjson_mut_obj_add_real(jsonDoc, moduleJson, "stat", ms);
         }
-#endif
     }
 
     return NULL;
@@ -338,7 +337,10 @@ static const char* printJsonConfig(FFdata* data, bool prepare) {
 
 void ffPrintJsonConfig(FFdata* data, bool prepare) {
     yyjson_mut_doc* jsonDoc = data->resultDoc;
-    const char* error = printJsonConfig(data, prepare);
+    FFScheduler scheduler;
+    ffSchedulerInit(&scheduler);
+    const char* error = printJsonConfig(data, prepare, false, &scheduler);
+    ffSchedulerDestroy(&scheduler);
     if (error) {
         if (jsonDoc) {
             yyjson_mut_val* obj = yyjson_mut_obj(jsonDoc);
@@ -349,3 +351,8 @@ void ffPrintJsonConfig(FFdata* data, bool prepare) {
         }
     }
 }
+
+void ffPrepareJsonConfigSampling(FFdata* data) {
+    // Errors are reported by the prepare pass
+    printJsonConfig(data, true, true, NULL);
+}
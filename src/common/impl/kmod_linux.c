@@ -1,12 +1,16 @@
 #include "common/kmod.h"
+#include "common/thread.h"
 #include "common/io.h"
 
 bool ffKmodLoaded(const char* modName) {
     static FFstrbuf modules;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
     if (modules.chars == NULL) {
         ffStrbufInitS(&modules, "\n");
         ffAppendFileBuffer("/proc/modules", &modules);
     }
+    ffThreadMutexUnlock(&mutex);
 
     if (modules.length == 0) {
         return false;
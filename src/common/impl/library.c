@@ -1,5 +1,6 @@
 #include "fastfetch.h"
 #include "common/library.h"
+#include "common/trace.h"
 
 #if _WIN32
     #include "common/debug.h"
@@ -28,6 +29,7 @@
     #endif
 
 static void* libraryLoad(const char* path, int maxVersion) {
+    FF_TRACE_SCOPE("library", "dlopen", path);
     void* result = dlopen(path, FF_DLOPEN_FLAGS);
 
     #if _WIN32
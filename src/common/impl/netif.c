@@ -1,4 +1,5 @@
 #include "common/netif.h"
+#include "common/thread.h"
 
 #ifndef _WIN32
     #include <net/if.h>
@@ -7,16 +8,22 @@
 
 const FFNetifDefaultRouteResult* ffNetifGetDefaultRouteV4(void) {
     static FFNetifDefaultRouteResult result;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
     if (result.status == FF_NETIF_UNINITIALIZED) {
         result.status = ffNetifGetDefaultRouteImplV4(&result) ? FF_NETIF_OK : FF_NETIF_INVALID;
     }
+    ffThreadMutexUnlock(&mutex);
     return &result;
 }
 
 const FFNetifDefaultRouteResult* ffNetifGetDefaultRouteV6(void) {
     static FFNetifDefaultRouteResult result;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
     if (result.status == FF_NETIF_UNINITIALIZED) {
         result.status = ffNetifGetDefaultRouteImplV6(&result) ? FF_NETIF_OK : FF_NETIF_INVALID;
     }
+    ffThreadMutexUnlock(&mutex);
     return &result;
 }
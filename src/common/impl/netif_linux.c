@@ -20,6 +20,7 @@ static uint32_t ffNetifGetNetlinkPortId(int sock_fd) {
 }
 
 bool ffNetifGetDefaultRouteImplV4(FFNetifDefaultRouteResult* result) {
+    FF_TRACE_SCOPE("netlink", "RTM_GETROUTE", "AF_INET");
     FF_DEBUG("Starting IPv4 default route detection");
 
     FF_AUTO_CLOSE_FD int sock_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
@@ -230,6 +231,7 @@ exit:
 }
 
 bool ffNetifGetDefaultRouteImplV6(FFNetifDefaultRouteResult* result) {
+    FF_TRACE_SCOPE("netlink", "RTM_GETROUTE", "AF_INET6");
     FF_DEBUG("Starting IPv6 default route detection");
 
     FF_AUTO_CLOSE_FD int sock_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
@@ -0,0 +1,100 @@
+#include "common/output.h"
+#include "common/io.h"
+#include "common/thread.h"
+
+#include <stdio.h>
+
+static _Thread_local FFOutputCapture* currentCapture;
+static FFOutputCapture* globalCapture;
+static FFstrbuf pending; // Uncaptured output not written to stdout yet. Reused, so it only grows to the size of the largest chunk
+
+#ifdef FF_HAVE_THREADS
+static FFThreadMutex outputMutex = FF_THREAD_MUTEX_INITIALIZER;
+#endif
+
+void ffOutputWrite(const char* data, uint32_t length) {
+    FFOutputCapture* capture = currentCapture ?: globalCapture;
+    if (__builtin_expect(capture != NULL, false)) {
+        ffStrbufAppendNS(&capture->buffer, length, data);
+    } else if (instance.config.display.noBuffer) {
+        fwrite(data, 1, length, stdout);
+    } else {
+        ffStrbufAppendNS(&pending, length, data);
+    }
+}
+
+void ffOutputWriteVF(const char* format, va_list arguments) {
+    FFOutputCapture* capture = currentCapture ?: globalCapture;
+    if (__builtin_expect(capture != NULL, false)) {
+        ffStrbufAppendVF(&capture->buffer, format, arguments);
+    } else if (instance.config.display.noBuffer) {
+        vfprintf(stdout, format, arguments);
+    } else {
+        ffStrbufAppendVF(&pending, format, arguments);
+    }
+}
+
+void ffOutputWriteF(const char* format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    ffOutputWriteVF(format, arguments);
+    va_end(arguments);
+}
+
+void ffOutputFlush(void) {
+    // Anything written with stdio directly goes first, e.g. escape codes of image logos
+    fflush(stdout);
+
+    const char* data = pending.chars;
+    uint32_t remaining = pending.length;
+    while (remaining > 0) {
+#ifndef _WIN32
+        ssize_t written = write(STDOUT_FILENO, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+#else
+        DWORD written;
+        if (!WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), data, remaining, &written, NULL)) {
+            break;
+        }
+#endif
+        data += written;
+        remaining -= (uint32_t) written;
+    }
+    ffStrbufClear(&pending);
+}
+
+FFOutputCapture* ffOutputSetCapture(FFOutputCapture* capture) {
+    FFOutputCapture* previous = currentCapture;
+    currentCapture = capture;
+    return previous;
+}
+
+void ffOutputSetGlobalCapture(FFOutputCapture* capture) {
+    globalCapture = capture;
+}
+
+bool ffOutputDeferLogoLine(void) {
+    if (__builtin_expect(currentCapture == NULL, true)) {
+        return false;
+    }
+
+    *FF_LIST_ADD(uint32_t, currentCapture->logoLines) = currentCapture->buffer.length;
+    return true;
+}
+
+void ffOutputLock(void) {
+#ifdef FF_HAVE_THREADS
+    ffThreadMutexLock(&outputMutex);
+#endif
+}
+
+void ffOutputUnlock(void) {
+#ifdef FF_HAVE_THREADS
+    ffThreadMutexUnlock(&outputMutex);
+#endif
+}
@@ -3,6 +3,9 @@
 #include "common/io.h"
 #include "common/stringUtils.h"
 #include "common/mallocHelper.h"
+#include "common/thread.h"
+#include "common/time.h"
+#include "common/trace.h"
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -10,6 +13,7 @@
 #include <poll.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 
 #if !(__ANDROID__ || __OpenBSD__)
@@ -56,8 +60,8 @@ static inline int ffPipe2(int* fds, int flags) {
 #endif
 }
 
-// Not thread-safe
 const char* ffProcessSpawn(char* const argv[], bool useStdErr, FFProcessHandle* outHandle) {
+    FF_TRACE_SCOPE("process", "spawn", argv[0]);
     int pipes[2];
     if (ffPipe2(pipes, O_CLOEXEC) == -1) {
         return "pipe() failed";
@@ -81,6 +85,9 @@ const char* ffProcessSpawn(char* const argv[], bool useStdErr, FFProcessHandle*
 
     static char* oldLang = NULL;
     static int langIndex = -1;
+    // `environ` is patched in place below
+    static FFThreadMutex envMutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&envMutex);
 
     if (langIndex >= 0) {
         // Found before
@@ -117,6 +124,7 @@ const char* ffProcessSpawn(char* const argv[], bool useStdErr, FFProcessHandle*
     if (oldLang) {
         environ[langIndex] = oldLang;
     }
+    ffThreadMutexUnlock(&envMutex);
 
     posix_spawn_file_actions_destroy(&file_actions);
 
@@ -156,7 +164,24 @@ const char* ffProcessSpawn(char* const argv[], bool useStdErr, FFProcessHandle*
     return NULL;
 }
 
+// Reaps the child after its pipe is closed
+static const char* waitChild(pid_t childPid) {
+    int stat_loc = 0;
+    if (childPid > 0 && waitpid(childPid, &stat_loc, 0) == childPid) {
+        if (!WIFEXITED(stat_loc)) {
+            return "child process exited abnormally";
+        }
+        if (WEXITSTATUS(stat_loc) == 127) {
+            return "command not found";
+        }
+        // We only handle 127 as an error. See `getTerminalVersionUrxvt` in `terminalshell.c`
+        return NULL;
+    }
+    return NULL;
+}
+
 const char* ffProcessReadOutput(FFProcessHandle* handle, FFstrbuf* buffer) {
+    FF_TRACE_SCOPE("process", "read", NULL);
     assert(handle->pipeRead != -1);
     assert(handle->pid != -1);
 
@@ -188,18 +213,7 @@ const char* ffProcessReadOutput(FFProcessHandle* handle, FFstrbuf* buffer) {
         if (nRead > 0) {
             ffStrbufAppendNS(buffer, (uint32_t) nRead, str);
         } else if (nRead == 0) {
-            int stat_loc = 0;
-            if (childPid > 0 && waitpid(childPid, &stat_loc, 0) == childPid) {
-                if (!WIFEXITED(stat_loc)) {
-                    return "child process exited abnormally";
-                }
-                if (WEXITSTATUS(stat_loc) == 127) {
-                    return "command not found";
-                }
-                // We only handle 127 as an error. See `getTerminalVersionUrxvt` in `terminalshell.c`
-                return NULL;
-            }
-            return NULL;
+            return waitChild(childPid);
         } else if (nRead < 0) {
             break;
         }
@@ -208,6 +222,281 @@ const char* ffProcessReadOutput(FFProcessHandle* handle, FFstrbuf* buffer) {
     return "read(childPipeFd, str, FF_PIPE_BUFSIZ) failed";
 }
 
+static void finishJob(FFProcessJob* job, const char* error) {
+    if (error) {
+        kill(job->handle.pid, SIGTERM);
+        waitpid(job->handle.pid, NULL, 0);
+    } else {
+        error = waitChild(job->handle.pid);
+    }
+    close(job->handle.pipeRead);
+    job->handle.pipeRead = -1;
+    job->handle.pid = -1;
+
+    if (!error) {
+        ffStrbufTrimRightSpace(&job->output);
+    }
+    job->error = error;
+    job->finished = true;
+}
+
+void ffProcessReactorWait(FFProcessReactor* reactor, FFProcessJob* job) {
+    FF_TRACE_SCOPE("process", "wait", NULL);
+    const int32_t timeout = instance.config.general.processingTimeout;
+    const double deadline = ffTimeGetTick() + timeout;
+
+    FF_AUTO_FREE struct pollfd* pollfds = malloc(reactor->jobs.length * sizeof(*pollfds));
+    FF_AUTO_FREE FFProcessJob** pending = malloc(reactor->jobs.length * sizeof(*pending));
+    char str[FF_PIPE_BUFSIZ];
+
+    while (job == NULL || !job->finished) {
+        nfds_t count = 0;
+        FF_LIST_FOR_EACH (FFProcessJob*, item, reactor->jobs) {
+            if (!(*item)->finished) {
+                pending[count] = *item;
+                pollfds[count] = (struct pollfd) { (*item)->handle.pipeRead, POLLIN, 0 };
+                ++count;
+            }
+        }
+        if (count == 0) {
+            break;
+        }
+
+        int remaining = -1;
+        if (timeout >= 0) {
+            double ms = deadline - ffTimeGetTick();
+            remaining = ms > 0 ? (int) ms + 1 : 0;
+        }
+
+        int pollret = poll(pollfds, count, remaining);
+        if (pollret == 0) {
+            for (nfds_t i = 0; i < count; ++i) {
+                if (job == NULL || pending[i] == job) {
+                    finishJob(pending[i], "poll() timeout (try increasing --processing-timeout)");
+                }
+            }
+            break;
+        } else if (pollret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            for (nfds_t i = 0; i < count; ++i) {
+                finishJob(pending[i], "poll() error: pollret < 0");
+            }
+            break;
+        }
+
+        for (nfds_t i = 0; i < count; ++i) {
+            if (pollfds[i].revents == 0) {
+                continue;
+            }
+            if (pollfds[i].revents & POLLERR) {
+                finishJob(pending[i], "poll() error: pollfd.revents & POLLERR");
+                continue;
+            }
+
+            ssize_t nRead = read(pollfds[i].fd, str, FF_PIPE_BUFSIZ);
+            if (nRead > 0) {
+                ffStrbufAppendNS(&pending[i]->output, (uint32_t) nRead, str);
+            } else {
+                finishJob(pending[i], nRead == 0 ? NULL : "read(childPipeFd, str, FF_PIPE_BUFSIZ) failed");
+            }
+        }
+    }
+}
+
+void ffProcessReactorDestroy(FFProcessReactor* reactor) {
+    FF_LIST_FOR_EACH (FFProcessJob*, item, reactor->jobs) {
+        if (!(*item)->finished) {
+            finishJob(*item, "terminated");
+        }
+        ffStrbufDestroy(&(*item)->output);
+        free(*item);
+    }
+    ffListDestroy(&reactor->jobs);
+}
+
+#if defined(__linux__) || defined(__GNU__)
+
+static struct {
+    FFlist entries; // FFProcessEntry, sorted by pid
+    bool complete;  // Contains every process, rather than only the ones looked up by pid
+} processTable;
+
+    #ifdef FF_HAVE_THREADS
+static FFThreadMutex processTableMutex = FF_THREAD_MUTEX_INITIALIZER;
+    #endif
+
+static inline void processTableLock(void) {
+    #ifdef FF_HAVE_THREADS
+    ffThreadMutexLock(&processTableMutex);
+    #endif
+}
+
+static inline void processTableUnlock(void) {
+    #ifdef FF_HAVE_THREADS
+    ffThreadMutexUnlock(&processTableMutex);
+    #endif
+}
+
+// Returns the index of `pid`, or the index to insert it at
+static uint32_t processTableBisect(const FFlist* entries, pid_t pid) {
+    uint32_t lo = 0, hi = entries->length;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (FF_LIST_GET(FFProcessEntry, *entries, mid)->pid < pid) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static FFProcessEntry* processTableFind(const FFlist* entries, pid_t pid) {
+    uint32_t index = processTableBisect(entries, pid);
+    if (index < entries->length) {
+        FFProcessEntry* entry = FF_LIST_GET(FFProcessEntry, *entries, index);
+        if (entry->pid == pid) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void processTableDestroyEntries(FFlist* entries) {
+    FF_LIST_FOR_EACH (FFProcessEntry, entry, *entries) {
+        ffStrbufDestroy(&entry->name);
+        ffStrbufDestroy(&entry->exe);
+        ffStrbufDestroy(&entry->exePath);
+    }
+    ffListDestroy(entries);
+}
+
+// `buf` is the NUL terminated content of `/proc/<pid>/stat`: pid (comm) state ppid pgrp session tty ...
+static const char* parseProcStat(const char* buf, size_t length, FFstrbuf* name, pid_t* ppid, int32_t* tty) {
+    // comm in `/proc/pid/stat` is not encoded, and may contain ' ', ')' or even `\n`
+    const char* start = memchr(buf, '(', length);
+    if (!start) {
+        return "memchr(stat, '(') failed";
+    }
+    start++;
+    const char* end = memrchr(start, ')', length - (size_t) (start - buf));
+    if (!end) {
+        return "memrchr(stat, ')') failed";
+    }
+    ffStrbufSetNS(name, (uint32_t) (end - start), start);
+    ffStrbufTrimRightSpace(name);
+    if (name->chars[0] == '\0') {
+        return "process name is empty";
+    }
+
+    int ppid_, tty_;
+    if (sscanf(end + 4, "%d %*d %*d %d", &ppid_, &tty_) < 2) { // skip ") S "
+        return "sscanf(stat) failed";
+    }
+    *ppid = (pid_t) ppid_;
+    *tty = tty_ & 0xFF;
+    return NULL;
+}
+
+static int compareProcessEntry(const void* a, const void* b) {
+    pid_t x = ((const FFProcessEntry*) a)->pid, y = ((const FFProcessEntry*) b)->pid;
+    return x < y ? -1 : x > y;
+}
+
+static bool readProcessTable(FFlist* entries) {
+    FF_AUTO_CLOSE_DIR DIR* dir = ffOpenDir("/proc");
+    if (dir == NULL) {
+        return false;
+    }
+    int dfd = dirfd(dir);
+
+    char buf[PROC_FILE_BUFFSIZ];
+    char path[32];
+    struct dirent* dirent;
+    while ((dirent = readdir(dir)) != NULL) {
+        if (
+    #ifdef _DIRENT_HAVE_D_TYPE
+            (dirent->d_type != DT_DIR && dirent->d_type != DT_UNKNOWN) ||
+    #endif
+            !ffCharIsDigit(dirent->d_name[0])) {
+            continue;
+        }
+
+        char* pend;
+        unsigned long pid = strtoul(dirent->d_name, &pend, 10);
+        if (*pend != '\0') {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "%lu/stat", pid);
+        ssize_t nRead = ffReadFileDataRelative(dfd, path, sizeof(buf) - 1, buf);
+        if (nRead <= 8) {
+            continue; // Exited
+        }
+        buf[nRead] = '\0';
+
+        FFProcessEntry* entry = FF_LIST_ADD(FFProcessEntry, *entries);
+        ffStrbufInit(&entry->name);
+        if (parseProcStat(buf, (size_t) nRead, &entry->name, &entry->ppid, &entry->tty) != NULL) {
+            ffStrbufDestroy(&entry->name);
+            --entries->length;
+            continue;
+        }
+        entry->pid = (pid_t) pid;
+        struct stat st;
+        entry->uid = fstatat(dfd, dirent->d_name, &st, 0) == 0 ? (uint32_t) st.st_uid : (uint32_t) -1;
+        ffStrbufInit(&entry->exe);
+        ffStrbufInit(&entry->exePath);
+    }
+
+    // /proc is listed in pid order, but it's not guaranteed
+    for (uint32_t i = 1; i < entries->length; ++i) {
+        if (FF_LIST_GET(FFProcessEntry, *entries, i - 1)->pid > FF_LIST_GET(FFProcessEntry, *entries, i)->pid) {
+            ffListSort(entries, sizeof(FFProcessEntry), compareProcessEntry);
+            break;
+        }
+    }
+    return true;
+}
+
+const FFlist* ffProcessTableGetAll(void) {
+    FF_TRACE_SCOPE("process", "table", NULL);
+
+    processTableLock();
+    if (!processTable.complete) {
+        FFlist entries = ffListCreate();
+        if (readProcessTable(&entries)) {
+            // Keep what has been read by `ffProcessGetInfoLinux`
+            FF_LIST_FOR_EACH (FFProcessEntry, old, processTable.entries) {
+                FFProcessEntry* entry = processTableFind(&entries, old->pid);
+                if (entry) {
+                    ffStrbufInitMove(&entry->exe, &old->exe);
+                    ffStrbufInitMove(&entry->exePath, &old->exePath);
+                }
+            }
+            processTableDestroyEntries(&processTable.entries);
+            ffListInitMove(&processTable.entries, &entries);
+            processTable.complete = true;
+        } else {
+            processTableDestroyEntries(&entries);
+        }
+    }
+    const FFlist* result = processTable.complete ? &processTable.entries : NULL;
+    processTableUnlock();
+    return result;
+}
+
+uint32_t ffProcessTableGetCount(void) {
+    processTableLock();
+    uint32_t result = processTable.complete ? processTable.entries.length : 0;
+    processTableUnlock();
+    return result;
+}
+
+#endif
+
 void ffProcessGetInfoLinux(pid_t pid, FFstrbuf* processName, FFstrbuf* exe, const char** exeName, FFstrbuf* exePath) {
     assert(processName->length > 0);
     ffStrbufClear(exe);
@@ -217,61 +506,84 @@ void ffProcessGetInfoLinux(pid_t pid, FFstrbuf* processName, FFstrbuf* exe, cons
 
 #if defined(__linux__) || defined(__GNU__)
 
-    char filePath[64];
-    snprintf(filePath, sizeof(filePath), "/proc/%d/cmdline", (int) pid);
+    processTableLock();
+    FFProcessEntry* entry = processTableFind(&processTable.entries, pid);
+    bool cached = entry && entry->exe.length > 0 && (!exePath || entry->exePath.length > 0);
+    if (cached) {
+        ffStrbufSet(exe, &entry->exe);
+        if (exePath) {
+            ffStrbufSet(exePath, &entry->exePath);
+        }
+    }
+    processTableUnlock();
 
-    if (ffReadFileBuffer(filePath, exe)) {
-        const char* p = exe->chars;
-        uint32_t len = (uint32_t) strlen(p);
+    if (!cached) {
+        char filePath[64];
+        snprintf(filePath, sizeof(filePath), "/proc/%d/cmdline", (int) pid);
 
-        if (len + 1 < exe->length) {
-            const char* name = memrchr(p, '/', len);
-            if (name) {
-                name++;
-            } else {
-                name = p;
-            }
+        if (ffReadFileBuffer(filePath, exe)) {
+            const char* p = exe->chars;
+            uint32_t len = (uint32_t) strlen(p);
 
-            // For interpreters, try to find the real script path in the arguments
-            if (ffStrStartsWith(name, "python")
+            if (len + 1 < exe->length) {
+                const char* name = memrchr(p, '/', len);
+                if (name) {
+                    name++;
+                } else {
+                    name = p;
+                }
+
+                // For interpreters, try to find the real script path in the arguments
+                if (ffStrStartsWith(name, "python")
     #ifndef __ANDROID__
-                || ffStrEquals(name, "guile") // for shepherd
+                    || ffStrEquals(name, "guile") // for shepherd
     #endif
-            ) {
-                // `cmdline` always ends with a trailing '\0', and ffReadFileBuffer appends another \0
-                // So `exe->chars` is always double '\0' terminated
-                for (p = p + len + 1; *p && *p == '-'; p += strlen(p) + 1) { // Skip arguments
-                    assert(p - exe->chars < exe->allocated);
-                }
-                if (*p) {
-                    len = (uint32_t) strlen(p);
-                    memmove(exe->chars, p, len + 1);
+                ) {
+                    // `cmdline` always ends with a trailing '\0', and ffReadFileBuffer appends another \0
+                    // So `exe->chars` is always double '\0' terminated
+                    for (p = p + len + 1; *p && *p == '-'; p += strlen(p) + 1) { // Skip arguments
+                        assert(p - exe->chars < exe->allocated);
+                    }
+                    if (*p) {
+                        len = (uint32_t) strlen(p);
+                        memmove(exe->chars, p, len + 1);
+                    }
                 }
             }
+
+            assert(len < exe->allocated);
+            exe->length = len;
+            ffStrbufTrimLeft(exe, '-'); // Login shells start with a dash
         }
 
-        assert(len < exe->allocated);
-        exe->length = len;
-        ffStrbufTrimLeft(exe, '-'); // Login shells start with a dash
-    }
+        if (exePath) {
+            snprintf(filePath, sizeof(filePath), "/proc/%d/exe", (int) pid);
+            char buf[PATH_MAX];
+            ssize_t length = readlink(filePath, buf, PATH_MAX - 1);
+            if (length > 0) // doesn't contain trailing NUL
+            {
+                buf[length] = '\0';
+                // When the process is a deleted executable, the resolved path is like `/usr/bin/app (deleted)`
+                // But we can still access the binary via `/proc/pid/exe`. See #2136
+                if (ffPathExists(buf, FF_PATHTYPE_ANY)) {
+                    ffStrbufSetNS(exePath, (uint32_t) length, buf);
+                }
+            }
 
-    if (exePath) {
-        snprintf(filePath, sizeof(filePath), "/proc/%d/exe", (int) pid);
-        char buf[PATH_MAX];
-        ssize_t length = readlink(filePath, buf, PATH_MAX - 1);
-        if (length > 0) // doesn't contain trailing NUL
-        {
-            buf[length] = '\0';
-            // When the process is a deleted executable, the resolved path is like `/usr/bin/app (deleted)`
-            // But we can still access the binary via `/proc/pid/exe`. See #2136
-            if (ffPathExists(buf, FF_PATHTYPE_ANY)) {
-                ffStrbufSetNS(exePath, (uint32_t) length, buf);
+            if (exePath->length == 0) {
+                ffStrbufSetS(exePath, filePath);
             }
         }
 
-        if (exePath->length == 0) {
-            ffStrbufSetS(exePath, filePath);
+        processTableLock();
+        entry = processTableFind(&processTable.entries, pid);
+        if (entry) {
+            ffStrbufSet(&entry->exe, exe);
+            if (exePath) {
+                ffStrbufSet(&entry->exePath, exePath);
+            }
         }
+        processTableUnlock();
     }
 
 #elif defined(__APPLE__)
@@ -462,10 +774,9 @@ void ffProcessGetInfoLinux(pid_t pid, FFstrbuf* processName, FFstrbuf* exe, cons
     }
 
     assert(exe->length > 0);
+    // `exe` may have been reallocated, so `exeName` must be set even if there is no slash
     uint32_t lastSlashIndex = ffStrbufLastIndexC(exe, '/');
-    if (lastSlashIndex < exe->length) {
-        *exeName = exe->chars + lastSlashIndex + 1;
-    }
+    *exeName = lastSlashIndex < exe->length ? exe->chars + lastSlashIndex + 1 : exe->chars;
 }
 
 const char* ffProcessGetBasicInfoLinux(pid_t pid, FFstrbuf* name, pid_t* ppid, int32_t* tty) {
@@ -475,67 +786,61 @@ const char* ffProcessGetBasicInfoLinux(pid_t pid, FFstrbuf* name, pid_t* ppid, i
 
 #if defined(__linux__) || defined(__GNU__)
 
-    char procFilePath[64];
-    #if __linux__
-    if (ppid || tty)
-    #endif
-    {
+    pid_t ppid_;
+    int32_t tty_;
+
+    processTableLock();
+    FFProcessEntry* entry = processTableFind(&processTable.entries, pid);
+    if (entry) {
+        ffStrbufSet(name, &entry->name);
+        ppid_ = entry->ppid;
+        tty_ = entry->tty;
+    }
+    processTableUnlock();
+
+    if (!entry) {
+        char procFilePath[64];
         snprintf(procFilePath, sizeof(procFilePath), "/proc/%d/stat", (int) pid);
         char buf[PROC_FILE_BUFFSIZ];
         ssize_t nRead = ffReadFileData(procFilePath, sizeof(buf) - 1, buf);
         if (nRead <= 8) {
             return "ffReadFileData(/proc/pid/stat, PROC_FILE_BUFFSIZ-1, buf) failed";
         }
-        buf[nRead] = '\0'; // pid (comm) state ppid pgrp session tty
+        buf[nRead] = '\0';
 
-        const char* pState = NULL;
-
-        {
-            // comm in `/proc/pid/stat` is not encoded, and may contain ' ', ')' or even `\n`
-            const char* start = memchr(buf, '(', (size_t) nRead);
-            if (!start) {
-                return "memchr(stat, '(') failed";
-            }
-            start++;
-            const char* end = memrchr(start, ')', (size_t) nRead - (size_t) (start - buf));
-            if (!end) {
-                return "memrchr(stat, ')') failed";
-            }
-            ffStrbufSetNS(name, (uint32_t) (end - start), start);
-            ffStrbufTrimRightSpace(name);
-            if (name->chars[0] == '\0') {
-                return "process name is empty";
-            }
-            pState = end + 2; // skip ") "
+        const char* error = parseProcStat(buf, (size_t) nRead, name, &ppid_, &tty_);
+        if (error) {
+            return error;
         }
 
-    #if !__linux__
-        if (ppid || tty)
-    #endif
-        {
-            int ppid_, tty_;
-            if (sscanf(pState + 2, "%d %*d %*d %d", &ppid_, &tty_) < 2) {
-                return "sscanf(stat) failed";
-            }
-
-            if (ppid) {
-                *ppid = (pid_t) ppid_;
-            }
-            if (tty) {
-                *tty = tty_ & 0xFF;
+        // A complete table must not change, as it may be iterated without the lock
+        processTableLock();
+        if (!processTable.complete) {
+            uint32_t index = processTableBisect(&processTable.entries, pid);
+            if (index == processTable.entries.length || FF_LIST_GET(FFProcessEntry, processTable.entries, index)->pid != pid) {
+                FF_LIST_ADD(FFProcessEntry, processTable.entries);
+                FFProcessEntry* entries = (FFProcessEntry*) processTable.entries.data;
+                memmove(&entries[index + 1], &entries[index], (processTable.entries.length - index - 1) * sizeof(*entries));
+                entries[index] = (FFProcessEntry) {
+                    .pid = pid,
+                    .ppid = ppid_,
+                    .tty = tty_,
+                    .uid = (uint32_t) -1,
+                };
+                ffStrbufInitCopy(&entries[index].name, name);
+                ffStrbufInit(&entries[index].exe);
+                ffStrbufInit(&entries[index].exePath);
             }
         }
+        processTableUnlock();
     }
-    #if __linux__
-    else {
-        snprintf(procFilePath, sizeof(procFilePath), "/proc/%d/comm", (int) pid);
-        ssize_t nRead = ffReadFileBuffer(procFilePath, name);
-        if (nRead <= 0) {
-            return "ffReadFileBuffer(/proc/pid/comm, name) failed";
-        }
-        ffStrbufTrimRightSpace(name);
+
+    if (ppid) {
+        *ppid = ppid_;
+    }
+    if (tty) {
+        *tty = tty_;
     }
-    #endif
 
 #elif defined(__APPLE__)
 
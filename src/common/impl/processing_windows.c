@@ -2,6 +2,7 @@
 #include "common/mallocHelper.h"
 #include "common/processing.h"
 #include "common/io.h"
+#include "common/trace.h"
 #include "common/windows/unicode.h"
 #include "common/windows/nt.h"
 
@@ -49,6 +50,7 @@ static void argvToCmdline(char* const argv[], FFstrbuf* result) {
 }
 
 const char* ffProcessSpawn(char* const argv[], bool useStdErr, FFProcessHandle* outHandle) {
+    FF_TRACE_SCOPE("process", "spawn", argv[0]);
     const int32_t timeout = instance.config.general.processingTimeout;
 
     wchar_t pipeName[32];
@@ -148,6 +150,7 @@ static void terminateChildProcess(HANDLE hProcess, HANDLE hChildPipeRead, HANDLE
 }
 
 const char* ffProcessReadOutput(FFProcessHandle* handle, FFstrbuf* buffer) {
+    FF_TRACE_SCOPE("process", "read", NULL);
     assert(handle->pipeRead != INVALID_HANDLE_VALUE);
     assert(handle->pid != INVALID_HANDLE_VALUE);
 
@@ -222,6 +225,35 @@ exit: {
     return NULL;
 }
 
+void ffProcessReactorWait(FFProcessReactor* reactor, FFProcessJob* job) {
+    FF_TRACE_SCOPE("process", "wait", NULL);
+    // All processes are already running, so reading them one by one only waits for the slowest one
+    FF_LIST_FOR_EACH (FFProcessJob*, item, reactor->jobs) {
+        if ((*item)->finished || (job && *item != job)) {
+            continue;
+        }
+
+        (*item)->error = ffProcessReadOutput(&(*item)->handle, &(*item)->output);
+        if (!(*item)->error) {
+            ffStrbufTrimRightSpace(&(*item)->output);
+        }
+        (*item)->finished = true;
+    }
+}
+
+void ffProcessReactorDestroy(FFProcessReactor* reactor) {
+    FF_LIST_FOR_EACH (FFProcessJob*, item, reactor->jobs) {
+        if (!(*item)->finished) {
+            NtTerminateProcess((*item)->handle.pid, 1);
+            NtClose((*item)->handle.pid);
+            NtClose((*item)->handle.pipeRead);
+        }
+        ffStrbufDestroy(&(*item)->output);
+        free(*item);
+    }
+    ffListDestroy(&reactor->jobs);
+}
+
 bool ffProcessGetInfoWindows(uint32_t pid, uint32_t* ppid, FFstrbuf* pname, FFstrbuf* exe, const char** exeName, FFstrbuf* exePath, bool* gui) {
     FF_AUTO_CLOSE_FD HANDLE hProcess = NtCurrentProcess();
     if (pid != 0) {
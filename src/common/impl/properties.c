@@ -94,7 +94,8 @@ bool ffParsePropLines(const char* lines, const char* start, FFstrbuf* buffer) {
 // The last occurrence of start in the first file will be the one used
 
 bool ffParsePropFileValues(const char* filename, uint32_t numQueries, FFpropquery* queries) {
-    FF_AUTO_CLOSE_FILE FILE* file = fopen(filename, "r");
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    FF_AUTO_CLOSE_FILE FILE* file = fopen(ffIoResolvePath(filename, false, &rooted), "r");
     if (file == NULL) {
         return false;
     }
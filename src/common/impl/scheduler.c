@@ -0,0 +1,267 @@
+#include "common/scheduler.h"
+#include "common/color.h"
+#include "common/frame.h"
+#include "common/thread.h"
+#include "common/time.h"
+#include "common/trace.h"
+#include "logo/logo.h"
+
+#include <stdio.h>
+
+// Detection is mostly blocked on IO and child processes, so this doesn't depend on the CPU count
+#define FF_SCHEDULER_MAX_THREADS 8
+
+static void printStat(double ms) {
+    int32_t thres = instance.config.display.stat;
+
+    char str[64];
+    int len = snprintf(str, sizeof str, "%.3fms", ms);
+    if (thres > 0) {
+        snprintf(str, sizeof str, "\e[%sm%.3fms\e[m", (ms <= thres ? FF_COLOR_FG_GREEN : ms <= 2 * thres ? FF_COLOR_FG_YELLOW
+                                                                                                         : FF_COLOR_FG_RED),
+            ms);
+    }
+    ffOutputWriteF("\e7\e[1A\e[9999999C\e[%dD%s\e8", len - 1, str); // Save; Up 1; Right 9999999; Left <len - 1>; Print <str>; Load
+}
+
+static bool printModule(FFModuleBaseInfo* baseInfo, void* options) {
+    ffTraceModuleBegin(baseInfo->name);
+    double ms = 0;
+    if (instance.config.display.stat >= 0) {
+        ms = ffTimeGetTick();
+    }
+
+    bool succeeded = baseInfo->printModule(options);
+    ffTraceModuleEnd();
+
+    if (instance.config.display.stat >= 0) {
+        printStat(ffTimeGetTick() - ms);
+    }
+    return succeeded;
+}
+
+static void replayCapture(const FFOutputCapture* capture) {
+    FF_TRACE_SCOPE("output", "print", NULL);
+    uint32_t start = 0;
+    FF_LIST_FOR_EACH (uint32_t, offset, capture->logoLines) {
+        ffOutputWrite(capture->buffer.chars + start, *offset - start);
+        ffLogoPrintLine();
+        start = *offset;
+    }
+    ffOutputWrite(capture->buffer.chars + start, capture->buffer.length - start);
+}
+
+static bool isInvariant(FFModuleBaseInfo* baseInfo, void* options) {
+    return ffFrameIsRendering() && baseInfo->isInvariant && baseInfo->isInvariant(options);
+}
+
+void ffSchedulerInit(FFScheduler* scheduler) {
+    ffListInit(&scheduler->jobs);
+    ffListInit(&scheduler->order);
+    scheduler->nextJob = 0;
+    scheduler->nextFlush = 0;
+    scheduler->nextModule = 0;
+#ifdef FF_HAVE_THREADS
+    scheduler->parallel = instance.config.general.multithreading && instance.config.general.parallel;
+#else
+    scheduler->parallel = false;
+#endif
+    scheduler->lastSucceeded = true;
+}
+
+void ffSchedulerAdd(FFScheduler* scheduler, FFModuleBaseInfo* baseInfo, yyjson_val* module) {
+    uint32_t moduleIndex = scheduler->nextModule++;
+
+    if (!scheduler->parallel) {
+        uint8_t optionBuf[FF_OPTION_MAX_SIZE];
+        baseInfo->initOptions(optionBuf);
+        if (module) {
+            baseInfo->parseJsonObject(optionBuf, module);
+        }
+
+        if (!isInvariant(baseInfo, optionBuf)) {
+            scheduler->lastSucceeded = printModule(baseInfo, optionBuf);
+        } else {
+            const FFOutputCapture* recorded = ffFrameGetModuleOutput(moduleIndex, &scheduler->lastSucceeded);
+            if (recorded) {
+                replayCapture(recorded);
+            } else {
+                FFOutputCapture capture;
+                ffOutputCaptureInit(&capture);
+                FFOutputCapture* previous = ffOutputSetCapture(&capture);
+                scheduler->lastSucceeded = printModule(baseInfo, optionBuf);
+                ffOutputSetCapture(previous);
+                replayCapture(&capture);
+                ffFrameSetModuleOutput(moduleIndex, &capture, scheduler->lastSucceeded);
+                ffOutputCaptureDestroy(&capture);
+            }
+        }
+        baseInfo->destroyOptions(optionBuf);
+
+        if (!ffFrameIsRendering()) {
+            ffOutputFlush();
+        }
+        return;
+    }
+
+    FFModuleJob* job = FF_LIST_ADD(FFModuleJob, scheduler->jobs);
+    job->baseInfo = baseInfo;
+    job->options = malloc(FF_OPTION_MAX_SIZE);
+    job->moduleIndex = moduleIndex;
+    job->succeeded = false;
+    job->finished = false;
+    ffOutputCaptureInit(&job->capture);
+
+    // Errors of parsing must be printed in the position of the module too
+    FFOutputCapture* previous = ffOutputSetCapture(&job->capture);
+    baseInfo->initOptions(job->options);
+    if (module) {
+        baseInfo->parseJsonObject(job->options, module);
+    }
+    ffOutputSetCapture(previous);
+
+    job->invariant = isInvariant(baseInfo, job->options);
+    job->sampling = baseInfo->isSampling && baseInfo->isSampling(job->options);
+    job->serialized = baseInfo->serialized;
+    if (job->invariant) {
+        const FFOutputCapture* recorded = ffFrameGetModuleOutput(moduleIndex, &job->succeeded);
+        if (recorded) {
+            ffStrbufSet(&job->capture.buffer, &recorded->buffer);
+            FF_LIST_FOR_EACH (uint32_t, offset, recorded->logoLines) {
+                *FF_LIST_ADD(uint32_t, job->capture.logoLines) = *offset;
+            }
+            baseInfo->destroyOptions(job->options);
+            job->invariant = false; // Already recorded
+            job->finished = true;
+        }
+    }
+}
+
+#ifdef FF_HAVE_THREADS
+
+// Must be called with the output lock held
+static void flushFinishedJobs(FFScheduler* scheduler) {
+    uint32_t first = scheduler->nextFlush;
+    while (scheduler->nextFlush < scheduler->jobs.length) {
+        FFModuleJob* job = FF_LIST_GET(FFModuleJob, scheduler->jobs, scheduler->nextFlush);
+        if (!job->finished) {
+            break;
+        }
+
+        replayCapture(&job->capture);
+        ++scheduler->nextFlush;
+    }
+
+    // All modules that became printable are written at once
+    if (scheduler->nextFlush > first && !ffFrameIsRendering()) {
+        ffOutputFlush();
+    }
+}
+
+static void runJob(FFScheduler* scheduler, FFModuleJob* job) {
+    ffOutputSetCapture(&job->capture);
+    job->succeeded = printModule(job->baseInfo, job->options);
+    job->baseInfo->destroyOptions(job->options);
+    ffOutputSetCapture(NULL);
+
+    ffOutputLock();
+    job->finished = true;
+    flushFinishedJobs(scheduler);
+    ffOutputUnlock();
+}
+
+static void workerMain(FFScheduler* scheduler) {
+    while (true) {
+        uint32_t index = __atomic_fetch_add(&scheduler->nextJob, 1, __ATOMIC_RELAXED);
+        if (index >= scheduler->order.length) {
+            break;
+        }
+
+        FFModuleJob* job = FF_LIST_GET(FFModuleJob, scheduler->jobs, *FF_LIST_GET(uint32_t, scheduler->order, index));
+        if (job->finished) {
+            continue; // Replayed from an earlier frame
+        }
+        runJob(scheduler, job);
+    }
+}
+
+FF_THREAD_ENTRY_DECL_WRAPPER(workerMain, FFScheduler*)
+
+#endif
+
+bool ffSchedulerRun(FFScheduler* scheduler) {
+    if (scheduler->jobs.length == 0) {
+        return scheduler->lastSucceeded;
+    }
+
+#ifdef FF_HAVE_THREADS
+    // Modules that are not thread safe run before any worker exists. Besides libraries that are not initialized
+    // for threads (Xlib, GLX, EGL, ...), this keeps `ffSuppressIO` from redirecting stdout and stderr of running modules
+    FF_LIST_FOR_EACH (FFModuleJob, job, scheduler->jobs) {
+        if (job->serialized && !job->finished) {
+            runJob(scheduler, job);
+        }
+    }
+
+    // The first samples were taken when the config was loaded. Waiting for the rest of the window at the end
+    // lets the other modules fill it, instead of having sampling modules occupy workers while others queue
+    scheduler->order.length = 0;
+    for (uint32_t i = 0; i < scheduler->jobs.length; ++i) {
+        const FFModuleJob* job = FF_LIST_GET(FFModuleJob, scheduler->jobs, i);
+        if (!job->serialized && !job->sampling) {
+            *FF_LIST_ADD(uint32_t, scheduler->order) = i;
+        }
+    }
+    for (uint32_t i = 0; i < scheduler->jobs.length; ++i) {
+        const FFModuleJob* job = FF_LIST_GET(FFModuleJob, scheduler->jobs, i);
+        if (!job->serialized && job->sampling) {
+            *FF_LIST_ADD(uint32_t, scheduler->order) = i;
+        }
+    }
+
+    uint32_t nThreads = scheduler->order.length < FF_SCHEDULER_MAX_THREADS ? scheduler->order.length : FF_SCHEDULER_MAX_THREADS;
+    FFThreadType threads[FF_SCHEDULER_MAX_THREADS];
+    uint32_t nCreated = 0;
+    for (uint32_t i = 0; i < nThreads; ++i) {
+        FFThreadType thread = ffThreadCreate(workerMainThreadMain, scheduler);
+        if (!thread) {
+            break;
+        }
+        threads[nCreated++] = thread;
+    }
+
+    if (nCreated == 0) {
+        // Failed to create any thread, run the jobs in the calling thread
+        workerMain(scheduler);
+    }
+    for (uint32_t i = 0; i < nCreated; ++i) {
+        ffThreadJoin(threads[i], 0);
+    }
+
+    // Trailing jobs replayed from an earlier frame are not flushed by any worker
+    ffOutputLock();
+    flushFinishedJobs(scheduler);
+    ffOutputUnlock();
+#endif
+
+    scheduler->lastSucceeded = FF_LIST_LAST(FFModuleJob, scheduler->jobs)->succeeded;
+
+    FF_LIST_FOR_EACH (FFModuleJob, job, scheduler->jobs) {
+        if (job->invariant) {
+            ffFrameSetModuleOutput(job->moduleIndex, &job->capture, job->succeeded);
+        }
+        free(job->options);
+        ffOutputCaptureDestroy(&job->capture);
+    }
+    scheduler->jobs.length = 0;
+    scheduler->nextJob = 0;
+    scheduler->nextFlush = 0;
+
+    return scheduler->lastSucceeded;
+}
+
+void ffSchedulerDestroy(FFScheduler* scheduler) {
+    ffSchedulerRun(scheduler);
+    ffListDestroy(&scheduler->jobs);
+    ffListDestroy(&scheduler->order);
+}
@@ -0,0 +1,241 @@
+#include "common/sensors.h"
+#include "common/io.h"
+#include "common/stringUtils.h"
+#include "common/thread.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static struct {
+    FFlist sensors;     // FFSensor
+    FFSensor** devices; // Open addressing hash table of the first sensor of each parent device
+    uint32_t devicesMask;
+    FFSensor* classes[FF_SENSOR_CLASS_COUNT];
+    bool initialized;
+} registry;
+
+static FFThreadMutex registryMutex = FF_THREAD_MUTEX_INITIALIZER;
+
+// FNV-1a
+static uint32_t hashPath(const char* path) {
+    uint32_t hash = 2166136261u;
+    for (; *path; ++path) {
+        hash = (hash ^ (uint8_t) *path) * 16777619u;
+    }
+    return hash;
+}
+
+static FFSensorClass classifyHwmon(const FFstrbuf* name, int dfd) {
+    // https://www.kernel.org/doc/Documentation/hwmon/sysfs-interface
+    if (ffStrbufContainS(name, "cpu")
+#if __x86_64__ || __i386__
+        || ffStrbufEqualS(name, "k10temp")      // AMD
+        || ffStrbufEqualS(name, "fam15h_power") // AMD
+        || ffStrbufEqualS(name, "coretemp")     // Intel
+#endif
+    ) {
+        return FF_SENSOR_CLASS_CPU;
+    }
+
+    if (ffStrbufEqualS(name, "nvme") || ffStrbufEqualS(name, "drivetemp")) {
+        return FF_SENSOR_CLASS_DISK;
+    }
+
+    char pciClass[16];
+    ssize_t length = ffReadFileDataRelative(dfd, "device/class", ARRAY_SIZE(pciClass), pciClass);
+    if (length >= 4 && memcmp(pciClass, "0x03", 4) == 0) { // PCI_BASE_CLASS_DISPLAY
+        return FF_SENSOR_CLASS_GPU;
+    }
+
+    return FF_SENSOR_CLASS_UNKNOWN;
+}
+
+static FFSensorClass classifyThermalZone(const FFstrbuf* type) {
+    if (ffStrbufStartsWithS(type, "cpu") ||
+        ffStrbufStartsWithS(type, "soc")
+#if __x86_64__ || __i386__
+        || ffStrbufEqualS(type, "x86_pkg_temp")
+#endif
+    ) {
+        return FF_SENSOR_CLASS_CPU;
+    }
+
+    if (ffStrbufStartsWithS(type, "gpu")) {
+        return FF_SENSOR_CLASS_GPU;
+    }
+
+    return FF_SENSOR_CLASS_UNKNOWN;
+}
+
+static void addSensors(const char* classDir, bool thermalZone, FFstrbuf* buffer) {
+    FF_AUTO_CLOSE_DIR DIR* dirp = ffOpenDir(classDir);
+    if (!dirp) {
+        return;
+    }
+
+    int dfd = dirfd(dirp);
+    struct dirent* entry;
+    while ((entry = readdir(dirp)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        if (thermalZone && !ffStrStartsWith(entry->d_name, "thermal_zone")) {
+            continue; // cooling_device*
+        }
+
+        FF_AUTO_CLOSE_FD int subfd = openat(dfd, entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (subfd < 0 || !ffReadFileBufferRelative(subfd, thermalZone ? "type" : "name", buffer)) {
+            continue;
+        }
+        ffStrbufTrimRightSpace(buffer);
+
+        FFSensor* sensor = FF_LIST_ADD(FFSensor, registry.sensors);
+        *sensor = (FFSensor) {
+            .sensorClass = thermalZone ? classifyThermalZone(buffer) : classifyHwmon(buffer, subfd),
+            .thermalZone = thermalZone,
+            .fds = { -1, -1, -1, -1 },
+        };
+        ffStrbufInitCopy(&sensor->name, buffer);
+        ffStrbufInitS(&sensor->path, classDir);
+        ffStrbufAppendS(&sensor->path, entry->d_name);
+        ffStrbufAppendC(&sensor->path, '/');
+        ffStrbufInit(&sensor->devicePath);
+
+        if (!thermalZone) {
+            ffStrbufSet(buffer, &sensor->path);
+            ffStrbufAppendS(buffer, "device");
+            FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+            char resolved[PATH_MAX];
+            if (realpath(ffIoResolvePath(buffer->chars, false, &rooted), resolved)) {
+                ffStrbufSetS(&sensor->devicePath, resolved);
+            }
+        }
+    }
+}
+
+static void addDevice(FFSensor* sensor) {
+    for (uint32_t i = hashPath(sensor->devicePath.chars);; ++i) {
+        FFSensor** slot = &registry.devices[i & registry.devicesMask];
+        if (*slot == NULL) {
+            *slot = sensor;
+            return;
+        }
+        if (ffStrbufEqual(&(*slot)->devicePath, &sensor->devicePath)) {
+            FFSensor* last = *slot;
+            while (last->nextOfDevice) {
+                last = last->nextOfDevice;
+            }
+            last->nextOfDevice = sensor;
+            return;
+        }
+    }
+}
+
+static void initRegistry(void) {
+    ffThreadMutexLock(&registryMutex);
+    if (!registry.initialized) {
+        ffListInit(&registry.sensors);
+
+        FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreate();
+        addSensors("/sys/class/hwmon/", false, &buffer);
+        addSensors("/sys/class/thermal/", true, &buffer);
+
+        // Sensors are linked only now, as adding them may move the list
+        uint32_t size = 8;
+        while (size < registry.sensors.length * 2) {
+            size <<= 1;
+        }
+        registry.devices = calloc(size, sizeof(*registry.devices));
+        registry.devicesMask = size - 1;
+
+        FFSensor* lastOfClass[FF_SENSOR_CLASS_COUNT] = {};
+        FF_LIST_FOR_EACH (FFSensor, sensor, registry.sensors) {
+            if (sensor->devicePath.length > 0) {
+                addDevice(sensor);
+            }
+
+            if (lastOfClass[sensor->sensorClass]) {
+                lastOfClass[sensor->sensorClass]->nextOfClass = sensor;
+            } else {
+                registry.classes[sensor->sensorClass] = sensor;
+            }
+            lastOfClass[sensor->sensorClass] = sensor;
+        }
+
+        registry.initialized = true;
+    }
+    ffThreadMutexUnlock(&registryMutex);
+}
+
+FFSensor* ffSensorsFindByClass(FFSensorClass sensorClass) {
+    initRegistry();
+    return registry.classes[sensorClass];
+}
+
+FFSensor* ffSensorsFindByDevice(const char* devicePath) {
+    initRegistry();
+    if (registry.sensors.length == 0) {
+        return NULL;
+    }
+
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    char resolved[PATH_MAX];
+    if (!realpath(ffIoResolvePath(devicePath, false, &rooted), resolved)) {
+        return NULL;
+    }
+
+    for (uint32_t i = hashPath(resolved);; ++i) {
+        FFSensor* sensor = registry.devices[i & registry.devicesMask];
+        if (sensor == NULL || ffStrbufEqualS(&sensor->devicePath, resolved)) {
+            return sensor;
+        }
+    }
+}
+
+static int getTempFd(FFSensor* sensor, uint8_t channel) {
+    uint8_t slot = sensor->thermalZone ? 0 : (uint8_t) (channel - 1);
+    if (slot >= FF_SENSOR_MAX_CHANNELS) {
+        return -1;
+    }
+
+    ffThreadMutexLock(&registryMutex);
+    if (!(sensor->opened & (1 << slot))) {
+        FF_STRBUF_AUTO_DESTROY path = ffStrbufCreateCopy(&sensor->path);
+        if (sensor->thermalZone) {
+            ffStrbufAppendS(&path, "temp");
+        } else {
+            ffStrbufAppendF(&path, "temp%u_input", (unsigned) channel);
+        }
+
+        FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+        sensor->fds[slot] = open(ffIoResolvePath(path.chars, false, &rooted), O_RDONLY | O_CLOEXEC);
+        sensor->opened |= (uint8_t) (1 << slot);
+    }
+    int fd = sensor->fds[slot];
+    ffThreadMutexUnlock(&registryMutex);
+    return fd;
+}
+
+double ffSensorReadTemp(FFSensor* sensor, uint8_t channel) {
+    int fd = getTempFd(sensor, channel);
+    if (fd < 0) {
+        return FF_SENSOR_TEMP_UNSET;
+    }
+
+    // sysfs regenerates the value when read from offset 0
+    char buffer[32];
+    ssize_t length = pread(fd, buffer, ARRAY_SIZE(buffer) - 1, 0);
+    if (length <= 0) {
+        return FF_SENSOR_TEMP_UNSET;
+    }
+    buffer[length] = '\0';
+
+    char* end;
+    double value = strtod(buffer, &end); // millidegree Celsius
+    if (end == buffer) {
+        return FF_SENSOR_TEMP_UNSET;
+    }
+    return value / 1000.;
+}
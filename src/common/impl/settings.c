@@ -52,7 +52,7 @@ typedef struct GSettingsData {
     bool inited;
 } GSettingsData;
 
-static const GSettingsData* getGSettingsData(void) {
+static const GSettingsData* loadGSettingsData(void) {
     static GSettingsData data;
 
     if (!data.inited) {
@@ -83,6 +83,14 @@ static const GSettingsData* getGSettingsData(void) {
     return &data;
 }
 
+static const GSettingsData* getGSettingsData(void) {
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
+    const GSettingsData* data = loadGSettingsData();
+    ffThreadMutexUnlock(&mutex);
+    return data;
+}
+
 FFvariant ffSettingsGetGSettings(const char* schemaName, const char* path, const char* key, FFvarianttype type) {
     const GSettingsData* data = getGSettingsData();
     if (data == NULL) {
@@ -135,7 +143,7 @@ typedef struct DConfData {
     bool inited;
 } DConfData;
 
-static const DConfData* getDConfData(void) {
+static const DConfData* loadDConfData(void) {
     static DConfData data;
 
     if (!data.inited) {
@@ -161,6 +169,14 @@ static const DConfData* getDConfData(void) {
     return &data;
 }
 
+static const DConfData* getDConfData(void) {
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
+    const DConfData* data = loadDConfData();
+    ffThreadMutexUnlock(&mutex);
+    return data;
+}
+
 FFvariant ffSettingsGetDConf(const char* key, FFvarianttype type) {
     const DConfData* data = getDConfData();
     if (data == NULL) {
@@ -356,7 +372,7 @@ typedef struct SQLiteData {
     bool inited;
 } SQLiteData;
 
-static const SQLiteData* getSQLiteData(void) {
+static const SQLiteData* loadSQLiteData(void) {
     static SQLiteData data;
 
     if (!data.inited) {
@@ -380,6 +396,14 @@ static const SQLiteData* getSQLiteData(void) {
     return &data;
 }
 
+static const SQLiteData* getSQLiteData(void) {
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
+    const SQLiteData* data = loadSQLiteData();
+    ffThreadMutexUnlock(&mutex);
+    return data;
+}
+
 int ffSettingsGetSQLite3Int(const char* dbPath, const char* query) {
     if (!ffPathExists(dbPath, FF_PATHTYPE_FILE)) {
         return 0;
@@ -2,6 +2,7 @@
 #include "common/io.h"
 #include "common/mallocHelper.h"
 #include "common/debug.h"
+#include "common/thread.h"
 
 bool ffIsSmbiosValueSet(FFstrbuf* value) {
     ffStrbufTrimRightSpace(value);
@@ -659,7 +660,7 @@ static bool fillTableBufferPlatform(FFstrbuf* buffer) {
 }
     #endif
 
-const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable() {
+static const FFSmbiosHeaderTable* getSmbiosHeaderTable() {
     static FFstrbuf buffer;
     if (!smbiosTableInitialized) {
         smbiosTableInitialized = true;
@@ -701,7 +702,7 @@ typedef struct FFRawSmbiosData {
     uint8_t SMBIOSTableData[];
 } FFRawSmbiosData;
 
-const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable() {
+static const FFSmbiosHeaderTable* getSmbiosHeaderTable() {
     static SYSTEM_FIRMWARE_TABLE_INFORMATION* buffer;
 
     if (!smbiosTableInitialized) {
@@ -760,7 +761,7 @@ const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable() {
 #elif defined(__APPLE__)
     #include "common/apple/cf_helpers.h"
 
-const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable() {
+static const FFSmbiosHeaderTable* getSmbiosHeaderTable() {
     static CFDataRef smbiosDataBuffer;
 
     if (!smbiosTableInitialized) {
@@ -803,3 +804,11 @@ const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable() {
     return &smbiosTable;
 }
 #endif
+
+const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable() {
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
+    const FFSmbiosHeaderTable* result = getSmbiosHeaderTable();
+    ffThreadMutexUnlock(&mutex);
+    return result;
+}
@@ -0,0 +1,79 @@
+#include "common/sysfs.h"
+#include "common/io.h"
+#include "common/trace.h"
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// sysfs attributes are limited to one page
+#define FF_SYSFS_ATTR_MAX 4096
+
+int ffSysfsOpenDir(const char* path) {
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    return open(ffIoResolvePath(path, false, &rooted), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+static bool readAttr(int dfd, const char* name, FFstrbuf* buffer) {
+    FF_TRACE_SCOPE("io", "read", name);
+    ffIoResolveRelative(dfd, name);
+    FF_AUTO_CLOSE_FD int fd = openat(dfd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    // fstat reports a size of 4096 for all attributes, and the whole value is returned by the first read.
+    // Only a value filling the buffer can have more to read
+    while (true) {
+        ffStrbufEnsureFree(buffer, FF_SYSFS_ATTR_MAX);
+        uint32_t available = ffStrbufGetFree(buffer);
+        ssize_t bytesRead = read(fd, buffer->chars + buffer->length, available);
+        if (bytesRead <= 0) {
+            break;
+        }
+        buffer->length += (uint32_t) bytesRead;
+        if ((uint32_t) bytesRead < available) {
+            break;
+        }
+    }
+    return true;
+}
+
+uint32_t ffSysfsReadAttrs(int dfd, uint32_t count, FFSysfsAttr attrs[], FFstrbuf* buffer) {
+    ffStrbufClear(buffer);
+
+    uint32_t found = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        FFSysfsAttr* attr = &attrs[i];
+        attr->offset = buffer->length;
+        attr->length = 0;
+
+        if (dfd < 0 || !readAttr(dfd, attr->name, buffer)) {
+            buffer->length = attr->offset;
+        } else {
+            while (buffer->length > attr->offset && isspace((unsigned char) buffer->chars[buffer->length - 1])) {
+                --buffer->length;
+            }
+            attr->length = buffer->length - attr->offset;
+            if (attr->length > 0) {
+                ++found;
+            }
+        }
+
+        ffStrbufAppendC(buffer, '\0');
+    }
+
+    return found;
+}
+
+uint64_t ffSysfsAttrToUInt(const FFSysfsAttr* attr, const FFstrbuf* buffer, uint64_t defaultValue) {
+    const char* value = ffSysfsAttrValue(attr, buffer);
+    if (!value) {
+        return defaultValue;
+    }
+
+    char* end;
+    unsigned long long result = strtoull(value, &end, 10);
+    return end == value ? defaultValue : (uint64_t) result;
+}
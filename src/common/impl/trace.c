@@ -0,0 +1,151 @@
+#include "common/trace.h"
+#include "common/io.h"
+#include "common/thread.h"
+#include "fastfetch.h"
+
+#include <stdlib.h>
+
+typedef struct FFTraceEvent {
+    const char* category;
+    const char* name;
+    char* detail;
+    double start;
+    double end;
+    uint32_t tid;
+} FFTraceEvent;
+
+bool ffTraceEnabled = false;
+
+static FFstrbuf tracePath;
+static double traceStart;
+static FFlist traceEvents; // FFTraceEvent
+static uint32_t traceNextTid = 1;
+static _Thread_local uint32_t traceTid;
+static _Thread_local FFTraceSpan moduleSpan; // Of the module running on this thread
+static _Thread_local bool modulePrinting;
+
+#ifdef FF_HAVE_THREADS
+static FFThreadMutex traceMutex = FF_THREAD_MUTEX_INITIALIZER;
+#endif
+
+static double toMicroseconds(double tick) {
+    return (tick - traceStart) * 1000.;
+}
+
+static void writeTrace(void) {
+#ifdef FF_HAVE_THREADS
+    ffThreadMutexLock(&traceMutex);
+#endif
+    ffTraceEnabled = false;
+#ifdef FF_HAVE_THREADS
+    ffThreadMutexUnlock(&traceMutex);
+#endif
+
+    yyjson_mut_doc* doc = yyjson_mut_doc_new(NULL);
+    yyjson_mut_val* root = yyjson_mut_obj(doc);
+    yyjson_mut_doc_set_root(doc, root);
+    yyjson_mut_obj_add_str(doc, root, "displayTimeUnit", "ms");
+    yyjson_mut_val* events = yyjson_mut_obj_add_arr(doc, root, "traceEvents");
+
+    yyjson_mut_val* mainThread = yyjson_mut_arr_add_obj(doc, events);
+    yyjson_mut_obj_add_str(doc, mainThread, "name", "thread_name");
+    yyjson_mut_obj_add_str(doc, mainThread, "ph", "M");
+    yyjson_mut_obj_add_uint(doc, mainThread, "pid", instance.state.platform.pid);
+    yyjson_mut_obj_add_uint(doc, mainThread, "tid", 1);
+    yyjson_mut_obj_add_str(doc, yyjson_mut_obj_add_obj(doc, mainThread, "args"), "name", "main");
+
+    FF_LIST_FOR_EACH (FFTraceEvent, event, traceEvents) {
+        yyjson_mut_val* obj = yyjson_mut_arr_add_obj(doc, events);
+        yyjson_mut_obj_add_str(doc, obj, "name", event->name);
+        yyjson_mut_obj_add_str(doc, obj, "cat", event->category);
+        yyjson_mut_obj_add_str(doc, obj, "ph", "X");
+        yyjson_mut_obj_add_real(doc, obj, "ts", toMicroseconds(event->start));
+        yyjson_mut_obj_add_real(doc, obj, "dur", (event->end - event->start) * 1000.);
+        yyjson_mut_obj_add_uint(doc, obj, "pid", instance.state.platform.pid);
+        yyjson_mut_obj_add_uint(doc, obj, "tid", event->tid);
+        if (event->detail) {
+            yyjson_mut_val* args = yyjson_mut_obj_add_obj(doc, obj, "args");
+            yyjson_mut_obj_add_strcpy(doc, args, "detail", event->detail);
+        }
+    }
+
+    size_t len;
+    char* str = yyjson_mut_write(doc, YYJSON_WRITE_INF_AND_NAN_AS_NULL, &len);
+    if (!str || !ffWriteFileData(tracePath.chars, len, str)) {
+        fprintf(stderr, "Error: failed to write trace file `%s`\n", tracePath.chars);
+    }
+    free(str);
+    yyjson_mut_doc_free(doc);
+
+    FF_LIST_FOR_EACH (FFTraceEvent, event, traceEvents) {
+        free(event->detail);
+    }
+    ffListDestroy(&traceEvents);
+    ffStrbufDestroy(&tracePath);
+}
+
+void ffTraceStart(const char* path) {
+    if (ffTraceEnabled) {
+        ffStrbufSetS(&tracePath, path);
+        return;
+    }
+
+    ffStrbufInitS(&tracePath, path);
+    ffListInitA(&traceEvents, sizeof(FFTraceEvent), 256);
+    traceStart = ffTimeGetTick();
+    traceTid = traceNextTid++; // Main thread
+    ffTraceEnabled = true;
+
+    // Also called when fastfetch is interrupted, e.g. with `--dynamic-interval`
+    atexit(writeTrace);
+}
+
+void ffTraceAddSpan(const FFTraceSpan* span, double end) {
+    if (traceTid == 0) {
+        traceTid = __atomic_fetch_add(&traceNextTid, 1, __ATOMIC_RELAXED);
+    }
+
+    char* detail = span->detail ? strdup(span->detail) : NULL;
+
+#ifdef FF_HAVE_THREADS
+    ffThreadMutexLock(&traceMutex);
+#endif
+    if (ffTraceEnabled) {
+        *FF_LIST_ADD(FFTraceEvent, traceEvents) = (FFTraceEvent) {
+            .category = span->category,
+            .name = span->name,
+            .detail = detail,
+            .start = span->start,
+            .end = end,
+            .tid = traceTid,
+        };
+        detail = NULL;
+    }
+#ifdef FF_HAVE_THREADS
+    ffThreadMutexUnlock(&traceMutex);
+#endif
+
+    free(detail);
+}
+
+void ffTraceModuleBegin(const char* name) {
+    moduleSpan = ffTraceSpanBegin("detect", name, NULL);
+    modulePrinting = false;
+}
+
+void ffTraceModulePrintImpl(void) {
+    if (moduleSpan.start == 0 || modulePrinting) {
+        return;
+    }
+
+    double now = ffTimeGetTick();
+    ffTraceAddSpan(&moduleSpan, now);
+    moduleSpan.category = "print";
+    moduleSpan.start = now;
+    modulePrinting = true;
+}
+
+void ffTraceModuleEnd(void) {
+    ffTraceSpanEnd(&moduleSpan);
+    moduleSpan.start = 0;
+}
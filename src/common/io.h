@@ -2,6 +2,7 @@
 
 #include "common/FFstrbuf.h"
 #include "common/FFlist.h"
+#include "common/trace.h"
 
 #ifdef _WIN32
     #include <fileapi.h>
@@ -40,6 +41,29 @@ HANDLE openat(HANDLE dfd, const char* fileName, int oflag);
 HANDLE openatW(HANDLE dfd, const wchar_t* fileName, uint16_t fileNameLen, bool directory);
 #endif
 
+// Used by `fastfetch-bench` to run detectors against a snapshot of another machine.
+// Absolute paths read through the helpers below, `ffOpenDir` and `ffParsePropFile*` are prefixed with `ffIoRootPrefix`,
+// or appended to `ffIoRecordedPaths` while a snapshot is taken. Recorded directories end with '/'
+extern FFstrbuf ffIoRootPrefix;
+extern FFlist* ffIoRecordedPaths; // FFstrbuf
+
+const char* ffIoHookPath(const char* path, bool listDir, FFstrbuf* buffer);
+void ffIoHookRelative(FFNativeFD dfd, const char* fileName);
+
+// Returns `path`, or the prefixed path stored in `buffer`. `listDir`: entries of the directory are recorded too
+static inline const char* ffIoResolvePath(const char* path, bool listDir, FFstrbuf* buffer) {
+    if (__builtin_expect(ffIoRootPrefix.length == 0 && ffIoRecordedPaths == NULL, true)) {
+        return path;
+    }
+    return ffIoHookPath(path, listDir, buffer);
+}
+
+static inline void ffIoResolveRelative(FFNativeFD dfd, const char* fileName) {
+    if (__builtin_expect(ffIoRecordedPaths != NULL, false)) {
+        ffIoHookRelative(dfd, fileName);
+    }
+}
+
 static inline bool ffIsValidNativeFD(FFNativeFD fd) {
 #ifndef _WIN32
     return fd >= 0;
@@ -109,6 +133,9 @@ FF_A_NONNULL(3) static inline ssize_t ffReadFDData(FFNativeFD fd, size_t dataSiz
 FF_A_NONNULL(2) bool ffAppendFDBuffer(FFNativeFD fd, FFstrbuf* buffer);
 
 FF_A_NONNULL(1, 3) static inline ssize_t ffReadFileData(const char* fileName, size_t dataSize, void* data) {
+    FF_TRACE_SCOPE("io", "read", fileName);
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    fileName = ffIoResolvePath(fileName, false, &rooted);
     FFNativeFD FF_AUTO_CLOSE_FD fd =
 #ifndef _WIN32
         open(fileName, O_RDONLY | O_CLOEXEC);
@@ -124,6 +151,8 @@ FF_A_NONNULL(1, 3) static inline ssize_t ffReadFileData(const char* fileName, si
 }
 
 FF_A_NONNULL(2, 4) static inline ssize_t ffReadFileDataRelative(FFNativeFD dfd, const char* fileName, size_t dataSize, void* data) {
+    FF_TRACE_SCOPE("io", "read", fileName);
+    ffIoResolveRelative(dfd, fileName);
     FFNativeFD FF_AUTO_CLOSE_FD fd = openat(dfd, fileName, O_RDONLY | O_CLOEXEC);
     if (!ffIsValidNativeFD(fd)) {
         return -1;
@@ -133,6 +162,9 @@ FF_A_NONNULL(2, 4) static inline ssize_t ffReadFileDataRelative(FFNativeFD dfd,
 }
 
 FF_A_NONNULL(1, 2) static inline bool ffAppendFileBuffer(const char* fileName, FFstrbuf* buffer) {
+    FF_TRACE_SCOPE("io", "read", fileName);
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    fileName = ffIoResolvePath(fileName, false, &rooted);
     FFNativeFD FF_AUTO_CLOSE_FD fd =
 #ifndef _WIN32
         open(fileName, O_RDONLY | O_CLOEXEC);
@@ -148,6 +180,8 @@ FF_A_NONNULL(1, 2) static inline bool ffAppendFileBuffer(const char* fileName, F
 }
 
 FF_A_NONNULL(2, 3) static inline bool ffAppendFileBufferRelative(FFNativeFD dfd, const char* fileName, FFstrbuf* buffer) {
+    FF_TRACE_SCOPE("io", "read", fileName);
+    ffIoResolveRelative(dfd, fileName);
     FFNativeFD FF_AUTO_CLOSE_FD fd = openat(dfd, fileName, O_RDONLY | O_CLOEXEC);
     if (!ffIsValidNativeFD(fd)) {
         return false;
@@ -202,6 +236,9 @@ FF_A_NONNULL(1) static inline bool ffPathExists(const char* path, FFPathType pat
 
 #else
 
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    path = ffIoResolvePath(path, false, &rooted);
+
     if (pathType == FF_PATHTYPE_ANY) {
         // Zero overhead
         return access(path, F_OK) == 0;
@@ -235,7 +272,8 @@ FF_A_SCANF(3, 4)
 FF_A_NONNULL(1, 3)
 const char* ffGetTerminalResponse(const char* request, int nParams, const char* format, ...);
 
-// Not thread safe!
+// Redirects stdout and stderr of the whole process to /dev/null. Only for modules flagged `FFModuleBaseInfo::serialized`.
+// Must be paired: `ffSuppressIO(false)` must only be called after `ffSuppressIO(true)` succeeded
 bool ffSuppressIO(bool suppress);
 
 static inline void ffUnsuppressIO(bool* suppressed) {
@@ -282,6 +320,14 @@ static inline bool wrapClosedir(HANDLE* pdir) {
 #endif
 #define FF_AUTO_CLOSE_DIR FF_A_CLEANUP(wrapClosedir)
 
+#ifndef _WIN32
+// `opendir` that honors `ffIoRootPrefix`
+FF_A_NONNULL(1) static inline DIR* ffOpenDir(const char* path) {
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    return opendir(ffIoResolvePath(path, true, &rooted));
+}
+#endif
+
 FF_A_NONNULL(1, 2, 3) static inline bool ffSearchUserConfigFile(const FFlist* configDirs, const char* fileSubpath, FFstrbuf* result) {
     // configDirs is a list of FFstrbufs include the trailing slash
     FF_LIST_FOR_EACH (FFstrbuf, dir, *configDirs) {
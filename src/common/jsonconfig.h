@@ -24,4 +24,7 @@ yyjson_api_inline bool yyjson_mut_arr_add_strbuf(yyjson_mut_doc* doc,
 }
 
 void ffPrintJsonConfig(FFdata* data, bool prepare);
+// Takes the first samples of CPUUsage, DiskIO and NetIO as soon as the config is loaded,
+// so that their time window already runs while the rest of the config is parsed
+void ffPrepareJsonConfigSampling(FFdata* data);
 void ffJsonConfigGenerateModuleArgsConfig(yyjson_mut_doc* doc, yyjson_mut_val* module, FFModuleArgs* moduleArgs);
@@ -33,6 +33,9 @@ typedef struct FFModuleBaseInfo {
     bool (*printModule)(void* options);                                                                   // true on success
     bool (*generateJsonResult)(void* options, struct yyjson_mut_doc* doc, struct yyjson_mut_val* module); // true on success
     void (*generateJsonConfig)(void* options, struct yyjson_mut_doc* doc, struct yyjson_mut_val* obj);
+    bool (*isInvariant)(void* options); // Optional. true if the printed result can't change while fastfetch is running
+    bool (*isSampling)(void* options);  // Optional. true if detection waits for a time window that started when the config was loaded
+    bool serialized;                    // Not thread safe (e.g. uses Xlib or suppresses IO). Never detected while another module is
     FFModuleFormatArgList formatArgs;
 } FFModuleBaseInfo;
 
@@ -76,6 +79,16 @@ static inline void ffOptionParseColor(const char* value, FFstrbuf* buffer) {
     ffOptionParseColorNoClear(value, buffer);
 }
 
+// For `FFModuleBaseInfo::isInvariant` of modules that always print the same result
+static inline bool ffOptionIsInvariant(FF_A_UNUSED void* options) {
+    return true;
+}
+
+// For `FFModuleBaseInfo::isSampling` of modules that always wait
+static inline bool ffOptionIsSampling(FF_A_UNUSED void* options) {
+    return true;
+}
+
 static inline void ffOptionInitModuleArg(FFModuleArgs* args, const char* icon) {
     ffStrbufInit(&args->key);
     ffStrbufInit(&args->keyColor);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "fastfetch.h"
+#include "common/FFstrbuf.h"
+#include "common/FFlist.h"
+
+#include <stdarg.h>
+#include <string.h>
+
+// Module output is written through these functions instead of stdio directly,
+// so that it can be captured per thread when modules are detected in parallel.
+// Uncaptured output is buffered until `ffOutputFlush`, unless `display.noBuffer` is set
+typedef struct FFOutputCapture {
+    FFstrbuf buffer;
+    FFlist logoLines; // uint32_t: offsets in `buffer` where a logo line must be printed
+} FFOutputCapture;
+
+void ffOutputWrite(const char* data, uint32_t length);
+FF_A_PRINTF(1, 2) void ffOutputWriteF(const char* format, ...);
+void ffOutputWriteVF(const char* format, va_list arguments);
+
+static inline void ffOutputWriteS(const char* str) {
+    ffOutputWrite(str, (uint32_t) strlen(str));
+}
+
+static inline void ffOutputWriteC(char c) {
+    ffOutputWrite(&c, 1);
+}
+
+// Same as `ffOutputWriteS`, but appends a new line
+static inline void ffOutputPutS(const char* str) {
+    ffOutputWriteS(str);
+    ffOutputWriteC('\n');
+}
+
+static inline void ffOutputWriteStrbuf(const FFstrbuf* strbuf) {
+    ffOutputWrite(strbuf->chars, strbuf->length);
+}
+
+// Same as `ffOutputWriteStrbuf`, but appends a new line
+static inline void ffOutputPutStrbuf(const FFstrbuf* strbuf) {
+    ffOutputWriteStrbuf(strbuf);
+    ffOutputWriteC('\n');
+}
+
+static inline void ffOutputCaptureInit(FFOutputCapture* capture) {
+    ffStrbufInit(&capture->buffer);
+    ffListInit(&capture->logoLines);
+}
+
+static inline void ffOutputCaptureDestroy(FFOutputCapture* capture) {
+    ffStrbufDestroy(&capture->buffer);
+    ffListDestroy(&capture->logoLines);
+}
+
+// Writes buffered output to stdout with as few syscalls as possible. Called once per chunk of ordered output.
+// Must be called with the output lock held if modules are printed in parallel
+void ffOutputFlush(void);
+
+// Redirects all output of the calling thread into `capture`. NULL restores stdout
+// Returns the previous capture
+FFOutputCapture* ffOutputSetCapture(FFOutputCapture* capture);
+
+// Redirects output of all threads that are not captured themselves into `capture`. NULL restores stdout.
+// Logo lines are printed immediately, so they are never deferred into a global capture
+void ffOutputSetGlobalCapture(FFOutputCapture* capture);
+
+// Records the position of a logo line if the calling thread is captured.
+// Logo lines must be printed in order, so they are deferred until the capture is replayed
+bool ffOutputDeferLogoLine(void);
+
+// Serializes writes to the real stdout between threads
+void ffOutputLock(void);
+void ffOutputUnlock(void);
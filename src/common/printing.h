@@ -2,6 +2,7 @@
 
 #include "fastfetch.h"
 #include "common/format.h"
+#include "common/output.h"
 
 typedef enum FF_A_PACKED FFPrintType {
     FF_PRINT_TYPE_DEFAULT = 0,
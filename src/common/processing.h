@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/FFstrbuf.h"
+#include "common/FFlist.h"
 
 #ifndef _WIN32
     #include <sys/types.h> // pid_t
@@ -47,9 +48,96 @@ static inline const char* ffProcessAppendStdErr(FFstrbuf* buffer, char* const ar
     return error;
 }
 
+typedef struct FFProcessJob {
+    FFProcessHandle handle;
+    FFstrbuf output; // Trailing spaces are trimmed if succeeded
+    const char* error;
+    bool finished;
+} FFProcessJob;
+
+// Runs many child processes concurrently, and reads their outputs in a single poll loop.
+// A process is spawned as soon as it's added, so it can be added early and waited for later.
+// Not thread safe
+typedef struct FFProcessReactor {
+    FFlist jobs; // FFProcessJob*
+} FFProcessReactor;
+
+static inline void ffProcessReactorInit(FFProcessReactor* reactor) {
+    ffListInit(&reactor->jobs);
+}
+
+// Returned job is owned by the reactor, and valid until the reactor is destroyed
+static inline FFProcessJob* ffProcessReactorSpawn(FFProcessReactor* reactor, char* const argv[], bool useStdErr) {
+    FFProcessJob* job = (FFProcessJob*) malloc(sizeof(*job));
+    ffStrbufInit(&job->output);
+    job->error = ffProcessSpawn(argv, useStdErr, &job->handle);
+    job->finished = job->error != NULL;
+    *FF_LIST_ADD(FFProcessJob*, reactor->jobs) = job;
+    return job;
+}
+
+// Reads outputs of all running processes until `job` is finished, or until all are finished if `job` is NULL.
+// `processingTimeout` applies to the whole call
+void ffProcessReactorWait(FFProcessReactor* reactor, FFProcessJob* job);
+// Takes a job out of the reactor without freeing it, so that it can be added to and waited for in another one
+static inline void ffProcessReactorDetach(FFProcessReactor* reactor, FFProcessJob* job) {
+    for (uint32_t i = 0; i < reactor->jobs.length; ++i) {
+        if (*FF_LIST_GET(FFProcessJob*, reactor->jobs, i) == job) {
+            FFProcessJob** jobs = (FFProcessJob**) reactor->jobs.data;
+            memmove(&jobs[i], &jobs[i + 1], (reactor->jobs.length - i - 1) * sizeof(*jobs));
+            --reactor->jobs.length;
+            break;
+        }
+    }
+}
+// Frees a finished job before the reactor is destroyed
+static inline void ffProcessReactorRemove(FFProcessReactor* reactor, FFProcessJob* job) {
+    assert(job->finished);
+    ffProcessReactorDetach(reactor, job);
+    ffStrbufDestroy(&job->output);
+    free(job);
+}
+
+// Terminates unfinished processes
+void ffProcessReactorDestroy(FFProcessReactor* reactor);
+
+// Runs a single process in a reactor of its own, and appends its output to `buffer`
+static inline const char* ffProcessReactorAppendOutput(FFstrbuf* buffer, char* const argv[], bool useStdErr) {
+    FFProcessReactor reactor;
+    ffProcessReactorInit(&reactor);
+    FFProcessJob* job = ffProcessReactorSpawn(&reactor, argv, useStdErr);
+    ffProcessReactorWait(&reactor, job);
+    const char* error = job->error;
+    if (!error) {
+        ffStrbufAppend(buffer, &job->output);
+    }
+    ffProcessReactorDestroy(&reactor);
+    return error;
+}
+
 #ifdef _WIN32
 bool ffProcessGetInfoWindows(uint32_t pid, uint32_t* ppid, FFstrbuf* pname, FFstrbuf* exe, const char** exeName, FFstrbuf* exePath, bool* gui);
 #else
 void ffProcessGetInfoLinux(pid_t pid, FFstrbuf* processName, FFstrbuf* exe, const char** exeName, FFstrbuf* exePath);
 const char* ffProcessGetBasicInfoLinux(pid_t pid, FFstrbuf* name, pid_t* ppid, int32_t* tty);
 #endif
+
+#if defined(__linux__) || defined(__GNU__)
+// Snapshot of /proc shared by everything that looks at other processes in a run.
+// The two functions above answer from it, and remember the processes they had to read
+typedef struct FFProcessEntry {
+    pid_t pid;
+    pid_t ppid;
+    int32_t tty;
+    uint32_t uid;     // Owner of `/proc/<pid>`
+    FFstrbuf name;    // `comm`, truncated to 15 chars by Linux
+    FFstrbuf exe;     // Set by `ffProcessGetInfoLinux`
+    FFstrbuf exePath; // Set by `ffProcessGetInfoLinux` if requested
+} FFProcessEntry;
+
+// Reads all processes in a single pass over /proc the first time it's called.
+// The list is sorted by pid, and never changes afterwards. Returns NULL if /proc can't be listed
+const FFlist* ffProcessTableGetAll(void); // FFProcessEntry
+// Number of processes in the snapshot, or 0 if it hasn't been built
+uint32_t ffProcessTableGetCount(void);
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "fastfetch.h"
+#include "common/output.h"
+#include "common/option.h"
+
+typedef struct FFModuleJob {
+    FFModuleBaseInfo* baseInfo;
+    void* options; // FF_OPTION_MAX_SIZE bytes, initialized and parsed
+    FFOutputCapture capture;
+    uint32_t moduleIndex; // Index of the module in the frame
+    bool invariant;       // Output must be recorded for later frames
+    bool sampling;        // Waits for a time window, see `FFModuleBaseInfo::isSampling`
+    bool serialized;      // See `FFModuleBaseInfo::serialized`
+    bool succeeded;
+    bool finished;
+} FFModuleJob;
+
+// Prints modules in the order they are added.
+// In parallel mode, modules are detected in a pool of worker threads and their output is captured,
+// then written to stdout as soon as all earlier modules have finished.
+// Serialized modules are detected one after another on the calling thread before the workers start.
+// Sampling modules are picked up after all other modules, so that their time window overlaps with the detection of the others.
+// While a --dynamic-interval frame is rendered, invariant modules are only printed in the first frame and replayed later
+typedef struct FFScheduler {
+    FFlist jobs;        // FFModuleJob
+    FFlist order;       // uint32_t, indexes of `jobs` in the order workers pick them up
+    uint32_t nextJob;   // Index of the next job to be picked up by a worker
+    uint32_t nextFlush; // Index of the next job to be written to stdout
+    uint32_t nextModule; // Number of modules added so far
+    bool parallel;
+    bool lastSucceeded;
+} FFScheduler;
+
+void ffSchedulerInit(FFScheduler* scheduler);
+void ffSchedulerDestroy(FFScheduler* scheduler);
+
+// `module` can be NULL. Printed immediately if the scheduler is not parallel
+void ffSchedulerAdd(FFScheduler* scheduler, FFModuleBaseInfo* baseInfo, yyjson_val* module);
+// Waits until all added modules are printed. Returns whether the last module succeeded
+bool ffSchedulerRun(FFScheduler* scheduler);
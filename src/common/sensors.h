@@ -0,0 +1,39 @@
+#pragma once
+
+#include "fastfetch.h"
+
+#define FF_SENSOR_TEMP_UNSET (-DBL_MAX)
+#define FF_SENSOR_MAX_CHANNELS 4
+
+typedef enum FF_A_PACKED FFSensorClass {
+    FF_SENSOR_CLASS_UNKNOWN,
+    FF_SENSOR_CLASS_CPU,  // k10temp, coretemp, `cpu*` thermal zones, etc.
+    FF_SENSOR_CLASS_GPU,  // Parent is a PCI display controller, or `gpu*` thermal zones
+    FF_SENSOR_CLASS_DISK, // nvme, drivetemp
+    FF_SENSOR_CLASS_COUNT,
+} FFSensorClass;
+
+// A directory of /sys/class/hwmon or a thermal zone of /sys/class/thermal
+typedef struct FFSensor {
+    FFstrbuf path;       // e.g. `/sys/class/hwmon/hwmon3/`
+    FFstrbuf name;       // `name` of hwmon, or `type` of thermal zones
+    FFstrbuf devicePath; // Canonical path of the parent device. Empty for thermal zones
+    FFSensorClass sensorClass;
+    bool thermalZone;
+    struct FFSensor* nextOfDevice;
+    struct FFSensor* nextOfClass;
+    int fds[FF_SENSOR_MAX_CHANNELS]; // Opened on the first read. -1: not opened yet or missing
+    uint8_t opened;                  // Bit set of channels tried to open
+} FFSensor;
+
+// All sensors are enumerated and classified once, the first time any of the functions below is called.
+// The registry never changes afterwards, and is shared by all detectors of the run
+
+// Returns the first sensor of the class. Others are linked by `nextOfClass`. hwmon comes before thermal zones
+FFSensor* ffSensorsFindByClass(FFSensorClass sensorClass);
+// Returns the first sensor whose parent is `devicePath` (symlinks are resolved), e.g. `/sys/bus/pci/devices/0000:01:00.0`.
+// Others are linked by `nextOfDevice`
+FFSensor* ffSensorsFindByDevice(const char* devicePath);
+// Reads `temp<channel>_input` of hwmon, or `temp` of thermal zones, in Celsius.
+// The file is kept open, so repeated reads (`--dynamic-interval`) are a single pread
+double ffSensorReadTemp(FFSensor* sensor, uint8_t channel);
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "fastfetch.h"
+
+// An attribute of a sysfs directory, e.g. `revision` or `drm/card0/gt_max_freq_mhz`
+typedef struct FFSysfsAttr {
+    const char* name; // Relative to the directory
+    uint32_t offset;  // Set by `ffSysfsReadAttrs`. Start of the value in the buffer
+    uint32_t length;  // Set by `ffSysfsReadAttrs`. Trailing whitespace is trimmed. 0 if missing or empty
+} FFSysfsAttr;
+
+// Opens a sysfs directory (symlinks are followed) for `ffSysfsReadAttrs`. Returns -1 on failure
+int ffSysfsOpenDir(const char* path);
+
+// Reads all attributes of `attrs` through the directory fd `dfd`. Values are stored one after another in `buffer`,
+// each followed by '\0'. As sysfs attributes are at most one page, each one costs a single openat, read and close.
+// Returns the number of attributes found
+uint32_t ffSysfsReadAttrs(int dfd, uint32_t count, FFSysfsAttr attrs[], FFstrbuf* buffer);
+
+// Returns the value of an attribute read by `ffSysfsReadAttrs`, or NULL if it is missing or empty
+static inline const char* ffSysfsAttrValue(const FFSysfsAttr* attr, const FFstrbuf* buffer) {
+    return attr->length ? buffer->chars + attr->offset : NULL;
+}
+
+// Parses a decimal attribute. Returns `defaultValue` if missing or not a number
+uint64_t ffSysfsAttrToUInt(const FFSysfsAttr* attr, const FFstrbuf* buffer, uint64_t defaultValue);
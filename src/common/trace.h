@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common/attributes.h"
+#include "common/time.h"
+
+// Chrome Trace Event recording, enabled by `--trace <file>`.
+// Spans are recorded from all threads and written to the file on exit. Open it in https://ui.perfetto.dev or chrome://tracing
+typedef struct FFTraceSpan {
+    const char* category; // Must be a string literal
+    const char* name;     // Must be a string literal or a module name
+    const char* detail;   // Copied when the span ends. Can be NULL
+    double start;         // 0 if tracing is disabled
+} FFTraceSpan;
+
+extern bool ffTraceEnabled;
+
+void ffTraceStart(const char* path);
+void ffTraceAddSpan(const FFTraceSpan* span, double end);
+
+static inline FFTraceSpan ffTraceSpanBegin(const char* category, const char* name, const char* detail) {
+    return (FFTraceSpan) {
+        .category = category,
+        .name = name,
+        .detail = detail,
+        .start = __builtin_expect(ffTraceEnabled, false) ? ffTimeGetTick() : 0,
+    };
+}
+
+static inline void ffTraceSpanEnd(FFTraceSpan* span) {
+    if (__builtin_expect(span->start > 0, false)) {
+        ffTraceAddSpan(span, ffTimeGetTick());
+    }
+}
+
+// Spans of the module running on the current thread. Detection is recorded until the first output of the module,
+// which switches to printing (formatting included)
+void ffTraceModuleBegin(const char* name);
+void ffTraceModulePrintImpl(void);
+void ffTraceModuleEnd(void);
+
+static inline void ffTraceModulePrint(void) {
+    if (__builtin_expect(ffTraceEnabled, false)) {
+        ffTraceModulePrintImpl();
+    }
+}
+
+#define FF_TRACE_CONCAT_IMPL(a, b) a##b
+#define FF_TRACE_CONCAT(a, b) FF_TRACE_CONCAT_IMPL(a, b)
+
+// Records a span lasting until the end of the enclosing scope
+#define FF_TRACE_SCOPE(category, name, detail) \
+    FF_A_UNUSED FFTraceSpan FF_A_CLEANUP(ffTraceSpanEnd) FF_TRACE_CONCAT(ffTraceSpan, __LINE__) = ffTraceSpanBegin(category, name, detail)
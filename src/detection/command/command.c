@@ -1,28 +1,35 @@
 #include "detection/command/command.h"
 #include "common/processing.h"
 #include "common/FFstrbuf.h"
+#include "common/thread.h"
 
 typedef struct FFCommandResultBundle {
-    FFProcessHandle handle;
+    FFProcessJob* job;
     const char* error;
+    FFstrbuf text;
 } FFCommandResultBundle;
 
-// FIFO, non-thread-safe list of running commands
+// Commands prepared by `ffPrepareCommand`, running until their module takes them out to wait for them.
+// FIFO list of running commands. Modules may be printed from multiple threads,
+// so a command is matched by its text instead of being popped in config order
+static FFProcessReactor commandReactor;
 static FFlist commandQueue;
+static FFThreadMutex commandQueueMutex = FF_THREAD_MUTEX_INITIALIZER;
 
-static const char* spawnProcess(FFCommandOptions* options, FFProcessHandle* handle) {
+// Must be called with commandQueueMutex held if `reactor` is `commandReactor`
+static const char* spawnProcess(FFProcessReactor* reactor, FFCommandOptions* options, FFProcessJob** job) {
     if (options->text.length == 0) {
         return "No command text specified";
     }
 
-    return ffProcessSpawn(options->param.length ? (char* const[]) {
-                                                      options->shell.chars,
-                                                      options->param.chars,
-                                                      options->text.chars,
-                                                      NULL }
-                                                : (char* const[]) { options->shell.chars, options->text.chars, NULL },
-        options->useStdErr,
-        handle);
+    *job = ffProcessReactorSpawn(reactor, options->param.length ? (char* const[]) {
+                                                                              options->shell.chars,
+                                                                              options->param.chars,
+                                                                              options->text.chars,
+                                                                              NULL }
+                                                                        : (char* const[]) { options->shell.chars, options->text.chars, NULL },
+        options->useStdErr);
+    return NULL;
 }
 
 bool ffPrepareCommand(FFCommandOptions* options) {
@@ -30,29 +37,65 @@ bool ffPrepareCommand(FFCommandOptions* options) {
         return false;
     }
 
-    FFCommandResultBundle* bundle = FF_LIST_ADD(FFCommandResultBundle, commandQueue);
-    bundle->error = spawnProcess(options, &bundle->handle);
+    FFCommandResultBundle bundle = {};
+    ffStrbufInitCopy(&bundle.text, &options->text);
+
+    ffThreadMutexLock(&commandQueueMutex);
+    bundle.error = spawnProcess(&commandReactor, options, &bundle.job);
+    *FF_LIST_ADD(FFCommandResultBundle, commandQueue) = bundle;
+    ffThreadMutexUnlock(&commandQueueMutex);
 
     return true;
 }
 
+// Must be called with commandQueueMutex held
+static bool takeCommand(const FFstrbuf* text, FFCommandResultBundle* result) {
+    for (uint32_t i = 0; i < commandQueue.length; ++i) {
+        FFCommandResultBundle* bundle = FF_LIST_GET(FFCommandResultBundle, commandQueue, i);
+        if (ffStrbufEqual(&bundle->text, text)) {
+            *result = *bundle;
+            memmove(bundle, bundle + 1, (commandQueue.length - i - 1) * sizeof(*bundle));
+            --commandQueue.length;
+            return true;
+        }
+    }
+    return false;
+}
+
 const char* ffDetectCommand(FFCommandOptions* options, FFstrbuf* result) {
     FFCommandResultBundle bundle = {};
+    // Private to this call, so that the command is waited for without holding commandQueueMutex
+    FFProcessReactor reactor;
+    ffProcessReactorInit(&reactor);
+
     if (!options->parallel) {
-        bundle.error = spawnProcess(options, &bundle.handle);
-    } else if (!FF_LIST_SHIFT(commandQueue, &bundle)) {
-        return "[BUG] command queue is empty";
-    }
+        bundle.error = spawnProcess(&reactor, options, &bundle.job);
+    } else {
+        ffThreadMutexLock(&commandQueueMutex);
+        bool found = takeCommand(&options->text, &bundle);
+        if (found && bundle.job) {
+            ffProcessReactorDetach(&commandReactor, bundle.job);
+        }
+        ffThreadMutexUnlock(&commandQueueMutex);
 
-    if (bundle.error) {
-        return bundle.error;
+        if (!found) {
+            bundle.error = "[BUG] command queue is empty";
+        } else {
+            ffStrbufDestroy(&bundle.text);
+            if (bundle.job) {
+                *FF_LIST_ADD(FFProcessJob*, reactor.jobs) = bundle.job;
+            }
+        }
     }
 
-    bundle.error = ffProcessReadOutput(&bundle.handle, result);
-    if (bundle.error) {
-        return bundle.error;
+    if (bundle.job) {
+        ffProcessReactorWait(&reactor, bundle.job);
+        bundle.error = bundle.job->error;
+        if (!bundle.error) {
+            ffStrbufAppend(result, &bundle.job->output);
+        }
     }
+    ffProcessReactorDestroy(&reactor);
 
-    ffStrbufTrimRightSpace(result);
-    return NULL;
+    return bundle.error;
 }
@@ -1,8 +1,130 @@
 #include "cpu.h"
+#include "common/cache.h"
+
+#if defined(__linux__) || defined(__GNU__)
+    #include <sys/sysinfo.h>
+#elif defined(_WIN32)
+    #include <windows.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+    #include "common/sysctl.h"
+#endif
 
 const char* ffDetectCPUImpl(const FFCPUOptions* options, FFCPUResult* cpu);
 
+// 2: `coresOnline` is no longer stored
+#define FF_CPU_CACHE_VERSION 2
+
+static void initCacheKey(const FFCPUOptions* options, FFCache* cache) {
+    ffCacheKeyAddBootId(cache);
+    ffCacheKeyAddKernelRelease(cache);
+    ffCacheKeyAddS(cache, options->showPeCoreCount ? "pe" : "");
+}
+
+// Unlike everything else cached, the number of online cores changes without a reboot (CPU hotplug).
+// Queried the same way as the platform implementations do
+static uint16_t detectCoresOnline(FF_A_UNUSED const FFCPUResult* cpu) {
+#if defined(__linux__) || defined(__GNU__)
+    return (uint16_t) get_nprocs();
+#elif defined(_WIN32)
+    return (uint16_t) GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+#elif defined(__APPLE__)
+    uint16_t coresOnline = (uint16_t) ffSysctlGetInt("hw.logicalcpu", 1);
+    if (coresOnline == 1) {
+        coresOnline = (uint16_t) ffSysctlGetInt("hw.activecpu", 1);
+    }
+    return coresOnline;
+#elif defined(__FreeBSD__)
+    return (uint16_t) ffSysctlGetInt("kern.smp.cpus", cpu->coresLogical);
+#elif defined(__OpenBSD__)
+    return (uint16_t) ffSysctlGetInt(CTL_HW, HW_NCPUONLINE, cpu->coresLogical);
+#elif defined(__NetBSD__)
+    return (uint16_t) ffSysctlGetInt("hw.ncpuonline", cpu->coresLogical);
+#else
+    return cpu->coresLogical; // Not distinguished from logical cores
+#endif
+}
+
+static bool loadCacheImpl(FFCache* cache, FFCPUResult* cpu) {
+    uint32_t hasMarch;
+    if (!ffCacheLoad(cache, "cpu", FF_CPU_CACHE_VERSION) ||
+        !ffCacheGetStrbuf(cache, &cpu->name) ||
+        !ffCacheGetStrbuf(cache, &cpu->vendor) ||
+        !ffCacheGetU32(cache, &hasMarch) ||
+        !ffCacheGetU16(cache, &cpu->packages) ||
+        !ffCacheGetU16(cache, &cpu->coresPhysical) ||
+        !ffCacheGetU16(cache, &cpu->coresLogical) ||
+        !ffCacheGetU16(cache, &cpu->numaNodes) ||
+        !ffCacheGetU32(cache, &cpu->frequencyBase) ||
+        !ffCacheGetU32(cache, &cpu->frequencyMax)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < ARRAY_SIZE(cpu->coreTypes); ++i) {
+        if (!ffCacheGetU32(cache, &cpu->coreTypes[i].freq) || !ffCacheGetU32(cache, &cpu->coreTypes[i].count)) {
+            return false;
+        }
+    }
+
+    // march points to static strings. Detecting it is cheap.
+    // The frequencies it also sets may have been overridden by better sources when the cache was stored
+    if (hasMarch) {
+        uint32_t frequencyBase = cpu->frequencyBase, frequencyMax = cpu->frequencyMax;
+        ffCPUDetectByCpuid(cpu);
+        cpu->frequencyBase = frequencyBase;
+        cpu->frequencyMax = frequencyMax;
+    }
+
+    cpu->coresOnline = detectCoresOnline(cpu);
+    return true;
+}
+
+// Loads into a temporary result so that a corrupted cache file can't leave `cpu` half filled
+static bool loadCache(FFCache* cache, FFCPUResult* cpu) {
+    FFCPUResult cached = {
+        .name = ffStrbufCreate(),
+        .vendor = ffStrbufCreate(),
+    };
+    if (!loadCacheImpl(cache, &cached)) {
+        ffStrbufDestroy(&cached.name);
+        ffStrbufDestroy(&cached.vendor);
+        return false;
+    }
+
+    ffStrbufDestroy(&cpu->name);
+    ffStrbufDestroy(&cpu->vendor);
+    *cpu = cached;
+    return true;
+}
+
+static void storeCache(FFCache* cache, const FFCPUResult* cpu) {
+    ffCachePutStrbuf(cache, &cpu->name);
+    ffCachePutStrbuf(cache, &cpu->vendor);
+    ffCachePutU32(cache, cpu->march != NULL);
+    ffCachePutU16(cache, cpu->packages);
+    ffCachePutU16(cache, cpu->coresPhysical);
+    ffCachePutU16(cache, cpu->coresLogical);
+    ffCachePutU16(cache, cpu->numaNodes);
+    ffCachePutU32(cache, cpu->frequencyBase);
+    ffCachePutU32(cache, cpu->frequencyMax);
+    for (uint32_t i = 0; i < ARRAY_SIZE(cpu->coreTypes); ++i) {
+        ffCachePutU32(cache, cpu->coreTypes[i].freq);
+        ffCachePutU32(cache, cpu->coreTypes[i].count);
+    }
+    ffCacheStore(cache, "cpu", FF_CPU_CACHE_VERSION);
+}
+
 const char* ffDetectCPU(const FFCPUOptions* options, FFCPUResult* cpu) {
+    // Temperature changes all the time
+    bool useCache = !options->temp;
+    FF_A_CLEANUP(ffCacheDestroy) FFCache cache;
+    ffCacheInit(&cache);
+    if (useCache) {
+        initCacheKey(options, &cache);
+        if (loadCache(&cache, cpu)) {
+            cpu->temperature = FF_CPU_TEMP_UNSET;
+            return NULL;
+        }
+    }
+
     const char* error = ffDetectCPUImpl(options, cpu);
     if (error) {
         return error;
@@ -22,6 +144,10 @@ const char* ffDetectCPU(const FFCPUOptions* options, FFCPUResult* cpu) {
     ffStrbufSubstrBeforeFirstC(&cpu->name, '@'); // Cut the speed output in the name as we append our own
     ffStrbufTrimRight(&cpu->name, ' ');          // If we removed the @ in previous step there was most likely a space before it
     ffStrbufRemoveDupWhitespaces(&cpu->name);
+
+    if (useCache) {
+        storeCache(&cache, cpu);
+    }
     return NULL;
 }
 
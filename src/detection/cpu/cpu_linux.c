@@ -5,6 +5,7 @@
 #include "common/mallocHelper.h"
 #include "common/stringUtils.h"
 #include "common/path.h"
+#include "common/sensors.h"
 
 #include <sys/sysinfo.h>
 #include <stdlib.h>
@@ -27,22 +28,6 @@ static double readTempFile(int dfd, const char* filename, FFstrbuf* buffer) {
     return value / 1000.;
 }
 
-static double parseTZDir(int dfd, FFstrbuf* buffer) {
-    if (!ffReadFileBufferRelative(dfd, "type", buffer)) {
-        return FF_CPU_TEMP_UNSET;
-    }
-
-    if (!ffStrbufStartsWithS(buffer, "cpu") &&
-        !ffStrbufStartsWithS(buffer, "soc") &&
-#if __x86_64__ || __i386__
-        !ffStrbufEqualS(buffer, "x86_pkg_temp") &&
-#endif
-        true)
-        return FF_CPU_TEMP_UNSET;
-
-    return readTempFile(dfd, "temp", buffer);
-}
-
 static double parseHwmonDir(int dfd, FFstrbuf* buffer) {
     // https://www.kernel.org/doc/Documentation/hwmon/sysfs-interface
     if (!ffReadFileBufferRelative(dfd, "name", buffer)) {
@@ -109,54 +94,13 @@ static double detectCPUTemp(const FFCPUOptions* options) {
         return readTempFile(subfd, fileName, &buffer);
     }
 
-    {
-        FF_AUTO_CLOSE_DIR DIR* dirp = opendir("/sys/class/hwmon/");
-        if (dirp) {
-            int dfd = dirfd(dirp);
-
-            struct dirent* entry;
-            while ((entry = readdir(dirp)) != NULL) {
-                if (entry->d_name[0] == '.') {
-                    continue;
-                }
-
-                FF_AUTO_CLOSE_FD int subfd = openat(dfd, entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
-                if (subfd < 0) {
-                    continue;
-                }
-
-                double result = parseHwmonDir(subfd, &buffer);
-                if (result != FF_CPU_TEMP_UNSET) {
-                    return result;
-                }
-            }
+    for (FFSensor* sensor = ffSensorsFindByClass(FF_SENSOR_CLASS_CPU); sensor; sensor = sensor->nextOfClass) {
+        double result = ffSensorReadTemp(sensor, 1);
+        if (result != FF_SENSOR_TEMP_UNSET) {
+            return result;
         }
     }
-    {
-        FF_AUTO_CLOSE_DIR DIR* dirp = opendir("/sys/class/thermal/");
-        if (dirp) {
-            int dfd = dirfd(dirp);
-            struct dirent* entry;
-            while ((entry = readdir(dirp)) != NULL) {
-                if (entry->d_name[0] == '.') {
-                    continue;
-                }
-                if (!ffStrStartsWith(entry->d_name, "thermal_zone")) {
-                    continue;
-                }
-
-                FF_AUTO_CLOSE_FD int subfd = openat(dfd, entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
-                if (subfd < 0) {
-                    continue;
-                }
 
-                double result = parseTZDir(subfd, &buffer);
-                if (result != FF_CPU_TEMP_UNSET) {
-                    return result;
-                }
-            }
-        }
-    }
     {
         FF_AUTO_CLOSE_DIR DIR* dirp = opendir("/sys/devices/platform/");
         if (dirp) {
@@ -3,72 +3,117 @@
 #include "common/time.h"
 
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
-static FFlist cpuTimes1;
+static FFCpuUsageSample cpuTimes1;
 static uint64_t startTime;
 
+void ffCpuUsageSampleInit(FFCpuUsageSample* sample, bool frequency) {
+    *sample = (FFCpuUsageSample) {
+        .capacity = FF_LIST_DEFAULT_ALLOC,
+        .inUse = malloc(FF_LIST_DEFAULT_ALLOC * sizeof(*sample->inUse)),
+        .total = malloc(FF_LIST_DEFAULT_ALLOC * sizeof(*sample->total)),
+        .frequency = frequency ? malloc(FF_LIST_DEFAULT_ALLOC * sizeof(*sample->frequency)) : NULL,
+    };
+}
+
+void ffCpuUsageSampleAdd(FFCpuUsageSample* sample, uint64_t inUse, uint64_t total) {
+    if (sample->count == sample->capacity) {
+        sample->capacity *= 2;
+        sample->inUse = realloc(sample->inUse, sample->capacity * sizeof(*sample->inUse));
+        sample->total = realloc(sample->total, sample->capacity * sizeof(*sample->total));
+        if (sample->frequency) {
+            sample->frequency = realloc(sample->frequency, sample->capacity * sizeof(*sample->frequency));
+        }
+    }
+
+    sample->inUse[sample->count] = inUse;
+    sample->total[sample->count] = total;
+    if (sample->frequency) {
+        sample->frequency[sample->count] = 0;
+    }
+    ++sample->count;
+}
+
+void ffCpuUsageSampleDestroy(FFCpuUsageSample* sample) {
+    free(sample->inUse);
+    free(sample->total);
+    free(sample->frequency);
+    *sample = (FFCpuUsageSample) {};
+}
+
 void ffPrepareCPUUsage(void) {
     if (startTime != 0) {
         return; // Already prepared
     }
 
-    ffListInit(&cpuTimes1);
+    ffCpuUsageSampleInit(&cpuTimes1, false);
     ffGetCpuUsageInfo(&cpuTimes1);
     startTime = ffTimeGetNow();
 }
 
-const char* ffGetCpuUsageResult(FFCPUUsageOptions* options, FFlist* result) {
+const char* ffGetCpuUsageResult(FFCPUUsageOptions* options, FFlist* result, FFlist* frequencies) {
     const char* error = NULL;
     if (startTime == 0) {
-        ffListInit(&cpuTimes1);
+        ffCpuUsageSampleInit(&cpuTimes1, false);
         error = ffGetCpuUsageInfo(&cpuTimes1);
         if (error) {
             return error;
         }
-        ffTimeSleep(options->waitTime);
-    } else {
-        uint64_t elapsedTime = ffTimeGetNow() - startTime;
-        if (elapsedTime < options->waitTime) {
-            ffTimeSleep(options->waitTime - (uint32_t) elapsedTime);
-        }
+        startTime = ffTimeGetNow();
     }
 
-    if (cpuTimes1.length == 0) {
-        return "No CPU cores found";
+    // The first sample is usually taken when the config is loaded,
+    // so the window has already passed and the second sample is just a read
+    uint64_t elapsedTime = ffTimeGetNow() - startTime;
+    if (elapsedTime < options->waitTime) {
+        ffTimeSleep(options->waitTime - (uint32_t) elapsedTime);
     }
 
-    FF_LIST_AUTO_DESTROY cpuTimes2 = ffListCreate();
-    uint32_t retryCount = 0;
+    const uint32_t count = cpuTimes1.count;
+    if (count == 0) {
+        return "No CPU cores found";
+    }
 
-retry:
+    FFCpuUsageSample cpuTimes2;
+    ffCpuUsageSampleInit(&cpuTimes2, frequencies != NULL);
     error = ffGetCpuUsageInfo(&cpuTimes2);
     if (error) {
+        ffCpuUsageSampleDestroy(&cpuTimes2);
         return error;
     }
-    if (cpuTimes1.length != cpuTimes2.length) {
+    if (cpuTimes2.count != count) {
+        ffCpuUsageSampleDestroy(&cpuTimes2);
         return "Unexpected CPU usage result";
     }
 
-    for (uint32_t i = 0; i < cpuTimes1.length; ++i) {
-        FFCpuUsageInfo* cpuTime1 = FF_LIST_GET(FFCpuUsageInfo, cpuTimes1, i);
-        FFCpuUsageInfo* cpuTime2 = FF_LIST_GET(FFCpuUsageInfo, cpuTimes2, i);
-        if (cpuTime2->totalAll <= cpuTime1->totalAll) {
-            if (++retryCount <= 3) {
-                ffListClear(&cpuTimes2);
-                ffTimeSleep(options->waitTime);
-                goto retry;
-            }
-            return "CPU time did not increase. Try increasing wait time.";
-        }
+    // Branchless over the columns, so that the compiler vectorises it
+    bool stalled = false;
+    for (uint32_t i = 0; i < count; ++i) {
+        stalled |= cpuTimes2.total[i] <= cpuTimes1.total[i];
+    }
+    if (stalled) {
+        ffCpuUsageSampleDestroy(&cpuTimes2);
+        return "CPU time did not increase. Try increasing wait time.";
+    }
+
+    ffListReserve(result, sizeof(double), result->length + count);
+    double* percentages = (double*) result->data + result->length;
+    result->length += count;
+    for (uint32_t i = 0; i < count; ++i) {
+        percentages[i] = (double) (cpuTimes2.inUse[i] - cpuTimes1.inUse[i]) / (double) (cpuTimes2.total[i] - cpuTimes1.total[i]) * 100;
     }
 
-    for (uint32_t i = 0; i < cpuTimes1.length; ++i) {
-        FFCpuUsageInfo* cpuTime1 = FF_LIST_GET(FFCpuUsageInfo, cpuTimes1, i);
-        FFCpuUsageInfo* cpuTime2 = FF_LIST_GET(FFCpuUsageInfo, cpuTimes2, i);
-        *FF_LIST_ADD(double, *result) = (double) (cpuTime2->inUseAll - cpuTime1->inUseAll) / (double) (cpuTime2->totalAll - cpuTime1->totalAll) * 100;
-        cpuTime1->inUseAll = cpuTime2->inUseAll;
-        cpuTime1->totalAll = cpuTime2->totalAll;
+    if (frequencies) {
+        ffListReserve(frequencies, sizeof(uint32_t), frequencies->length + count);
+        memcpy((uint32_t*) frequencies->data + frequencies->length, cpuTimes2.frequency, count * sizeof(uint32_t));
+        frequencies->length += count;
     }
+
+    // The second sample becomes the base of the next call (`--dynamic-interval`)
+    ffCpuUsageSampleDestroy(&cpuTimes1);
+    cpuTimes1 = cpuTimes2;
     startTime = ffTimeGetNow();
     return NULL;
 }
@@ -3,10 +3,20 @@
 #include "fastfetch.h"
 #include "modules/cpuusage/option.h"
 
-typedef struct FFCpuUsageInfo {
-    uint64_t inUseAll;
-    uint64_t totalAll;
-} FFCpuUsageInfo;
-const char* ffGetCpuUsageInfo(FFlist* cpuTimes);
+// Cumulative CPU times of all cores. Each field is a column, so that deltas between two samples vectorise
+typedef struct FFCpuUsageSample {
+    uint32_t count;
+    uint32_t capacity;
+    uint64_t* inUse;
+    uint64_t* total;
+    uint32_t* frequency; // Current frequency of each core in MHz, 0 if unknown. Only filled if set by `ffCpuUsageSampleInit`
+} FFCpuUsageSample;
 
-const char* ffGetCpuUsageResult(FFCPUUsageOptions* options, FFlist* result); // list of double
+void ffCpuUsageSampleInit(FFCpuUsageSample* sample, bool frequency);
+void ffCpuUsageSampleAdd(FFCpuUsageSample* sample, uint64_t inUse, uint64_t total);
+void ffCpuUsageSampleDestroy(FFCpuUsageSample* sample);
+
+const char* ffGetCpuUsageInfo(FFCpuUsageSample* sample);
+
+// `frequencies`: list of uint32_t in MHz, can be NULL
+const char* ffGetCpuUsageResult(FFCPUUsageOptions* options, FFlist* result, FFlist* frequencies); // list of double
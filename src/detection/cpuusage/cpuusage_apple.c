@@ -5,7 +5,7 @@
 #include <mach/mach_host.h>
 #include <mach/vm_map.h>
 
-const char* ffGetCpuUsageInfo(FFlist* cpuTimes) {
+const char* ffGetCpuUsageInfo(FFCpuUsageSample* cpuTimes) {
     natural_t numCPUs = 0U;
     processor_info_array_t cpuInfo;
     mach_msg_type_number_t numCpuInfo;
@@ -21,11 +21,7 @@ const char* ffGetCpuUsageInfo(FFlist* cpuTimes) {
         integer_t inUse = cpuInfo[CPU_STATE_MAX * i + CPU_STATE_USER] + cpuInfo[CPU_STATE_MAX * i + CPU_STATE_SYSTEM] + cpuInfo[CPU_STATE_MAX * i + CPU_STATE_NICE];
         integer_t total = inUse + cpuInfo[CPU_STATE_MAX * i + CPU_STATE_IDLE];
 
-        FFCpuUsageInfo* info = FF_LIST_ADD(FFCpuUsageInfo, *cpuTimes);
-        *info = (FFCpuUsageInfo) {
-            .inUseAll = (uint64_t) inUse,
-            .totalAll = (uint64_t) total,
-        };
+        ffCpuUsageSampleAdd(cpuTimes, (uint64_t) inUse, (uint64_t) total);
     }
 
     vm_deallocate(mach_task_self(), (vm_address_t) cpuInfo, numCpuInfo * sizeof(integer_t));
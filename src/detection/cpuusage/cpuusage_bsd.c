@@ -10,7 +10,7 @@
     #include <sys/sched.h>
 #endif
 
-const char* ffGetCpuUsageInfo(FFlist* cpuTimes) {
+const char* ffGetCpuUsageInfo(FFCpuUsageSample* cpuTimes) {
     size_t neededLength = 0;
 #if __OpenBSD__ || __NetBSD__
     #ifdef KERN_CPTIME
@@ -47,11 +47,7 @@ const char* ffGetCpuUsageInfo(FFlist* cpuTimes) {
         uint64_t inUse = cpTime[CP_USER] + cpTime[CP_NICE] + cpTime[CP_SYS] + cpTime[CP_INTR];
         uint64_t total = inUse + cpTime[CP_IDLE];
 
-        FFCpuUsageInfo* info = FF_LIST_ADD(FFCpuUsageInfo, *cpuTimes);
-        *info = (FFCpuUsageInfo) {
-            .inUseAll = inUse,
-            .totalAll = total,
-        };
+        ffCpuUsageSampleAdd(cpuTimes, inUse, total);
     }
 
     return NULL;
@@ -4,7 +4,7 @@
 
 #include <OS.h>
 
-const char* ffGetCpuUsageInfo(FFlist* cpuTimes) {
+const char* ffGetCpuUsageInfo(FFCpuUsageSample* cpuTimes) {
     system_info sysInfo;
     if (get_system_info(&sysInfo) != B_OK) {
         return "get_system_info() failed";
@@ -18,9 +18,7 @@ const char* ffGetCpuUsageInfo(FFlist* cpuTimes) {
     uint64_t uptime = (uint64_t) system_time();
 
     for (uint32_t i = 0; i < sysInfo.cpu_count; ++i) {
-        FFCpuUsageInfo* info = FF_LIST_ADD(FFCpuUsageInfo, *cpuTimes);
-        info->inUseAll = (uint64_t) cpuInfo[i].active_time;
-        info->totalAll = uptime;
+        ffCpuUsageSampleAdd(cpuTimes, (uint64_t) cpuInfo[i].active_time, uptime);
     }
 
     return NULL;
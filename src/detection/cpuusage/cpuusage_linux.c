@@ -3,43 +3,84 @@
 #include "common/io.h"
 
 #include <stdio.h>
-#include <inttypes.h>
+#include <stdlib.h>
 
-const char* ffGetCpuUsageInfo(FFlist* cpuTimes) {
-    char buf[PROC_FILE_BUFFSIZ];
-    ssize_t nRead = ffReadFileData("/proc/stat", ARRAY_SIZE(buf) - 1, buf);
-    if (nRead < 0) {
+// Skips spaces and parses a decimal number. Returns NULL if there is none
+static inline const char* parseUInt64(const char* p, uint64_t* result) {
+    while (*p == ' ') {
+        ++p;
+    }
+    if ((uint8_t) (*p - '0') > 9) {
+        return NULL;
+    }
+
+    uint64_t value = 0;
+    do {
+        value = value * 10 + (uint64_t) (*p - '0');
+        ++p;
+    } while ((uint8_t) (*p - '0') <= 9);
+
+    *result = value;
+    return p;
+}
+
+static uint32_t readFrequency(uint32_t cpu) {
+    char path[64];
+    snprintf(path, ARRAY_SIZE(path), "/sys/devices/system/cpu/cpu%u/cpufreq/scaling_cur_freq", (unsigned) cpu);
+
+    char buf[32];
+    ssize_t length = ffReadFileData(path, ARRAY_SIZE(buf) - 1, buf);
+    if (length <= 0) {
+        return 0;
+    }
+    buf[length] = '\0';
+    return (uint32_t) (strtoul(buf, NULL, 10) / 1000); // kHz
+}
+
+const char* ffGetCpuUsageInfo(FFCpuUsageSample* cpuTimes) {
+    // Grows as needed, as /proc/stat of machines with hundreds of cores exceeds PROC_FILE_BUFFSIZ
+    FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreateA(PROC_FILE_BUFFSIZ);
+    if (!ffReadFileBuffer("/proc/stat", &buffer)) {
 #ifdef __ANDROID__
         return "Accessing \"/proc/stat\" is restricted on Android O+";
 #else
-        return "ffReadFileData(\"/proc/stat\", ARRAY_SIZE(buf) - 1, buf) failed";
+        return "ffReadFileBuffer(\"/proc/stat\") failed";
 #endif
     }
-    buf[nRead] = '\0';
 
-    // Skip first line
-    char* start = NULL;
-    if ((start = strchr(buf, '\n')) == NULL) {
+    // Skip the first line, which is the sum of all cores
+    const char* line = memchr(buffer.chars, '\n', buffer.length);
+    if (line == NULL) {
         return "skip first line failed";
     }
-    ++start;
-
-    uint64_t user = 0, nice = 0, system = 0, idle = 0, iowait = 0, irq = 0, softirq = 0;
-    char* token = NULL;
-    while ((token = strchr(start, '\n'))) {
-        if (sscanf(start, "cpu%*d%" PRIu64 "%" PRIu64 "%" PRIu64 "%" PRIu64 "%" PRIu64 "%" PRIu64 "%" PRIu64 "%*[^\n]\n", &user, &nice, &system, &idle, &iowait, &irq, &softirq) == 7) {
-            uint64_t inUse = user + nice + system + irq + softirq;
-            uint64_t total = inUse + idle + iowait;
-
-            FFCpuUsageInfo* info = FF_LIST_ADD(FFCpuUsageInfo, *cpuTimes);
-            *info = (FFCpuUsageInfo) {
-                .inUseAll = inUse,
-                .totalAll = total,
-            };
-        } else {
+    ++line;
+
+    // cpuN user nice system idle iowait irq softirq steal guest guest_nice
+    while (line[0] == 'c' && line[1] == 'p' && line[2] == 'u') {
+        uint64_t cpu, user, nice, system, idle, iowait, irq, softirq;
+        const char* p = line + strlen("cpu");
+        if (!(p = parseUInt64(p, &cpu)) ||
+            !(p = parseUInt64(p, &user)) ||
+            !(p = parseUInt64(p, &nice)) ||
+            !(p = parseUInt64(p, &system)) ||
+            !(p = parseUInt64(p, &idle)) ||
+            !(p = parseUInt64(p, &iowait)) ||
+            !(p = parseUInt64(p, &irq)) ||
+            !(p = parseUInt64(p, &softirq))) {
+            break;
+        }
+
+        uint64_t inUse = user + nice + system + irq + softirq;
+        ffCpuUsageSampleAdd(cpuTimes, inUse, inUse + idle + iowait);
+        if (cpuTimes->frequency) {
+            cpuTimes->frequency[cpuTimes->count - 1] = readFrequency((uint32_t) cpu);
+        }
+
+        line = strchr(p, '\n');
+        if (line == NULL) {
             break;
         }
-        start = token + 1;
+        ++line;
     }
 
     return NULL;
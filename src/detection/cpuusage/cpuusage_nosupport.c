@@ -1,6 +1,6 @@
 #include "fastfetch.h"
 #include "detection/cpuusage/cpuusage.h"
 
-const char* ffGetCpuUsageInfo(FF_A_UNUSED FFlist* cpuTimes) {
+const char* ffGetCpuUsageInfo(FF_A_UNUSED FFCpuUsageSample* cpuTimes) {
     return "Not support on this platform";
 }
@@ -8,7 +8,7 @@
 #include "common/windows/perflib_.h"
 #include "common/windows/nt.h"
 
-static const char* getInfoByNqsi(FFlist* cpuTimes) {
+static const char* getInfoByNqsi(FFCpuUsageSample* cpuTimes) {
     ULONG size = 0;
     if (NtQuerySystemInformation(SystemProcessorPerformanceInformation, NULL, 0, &size) != STATUS_INFO_LENGTH_MISMATCH) {
         return "NtQuerySystemInformation(SystemProcessorPerformanceInformation, NULL) failed";
@@ -28,17 +28,13 @@ static const char* getInfoByNqsi(FFlist* cpuTimes) {
         uint64_t inUse = (uint64_t) (coreInfo->UserTime.QuadPart + coreInfo->KernelTime.QuadPart);
         uint64_t total = inUse + (uint64_t) coreInfo->IdleTime.QuadPart;
 
-        FFCpuUsageInfo* info = FF_LIST_ADD(FFCpuUsageInfo, *cpuTimes);
-        *info = (FFCpuUsageInfo) {
-            .inUseAll = inUse,
-            .totalAll = total,
-        };
+        ffCpuUsageSampleAdd(cpuTimes, inUse, total);
     }
 
     return NULL;
 }
 
-static const char* getInfoByPerflib(FFlist* cpuTimes) {
+static const char* getInfoByPerflib(FFCpuUsageSample* cpuTimes) {
     static HANDLE hQuery = NULL;
 
     if (hQuery == NULL) {
@@ -138,11 +134,7 @@ static const char* getInfoByPerflib(FFlist* cpuTimes) {
                 return "Counter \"% Processor Utility\" are not supported";
             }
 
-            FFCpuUsageInfo* info = FF_LIST_ADD(FFCpuUsageInfo, *cpuTimes);
-            *info = (FFCpuUsageInfo) {
-                .inUseAll = processorUtility,
-                .totalAll = utilityBase,
-            };
+            ffCpuUsageSampleAdd(cpuTimes, processorUtility, utilityBase);
         }
 
         pInstanceHeader = (PERF_INSTANCE_HEADER*) pCounterData;
@@ -151,7 +143,7 @@ static const char* getInfoByPerflib(FFlist* cpuTimes) {
     return NULL;
 }
 
-const char* ffGetCpuUsageInfo(FFlist* cpuTimes) {
+const char* ffGetCpuUsageInfo(FFCpuUsageSample* cpuTimes) {
     const char* error = NULL;
 
     if (ffIsWindows10OrGreater()) {
@@ -160,7 +152,7 @@ const char* ffGetCpuUsageInfo(FFlist* cpuTimes) {
         if (!error) {
             return NULL;
         }
-        ffListClear(cpuTimes);
+        cpuTimes->count = 0;
     }
 
     error = getInfoByNqsi(cpuTimes);
@@ -283,7 +283,8 @@ static void detectStats(FFDisk* disk) {
 }
 
 const char* ffDetectDisksImpl(FFDiskOptions* options, FFlist* disks) {
-    FILE* mountsFile = setmntent("/proc/mounts", "r");
+    FF_STRBUF_AUTO_DESTROY mountsPath = ffStrbufCreate();
+    FILE* mountsFile = setmntent(ffIoResolvePath("/proc/mounts", false, &mountsPath), "r");
     if (mountsFile == NULL) {
         return "setmntent(\"/proc/mounts\", \"r\") == NULL";
     }
@@ -21,6 +21,19 @@ void ffPrepareDiskIO(FFDiskIOOptions* options) {
     time1 = ffTimeGetNow();
 }
 
+// The baseline may have been detected with different options, e.g. by `fastfetch --daemon`
+static bool isSameBaseline(const FFlist* result) {
+    if (result->length != ioCounters1.length) {
+        return false;
+    }
+    for (uint32_t i = 0; i < result->length; ++i) {
+        if (!ffStrbufEqual(&FF_LIST_GET(FFDiskIOResult, ioCounters1, i)->devPath, &FF_LIST_GET(FFDiskIOResult, *result, i)->devPath)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 const char* ffDetectDiskIO(FFlist* result, FFDiskIOOptions* options) {
     const char* error = NULL;
 
@@ -45,7 +58,10 @@ const char* ffDetectDiskIO(FFlist* result, FFDiskIOOptions* options) {
         return "No physical disk found";
     }
 
-    uint64_t time2 = ffTimeGetNow();
+    bool rebased = false;
+    uint64_t time2;
+measure:
+    time2 = ffTimeGetNow();
     while (time2 - time1 < options->waitTime) {
         ffTimeSleep((uint32_t) (options->waitTime - (time2 - time1)));
         time2 = ffTimeGetNow();
@@ -56,6 +72,20 @@ const char* ffDetectDiskIO(FFlist* result, FFDiskIOOptions* options) {
         return error;
     }
 
+    if (!rebased && !isSameBaseline(result)) {
+        // Use the current counters as the new baseline and measure again
+        FF_LIST_FOR_EACH (FFDiskIOResult, counter, ioCounters1) {
+            ffStrbufDestroy(&counter->name);
+            ffStrbufDestroy(&counter->devPath);
+        }
+        ffListDestroy(&ioCounters1);
+        ioCounters1 = *result;
+        ffListInit(result);
+        time1 = time2;
+        rebased = true;
+        goto measure;
+    }
+
     if (result->length != ioCounters1.length) {
         return "Different number of physical disks. Hardware change?";
     }
@@ -73,7 +103,7 @@ const char* ffDetectDiskIO(FFlist* result, FFDiskIOOptions* options) {
             uint64_t* currValue = (uint64_t*) ((uint8_t*) icCurr + off);
             uint64_t temp = *currValue;
             *currValue -= *prevValue;
-            *currValue /= (time2 - time1) / 1000 /* seconds */;
+            *currValue = *currValue * 1000 / (time2 - time1); // per second
 
             // For next function call
             *prevValue = temp;
@@ -76,7 +76,7 @@ static const char* parseDiskIOCounters(int dfd, const char* devName, FFlist* res
 }
 
 const char* ffDiskIOGetIoCounters(FFlist* result, FFDiskIOOptions* options) {
-    FF_AUTO_CLOSE_DIR DIR* sysBlockDirp = opendir("/sys/block/");
+    FF_AUTO_CLOSE_DIR DIR* sysBlockDirp = ffOpenDir("/sys/block/");
     if (sysBlockDirp == NULL) {
         return "opendir(\"/sys/block/\") == NULL";
     }
@@ -1,4 +1,5 @@
 #include "displayserver.h"
+#include "common/thread.h"
 
 FFDisplayResult* ffdsAppendDisplay(
     FFDisplayServerResult* result,
@@ -53,6 +54,8 @@ void ffConnectDisplayServerImpl(FFDisplayServerResult* ds);
 const FFDisplayServerResult* ffConnectDisplayServer() {
     static FFDisplayServerResult result;
     static bool initialized = false;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
     if (!initialized) {
         initialized = true;
         ffStrbufInit(&result.wmProcessName);
@@ -63,5 +66,6 @@ const FFDisplayServerResult* ffConnectDisplayServer() {
         ffListInit(&result.displays);
         ffConnectDisplayServerImpl(&result);
     }
+    ffThreadMutexUnlock(&mutex);
     return &result;
 }
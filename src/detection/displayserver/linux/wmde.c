@@ -1,5 +1,6 @@
 #include "displayserver_linux.h"
 #include "common/io.h"
+#include "common/processing.h"
 #include "common/properties.h"
 #include "common/stringUtils.h"
 #include "common/mallocHelper.h"
@@ -370,54 +371,48 @@ static const char* getFromProcesses(FFDisplayServerResult* result) {
         }
     }
 #elif __linux__ || __GNU__
-    FF_AUTO_CLOSE_DIR DIR* procdir = opendir("/proc");
-    if (procdir == NULL) {
+    const FFlist* processes = ffProcessTableGetAll();
+    if (processes == NULL) {
         return "opendir(\"/proc\") failed";
     }
 
-    FF_STRBUF_AUTO_DESTROY procPath = ffStrbufCreateA(64);
-    ffStrbufAppendS(&procPath, "/proc/");
-
-    uint32_t procPathLength = procPath.length;
-
-    FF_STRBUF_AUTO_DESTROY loginuid = ffStrbufCreate();
-    FF_STRBUF_AUTO_DESTROY processName = ffStrbufCreateA(256); // Some processes have large command lines (looking at you chrome)
-
-    struct dirent* dirent;
-    while ((dirent = readdir(procdir)) != NULL) {
-        // Match only folders starting with a number (the pid folders)
-        if (dirent->d_type != DT_DIR || !ffCharIsDigit(dirent->d_name[0])) {
-            continue;
-        }
-
-        ffStrbufAppendS(&procPath, dirent->d_name);
-        uint32_t procFolderPathLength = procPath.length;
+    FF_STRBUF_AUTO_DESTROY cmdline = ffStrbufCreateA(256); // Some processes have large command lines (looking at you chrome)
 
+    FF_LIST_FOR_EACH (FFProcessEntry, process, *processes) {
         // Don't check for processes not owned by the current user.
-        ffStrbufAppendS(&procPath, "/loginuid");
-        ffReadFileBuffer(procPath.chars, &loginuid);
-        if (ffStrbufToUInt(&loginuid, (uint64_t) -1) != userId) {
-            ffStrbufSubstrBefore(&procPath, procPathLength);
+        if (process->uid != userId) {
             continue;
         }
 
-        ffStrbufSubstrBefore(&procPath, procFolderPathLength);
-
-        // We check the cmdline for the process name, because it is not trimmed.
-        ffStrbufAppendS(&procPath, "/cmdline");
-        ffReadFileBuffer(procPath.chars, &processName);
-        ffStrbufTrimRightSpace(&processName);
-        ffStrbufSubstrBeforeFirstC(&processName, '\0'); // Trim the arguments
-        ffStrbufSubstrAfterLastC(&processName, '/');
-
-        ffStrbufSubstrBefore(&procPath, procPathLength);
-
+        // `comm` needs no extra read, so it is checked first
+        uint32_t deLength = result->dePrettyName.length, wmLength = result->wmPrettyName.length;
         if (result->dePrettyName.length == 0) {
-            applyPrettyNameIfDE(result, processName.chars);
+            applyPrettyNameIfDE(result, process->name.chars);
         }
 
         if (result->wmPrettyName.length == 0) {
-            applyNameIfWM(result, processName.chars);
+            applyNameIfWM(result, process->name.chars);
+        }
+
+        // `comm` is truncated to 15 chars, and differs from argv[0] for wrapped binaries (`.sway-wrapped` on NixOS).
+        // Check the basename of argv[0] if it didn't match
+        if (result->dePrettyName.length == deLength && result->wmPrettyName.length == wmLength) {
+            char path[64];
+            snprintf(path, sizeof(path), "/proc/%d/cmdline", (int) process->pid);
+            if (ffReadFileBuffer(path, &cmdline)) {
+                ffStrbufTrimRightSpace(&cmdline);
+                ffStrbufSubstrBeforeFirstC(&cmdline, '\0'); // Trim the arguments
+                ffStrbufSubstrAfterLastC(&cmdline, '/');
+                if (cmdline.length > 0 && !ffStrbufEqual(&cmdline, &process->name)) {
+                    if (result->dePrettyName.length == 0) {
+                        applyPrettyNameIfDE(result, cmdline.chars);
+                    }
+
+                    if (result->wmPrettyName.length == 0) {
+                        applyNameIfWM(result, cmdline.chars);
+                    }
+                }
+            }
         }
 
         if (result->dePrettyName.length > 0 && result->wmPrettyName.length > 0) {
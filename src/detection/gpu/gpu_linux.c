@@ -7,6 +7,8 @@
 #include "common/FFstrbuf.h"
 #include "common/stringUtils.h"
 #include "common/mallocHelper.h"
+#include "common/sensors.h"
+#include "common/sysfs.h"
 #include "modules/gpu/option.h"
 
 #include <inttypes.h>
@@ -35,11 +37,9 @@
     #define FF_HAVE_DRM_ASAHI 1
 #endif
 
-static bool pciDetectDriver(FFstrbuf* result, FFstrbuf* pciDir, FFstrbuf* buffer, FF_A_UNUSED const char* drmKey) {
-    uint32_t pciDirLength = pciDir->length;
-    ffStrbufAppendS(pciDir, "/driver");
+static bool pciDetectDriver(FFstrbuf* result, int devfd, FFstrbuf* buffer, FF_A_UNUSED const char* drmKey) {
     char pathBuf[PATH_MAX];
-    ssize_t resultLength = readlink(pciDir->chars, pathBuf, ARRAY_SIZE(pathBuf));
+    ssize_t resultLength = readlinkat(devfd, "driver", pathBuf, ARRAY_SIZE(pathBuf));
     if (resultLength <= 0) {
         return false;
     }
@@ -51,29 +51,37 @@ static bool pciDetectDriver(FFstrbuf* result, FFstrbuf* pciDir, FFstrbuf* buffer
     }
 
     if (ffStrbufEqualS(result, "nvidia")) {
-        if (ffReadFileBuffer("/proc/driver/nvidia/version", buffer)) {
-            if (ffStrbufContainS(buffer, " Open ")) {
-                ffStrbufAppendS(result, " (open source)");
+        // Shared by all GPUs of the machine
+        static uint8_t nvidiaKind; // 0: unknown; 1: open source; 2: proprietary; 3: missing
+        uint8_t kind = __atomic_load_n(&nvidiaKind, __ATOMIC_RELAXED);
+        if (kind == 0) {
+            if (!ffReadFileBuffer("/proc/driver/nvidia/version", buffer)) {
+                kind = 3;
             } else {
-                ffStrbufAppendS(result, " (proprietary)");
+                kind = ffStrbufContainS(buffer, " Open ") ? 1 : 2;
             }
+            __atomic_store_n(&nvidiaKind, kind, __ATOMIC_RELAXED);
+        }
+        if (kind == 1) {
+            ffStrbufAppendS(result, " (open source)");
+        } else if (kind == 2) {
+            ffStrbufAppendS(result, " (proprietary)");
         }
     }
 
     if (instance.config.general.detectVersion) {
-        ffStrbufAppendS(pciDir, "/module/version");
-        if (ffReadFileBuffer(pciDir->chars, buffer)) {
-            ffStrbufTrimRightSpace(buffer);
+        FFSysfsAttr attrs[] = {
+            { .name = "driver/module/version" },
+            { .name = "zx_info/driver_version" },
+        };
+        ffSysfsReadAttrs(devfd, ffStrbufEqualS(result, "zx") ? 2 : 1, attrs, buffer);
+        const char* version = ffSysfsAttrValue(&attrs[0], buffer);
+        if (!version && ffStrbufEqualS(result, "zx")) {
+            version = ffSysfsAttrValue(&attrs[1], buffer);
+        }
+        if (version) {
             ffStrbufAppendC(result, ' ');
-            ffStrbufAppend(result, buffer);
-        } else if (ffStrbufEqualS(result, "zx")) {
-            ffStrbufSubstrBefore(pciDir, pciDirLength);
-            ffStrbufAppendS(pciDir, "/zx_info/driver_version");
-            if (ffReadFileBuffer(pciDir->chars, buffer)) {
-                ffStrbufTrimRightSpace(buffer);
-                ffStrbufAppendC(result, ' ');
-                ffStrbufAppend(result, buffer);
-            }
+            ffStrbufAppendS(result, version);
         }
     }
 
@@ -83,7 +91,7 @@ static bool pciDetectDriver(FFstrbuf* result, FFstrbuf* pciDir, FFstrbuf* buffer
 FF_A_UNUSED static const char* drmFindRenderFromCard(const char* drmCardKey, FFstrbuf* result) {
     char path[PATH_MAX];
     sprintf(path, "/sys/class/drm/%s/device/drm", drmCardKey);
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir(path);
+    FF_AUTO_CLOSE_DIR DIR* dirp = ffOpenDir(path);
     if (!dirp) {
         return "Failed to open `/sys/class/drm/{drmCardKey}/device/drm`";
     }
@@ -121,61 +129,47 @@ static const char* drmDetectAmdSpecific(const FFGPUOptions* options, FFGPUResult
 #endif
 }
 
-static void pciDetectAmdSpecific(const FFGPUOptions* options, FFGPUResult* gpu, FFstrbuf* pciDir, FFstrbuf* buffer) {
+static void pciDetectAmdSpecific(const FFGPUOptions* options, FFGPUResult* gpu, FFstrbuf* pciDir, int devfd, FFstrbuf* buffer) {
     // https://www.kernel.org/doc/html/v5.10/gpu/amdgpu.html#mem-info-vis-vram-total
-    const uint32_t pciDirLen = pciDir->length;
-
-    ffStrbufAppendS(pciDir, "/hwmon/");
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir(pciDir->chars);
-    if (!dirp) {
-        return;
-    }
-
-    struct dirent* entry;
-    while ((entry = readdir(dirp)) != NULL) {
-        if (entry->d_name[0] == '.') {
-            continue;
-        }
-        break;
-    }
-    if (!entry) {
+    FFSensor* sensor = ffSensorsFindByDevice(pciDir->chars);
+    if (!sensor) {
         return;
     }
-    ffStrbufAppendS(pciDir, entry->d_name);
-    ffStrbufAppendC(pciDir, '/');
 
-    const uint32_t hwmonLen = pciDir->length;
-    uint64_t value = 0;
     if (options->temp) {
-        ffStrbufAppendS(pciDir, "temp1_input"); // The on die GPU temperature in millidegrees Celsius
-        if (ffReadFileBuffer(pciDir->chars, buffer) && (value = ffStrbufToUInt(buffer, 0))) {
-            gpu->temperature = (double) value / 1000;
+        double temp = ffSensorReadTemp(sensor, 1); // The on die GPU temperature
+        if (temp > 0) {
+            gpu->temperature = temp;
         }
     }
 
     if (ffStrbufEqualS(&gpu->driver, "amdgpu")) // Ancient radeon drivers don't have these files
     {
-        ffStrbufSubstrBefore(pciDir, hwmonLen);
-        ffStrbufAppendS(pciDir, "in1_input"); // Northbridge voltage in millivolts (APUs only)
-        if (ffPathExists(pciDir->chars, FF_PATHTYPE_ANY)) {
+        ffStrbufSet(buffer, &sensor->path);
+        ffStrbufAppendS(buffer, "in1_input"); // Northbridge voltage in millivolts (APUs only)
+        if (ffPathExists(buffer->chars, FF_PATHTYPE_ANY)) {
             gpu->type = FF_GPU_TYPE_INTEGRATED;
         } else {
             gpu->type = FF_GPU_TYPE_DISCRETE;
         }
 
         if (options->driverSpecific) {
-            ffStrbufSubstrBefore(pciDir, pciDirLen);
-            ffStrbufAppendS(pciDir, "/mem_info_vis_vram_total");
-            if (ffReadFileBuffer(pciDir->chars, buffer) && (value = ffStrbufToUInt(buffer, 0))) {
+            FFSysfsAttr attrs[] = {
+                { .name = "mem_info_vis_vram_total" },
+                { .name = "mem_info_vis_vram_used" },
+                { .name = "gpu_busy_percent" },
+            };
+            ffSysfsReadAttrs(devfd, ARRAY_SIZE(attrs), attrs, buffer);
+
+            uint64_t value;
+            if ((value = ffSysfsAttrToUInt(&attrs[0], buffer, 0))) {
                 if (gpu->type == FF_GPU_TYPE_DISCRETE) {
                     gpu->dedicated.total = value;
                 } else {
                     gpu->shared.total = value;
                 }
 
-                ffStrbufSubstrBefore(pciDir, pciDir->length - (uint32_t) strlen("/mem_info_vis_vram_total"));
-                ffStrbufAppendS(pciDir, "/mem_info_vis_vram_used");
-                if (ffReadFileBuffer(pciDir->chars, buffer) && (value = ffStrbufToUInt(buffer, 0))) {
+                if ((value = ffSysfsAttrToUInt(&attrs[1], buffer, 0))) {
                     if (gpu->type == FF_GPU_TYPE_DISCRETE) {
                         gpu->dedicated.used = value;
                     } else {
@@ -184,16 +178,14 @@ static void pciDetectAmdSpecific(const FFGPUOptions* options, FFGPUResult* gpu,
                 }
             }
 
-            ffStrbufSubstrBefore(pciDir, pciDirLen);
-            ffStrbufAppendS(pciDir, "/gpu_busy_percent");
-            if (ffReadFileBuffer(pciDir->chars, buffer) && (value = ffStrbufToUInt(buffer, 0))) {
+            if ((value = ffSysfsAttrToUInt(&attrs[2], buffer, 0))) {
                 gpu->coreUsage = (double) value;
             }
         }
     }
 }
 
-static void pciDetectIntelSpecific(const FFGPUOptions* options, FFGPUResult* gpu, FFstrbuf* pciDir, FFstrbuf* buffer, const char* drmKey) {
+static void pciDetectIntelSpecific(const FFGPUOptions* options, FFGPUResult* gpu, FFstrbuf* pciDir, int devfd, FFstrbuf* buffer, const char* drmKey) {
     // Works for Intel GPUs
     // https://patchwork.kernel.org/project/intel-gfx/patch/1422039866-11572-3-git-send-email-ville.syrjala@linux.intel.com/
 
@@ -204,44 +196,25 @@ static void pciDetectIntelSpecific(const FFGPUOptions* options, FFGPUResult* gpu
         return;
     }
 
-    const uint32_t pciDirLen = pciDir->length;
-
     bool isXE = ffStrbufEqualS(&gpu->driver, "xe");
-    if (isXE) {
-        ffStrbufAppendS(pciDir, "/tile0/gt0/freq0/max_freq");
-    } else {
-        ffStrbufAppendF(pciDir, "/drm/%s/gt_max_freq_mhz", drmKey);
+    char freqPath[64] = "tile0/gt0/freq0/max_freq";
+    if (!isXE) {
+        snprintf(freqPath, ARRAY_SIZE(freqPath), "drm/%s/gt_max_freq_mhz", drmKey);
     }
-    if (ffReadFileBuffer(pciDir->chars, buffer)) {
-        gpu->frequency = (uint32_t) ffStrbufToUInt(buffer, 0);
+    FFSysfsAttr freq = { .name = freqPath };
+    if (ffSysfsReadAttrs(devfd, 1, &freq, buffer)) {
+        gpu->frequency = (uint32_t) ffSysfsAttrToUInt(&freq, buffer, 0);
     }
-    ffStrbufSubstrBefore(pciDir, pciDirLen);
 
     if (options->temp) {
-        ffStrbufAppendS(pciDir, "/hwmon/");
-        FF_AUTO_CLOSE_DIR DIR* dirp = opendir(pciDir->chars);
-        if (dirp) {
-            struct dirent* entry;
-            while ((entry = readdir(dirp)) != NULL) {
-                if (entry->d_name[0] == '.') {
-                    continue;
-                }
-
-                ffStrbufSubstrBefore(pciDir, pciDirLen + strlen("/hwmon/"));
-                ffStrbufAppendS(pciDir, entry->d_name);
-                // https://github.com/Syllo/nvtop/blob/73291884d926445e499d6b9b71cb7a9bdbc7c393/src/extract_gpuinfo_intel.c#L279-L281
-                ffStrbufAppendS(pciDir, isXE ? "/temp2_input" : "/temp1_input");
-
-                if (ffReadFileBuffer(pciDir->chars, buffer)) {
-                    uint64_t value = ffStrbufToUInt(buffer, 0);
-                    if (value > 0) {
-                        gpu->temperature = (double) value / 1000;
-                        break;
-                    }
-                }
+        for (FFSensor* sensor = ffSensorsFindByDevice(pciDir->chars); sensor; sensor = sensor->nextOfDevice) {
+            // https://github.com/Syllo/nvtop/blob/73291884d926445e499d6b9b71cb7a9bdbc7c393/src/extract_gpuinfo_intel.c#L279-L281
+            double temp = ffSensorReadTemp(sensor, isXE ? 2 : 1);
+            if (temp > 0) {
+                gpu->temperature = temp;
+                break;
             }
         }
-        ffStrbufSubstrBefore(pciDir, pciDirLen);
     }
 }
 
@@ -266,29 +239,15 @@ static const char* drmDetectIntelSpecific(FFGPUResult* gpu, const char* drmKey,
 #endif
 }
 
-static const char* pciDetectTempGeneral(const FFGPUOptions* options, FFGPUResult* gpu, FFstrbuf* pciDir, FFstrbuf* buffer) {
+static const char* pciDetectTempGeneral(const FFGPUOptions* options, FFGPUResult* gpu, FFstrbuf* pciDir) {
     if (options->temp) {
-        const uint32_t pciDirLen = pciDir->length;
-        ffStrbufAppendS(pciDir, "/hwmon/");
-        FF_AUTO_CLOSE_DIR DIR* dirp = opendir(pciDir->chars);
-        if (dirp) {
-            struct dirent* entry;
-            while ((entry = readdir(dirp))) {
-                if (entry->d_name[0] == '.') {
-                    continue;
-                }
-                ffStrbufAppendS(pciDir, entry->d_name);
-                ffStrbufAppendS(pciDir, "/temp1_input");
-                if (ffReadFileBuffer(pciDir->chars, buffer)) {
-                    uint64_t value = ffStrbufToUInt(buffer, 0);
-                    if (value > 0) {
-                        gpu->temperature = (double) value / 1000.0;
-                    }
-                }
-                break;
+        FFSensor* sensor = ffSensorsFindByDevice(pciDir->chars);
+        if (sensor) {
+            double temp = ffSensorReadTemp(sensor, 1);
+            if (temp > 0) {
+                gpu->temperature = temp;
             }
         }
-        ffStrbufSubstrBefore(pciDir, pciDirLen);
     }
     return NULL;
 }
@@ -309,38 +268,34 @@ static const char* drmDetectNouveauSpecific(FFGPUResult* gpu, const char* drmKey
 #endif
 }
 
-static const char* pciDetectZxSpecific(const FFGPUOptions* options, FFGPUResult* gpu, FFstrbuf* pciDir, FFstrbuf* buffer) {
+static const char* pciDetectZxSpecific(const FFGPUOptions* options, FFGPUResult* gpu, int devfd, FFstrbuf* buffer) {
     gpu->type = FF_GPU_TYPE_INTEGRATED;
 
-    const uint32_t pciDirLen = pciDir->length;
-    ffStrbufAppendS(pciDir, "/zx_info/eclk");
-    if (ffReadFileBuffer(pciDir->chars, buffer)) {
-        gpu->frequency = (uint32_t) ffStrbufToUInt(buffer, FF_GPU_FREQUENCY_UNSET);
-    }
-    ffStrbufSubstrBefore(pciDir, pciDirLen);
+    FFSysfsAttr attrs[] = {
+        { .name = "zx_info/eclk" },
+        { .name = "zx_info/engine_3d_usage" },
+        { .name = "zx_info/fb_size" },
+        { .name = "zx_info/free_fb_mem" },
+    };
+    ffSysfsReadAttrs(devfd, options->driverSpecific ? ARRAY_SIZE(attrs) : 1, attrs, buffer);
 
-    if (options->driverSpecific) {
-        ffStrbufAppendS(pciDir, "/zx_info/engine_3d_usage");
-        if (ffReadFileBuffer(pciDir->chars, buffer)) {
-            gpu->coreUsage = ffStrbufToDouble(buffer, FF_GPU_CORE_USAGE_UNSET);
-        }
-        ffStrbufSubstrBefore(pciDir, pciDirLen);
+    gpu->frequency = (uint32_t) ffSysfsAttrToUInt(&attrs[0], buffer, FF_GPU_FREQUENCY_UNSET);
 
-        ffStrbufAppendS(pciDir, "/zx_info/fb_size");
-        if (ffReadFileBuffer(pciDir->chars, buffer)) {
-            gpu->shared.total = ffStrbufToUInt(buffer, FF_GPU_VMEM_SIZE_UNSET);
+    if (options->driverSpecific) {
+        const char* usage = ffSysfsAttrValue(&attrs[1], buffer);
+        if (usage) {
+            char* end;
+            double value = strtod(usage, &end);
+            if (end != usage) {
+                gpu->coreUsage = value;
+            }
         }
-        ffStrbufSubstrBefore(pciDir, pciDirLen);
 
+        gpu->shared.total = ffSysfsAttrToUInt(&attrs[2], buffer, FF_GPU_VMEM_SIZE_UNSET);
         if (gpu->shared.total != FF_GPU_VMEM_SIZE_UNSET) {
             gpu->shared.total *= 1024 * 1024;
 
-            ffStrbufAppendS(pciDir, "/zx_info/free_fb_mem");
-            if (ffReadFileBuffer(pciDir->chars, buffer)) {
-                gpu->shared.used = ffStrbufToUInt(buffer, FF_GPU_VMEM_SIZE_UNSET);
-            }
-            ffStrbufSubstrBefore(pciDir, pciDirLen);
-
+            gpu->shared.used = ffSysfsAttrToUInt(&attrs[3], buffer, FF_GPU_VMEM_SIZE_UNSET);
             if (gpu->shared.used != FF_GPU_VMEM_SIZE_UNSET) {
                 gpu->shared.used *= 1024 * 1024;
                 gpu->shared.used = gpu->shared.total - gpu->shared.used;
@@ -410,7 +365,7 @@ static const char* detectPci(const FFGPUOptions* options, FFlist* gpus, FFstrbuf
     char drmKeyBuffer[8];
     if (!drmKey) {
         ffStrbufAppendS(deviceDir, "/drm");
-        FF_AUTO_CLOSE_DIR DIR* dirp = opendir(deviceDir->chars);
+        FF_AUTO_CLOSE_DIR DIR* dirp = ffOpenDir(deviceDir->chars);
         if (dirp) {
             struct dirent* entry;
             while ((entry = readdir(dirp)) != NULL) {
@@ -428,8 +383,10 @@ static const char* detectPci(const FFGPUOptions* options, FFlist* gpus, FFstrbuf
         ffStrbufSetF(&gpu->platformApi, "DRM (%s)", drmKey);
     }
 
-    pciDetectDriver(&gpu->driver, deviceDir, buffer, drmKey);
-    ffStrbufSubstrBefore(deviceDir, drmDirPathLength);
+    // All attributes of the device are read relative to it, instead of resolving the full path each time
+    FF_AUTO_CLOSE_FD int devfd = ffSysfsOpenDir(deviceDir->chars);
+
+    pciDetectDriver(&gpu->driver, devfd, buffer, drmKey);
 
     if (gpu->vendor.chars == FF_GPU_VENDOR_NAME_AMD) {
         bool ok = false;
@@ -438,33 +395,31 @@ static const char* detectPci(const FFGPUOptions* options, FFlist* gpus, FFstrbuf
         }
 
         if (!ok) {
-            pciDetectAmdSpecific(options, gpu, deviceDir, buffer);
-            ffStrbufSubstrBefore(deviceDir, drmDirPathLength);
+            pciDetectAmdSpecific(options, gpu, deviceDir, devfd, buffer);
 
-            ffStrbufAppendS(deviceDir, "/revision");
-            if (ffReadFileBuffer(deviceDir->chars, buffer)) {
+            FFSysfsAttr revision = { .name = "revision" };
+            if (ffSysfsReadAttrs(devfd, 1, &revision, buffer)) {
+                const char* str = ffSysfsAttrValue(&revision, buffer);
                 char* pend;
-                uint64_t revision = strtoul(buffer->chars, &pend, 16);
-                if (pend != buffer->chars) {
-                    ffGPUQueryAmdGpuName((uint16_t) deviceId, (uint8_t) revision, gpu);
+                uint64_t value = strtoul(str, &pend, 16);
+                if (pend != str) {
+                    ffGPUQueryAmdGpuName((uint16_t) deviceId, (uint8_t) value, gpu);
                 }
             }
-            ffStrbufSubstrBefore(deviceDir, drmDirPathLength);
         }
     } else if (gpu->vendor.chars == FF_GPU_VENDOR_NAME_INTEL) {
-        pciDetectIntelSpecific(options, gpu, deviceDir, buffer, drmKey);
-        ffStrbufSubstrBefore(deviceDir, drmDirPathLength);
+        pciDetectIntelSpecific(options, gpu, deviceDir, devfd, buffer, drmKey);
         if (options->driverSpecific && drmKey) {
             drmDetectIntelSpecific(gpu, drmKey, buffer);
         }
     } else if (gpu->vendor.chars == FF_GPU_VENDOR_NAME_NVIDIA && ffStrbufEqualS(&gpu->driver, "nouveau")) {
-        pciDetectTempGeneral(options, gpu, deviceDir, buffer);
+        pciDetectTempGeneral(options, gpu, deviceDir);
         if (options->driverSpecific && drmKey) {
             drmDetectNouveauSpecific(gpu, drmKey, buffer);
         }
     } else if (gpu->vendor.chars == FF_GPU_VENDOR_NAME_ZHAOXIN && ffStrbufStartsWithS(&gpu->driver, "zx")) {
-        pciDetectTempGeneral(options, gpu, deviceDir, buffer);
-        pciDetectZxSpecific(options, gpu, deviceDir, buffer);
+        pciDetectTempGeneral(options, gpu, deviceDir);
+        pciDetectZxSpecific(options, gpu, devfd, buffer);
     } else {
         ffGPUDetectDriverSpecific(options, gpu, (FFGpuDriverPciBusId) {
                                                     .domain = pciDomain,
@@ -543,7 +498,8 @@ static const char* detectOf(FFlist* gpus, FFstrbuf* buffer, FFstrbuf* drmDir, co
     gpu->dedicated.total = gpu->dedicated.used = gpu->shared.total = gpu->shared.used = FF_GPU_VMEM_SIZE_UNSET;
     gpu->frequency = FF_GPU_FREQUENCY_UNSET;
 
-    pciDetectDriver(&gpu->driver, drmDir, buffer, drmKey);
+    FF_AUTO_CLOSE_FD int devfd = ffSysfsOpenDir(drmDir->chars);
+    pciDetectDriver(&gpu->driver, devfd, buffer, drmKey);
 
 #ifdef __aarch64__
     if (ffStrbufEqualS(&gpu->driver, "asahi")) {
@@ -572,7 +528,7 @@ static const char* drmDetectGPUs(const FFGPUOptions* options, FFlist* gpus) {
     ffStrbufAppendS(&drmDir, "/sys/class/drm/");
     const uint32_t drmDirLength = drmDir.length;
 
-    FF_AUTO_CLOSE_DIR DIR* dir = opendir(drmDir.chars);
+    FF_AUTO_CLOSE_DIR DIR* dir = ffOpenDir(drmDir.chars);
     if (dir == NULL) {
         return "Failed to open `/sys/class/drm/`";
     }
@@ -610,7 +566,7 @@ static const char* pciDetectGPUs(const FFGPUOptions* options, FFlist* gpus) {
     // https://www.kernel.org/doc/Documentation/ABI/testing/sysfs-bus-pci
     const char* pciDirPath = "/sys/bus/pci/devices/";
 
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir(pciDirPath);
+    FF_AUTO_CLOSE_DIR DIR* dirp = ffOpenDir(pciDirPath);
     if (dirp == NULL) {
         return "Failed to open `/sys/bus/pci/devices/`";
     }
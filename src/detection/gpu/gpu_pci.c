@@ -1,9 +1,11 @@
 #include "gpu.h"
+#include "common/thread.h"
 #include "common/io.h"
-#include "common/properties.h"
 #include "common/memrchr.h"
 
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #ifdef __FreeBSD__
     #include <paths.h>
     #ifndef _PATH_LOCALBASE
@@ -25,176 +27,429 @@
 #define FF_STR_INDIR(x) #x
 #define FF_STR(x) FF_STR_INDIR(x)
 
-static const FFstrbuf* loadPciIds() {
-    static FFstrbuf pciids;
+// Binary index of pci.ids or amdgpu.ids, cached in `<cacheDir>/fastfetch/<name>.bin` and rebuilt when the source file changes.
+// Parents (vendors, or AMD products) and the children of each parent (devices) are sorted by id, so both are found with bsearch in the mapped file
+#define FF_IDS_INDEX_MAGIC "FFID"
+#define FF_IDS_INDEX_VERSION 1
 
-    if (pciids.chars) {
-        return &pciids;
+typedef struct FFIdsIndexHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceMtime; // In ns
+    uint64_t sourceSize;
+    uint64_t sourceInode;
+    uint32_t nParents;
+    uint32_t nChildren;
+    uint32_t namesSize;
+    uint32_t reserved;
+} FFIdsIndexHeader; // Followed by parents, children and NUL terminated names
+
+typedef struct FFIdsIndexParent {
+    uint32_t id;
+    uint32_t name; // Offset in names
+    uint32_t firstChild;
+    uint32_t nChildren;
+} FFIdsIndexParent;
+
+typedef struct FFIdsIndexChild {
+    uint32_t id;
+    uint32_t name;
+} FFIdsIndexChild;
+
+typedef struct FFIdsIndex {
+    const FFIdsIndexHeader* header; // NULL if the source file is not available
+    const FFIdsIndexParent* parents;
+    const FFIdsIndexChild* children;
+    const char* names;
+} FFIdsIndex;
+
+typedef struct FFIdsIndexBuilder {
+    FFlist parents;  // FFIdsIndexParent
+    FFlist children; // FFIdsIndexChild
+    FFstrbuf names;
+} FFIdsIndexBuilder;
+
+static uint32_t idsIndexAddName(FFIdsIndexBuilder* builder, const char* name, const char* end) {
+    while (end > name && (end[-1] == ' ' || end[-1] == '\r')) {
+        --end;
+    }
+    uint32_t offset = builder->names.length;
+    ffStrbufAppendNS(&builder->names, (uint32_t) (end - name), name);
+    ffStrbufAppendC(&builder->names, '\0');
+    return offset;
+}
+
+static bool idsIndexParseHex(const char* p, uint32_t length, uint32_t* result) {
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < length; ++i) {
+        char c = p[i];
+        if (c >= '0' && c <= '9') {
+            value = value << 4 | (uint32_t) (c - '0');
+        } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+            value = value << 4 | (uint32_t) ((c | 0x20) - 'a' + 10);
+        } else {
+            return false;
+        }
     }
-    ffStrbufInit(&pciids);
+    *result = value;
+    return true;
+}
+
+// `vvvv  Vendor` lines, each followed by `\tdddd  Device` lines.
+// Subsystems (`\t\t`) and the known device classes at the end of the file are skipped
+static void parsePciIds(const FFstrbuf* content, FFIdsIndexBuilder* builder) {
+    const char* contentEnd = content->chars + content->length;
+    for (const char *line = content->chars, *end; line < contentEnd; line = end + 1) {
+        end = memchr(line, '\n', (size_t) (contentEnd - line));
+        if (!end) {
+            end = contentEnd;
+        }
+
+        if (line[0] == 'C' && line[1] == ' ') {
+            break;
+        }
 
+        bool isDevice = line[0] == '\t';
+        const char* p = line + isDevice;
+        uint32_t id;
+        if (end - p < 7 || p[4] != ' ' || p[5] != ' ' || !idsIndexParseHex(p, 4, &id)) {
+            continue;
+        }
+
+        if (!isDevice) {
+            *FF_LIST_ADD(FFIdsIndexParent, builder->parents) = (FFIdsIndexParent) {
+                .id = id,
+                .name = idsIndexAddName(builder, p + 6, end),
+                .firstChild = builder->children.length,
+            };
+        } else if (builder->parents.length > 0) {
+            *FF_LIST_ADD(FFIdsIndexChild, builder->children) = (FFIdsIndexChild) {
+                .id = id,
+                .name = idsIndexAddName(builder, p + 6, end),
+            };
+            ++FF_LIST_LAST(FFIdsIndexParent, builder->parents)->nChildren;
+        }
+    }
+}
+
+// `dddd,\trr,\tProduct name` lines. Products are stored as parents with the id `device << 8 | revision`
+static void parseAmdGpuIds(const FFstrbuf* content, FFIdsIndexBuilder* builder) {
+    const char* contentEnd = content->chars + content->length;
+    for (const char *line = content->chars, *end; line < contentEnd; line = end + 1) {
+        end = memchr(line, '\n', (size_t) (contentEnd - line));
+        if (!end) {
+            end = contentEnd;
+        }
+
+        const char* deviceEnd = memchr(line, ',', (size_t) (end - line));
+        if (!deviceEnd || deviceEnd - line > 4 || end - deviceEnd < 2 || deviceEnd[1] != '\t') {
+            continue;
+        }
+        const char* revision = deviceEnd + 2;
+        const char* revisionEnd = memchr(revision, ',', (size_t) (end - revision));
+        if (!revisionEnd || revisionEnd - revision > 2 || end - revisionEnd < 2 || revisionEnd[1] != '\t') {
+            continue;
+        }
+
+        uint32_t device, revisionId;
+        if (deviceEnd == line || revisionEnd == revision ||
+            !idsIndexParseHex(line, (uint32_t) (deviceEnd - line), &device) ||
+            !idsIndexParseHex(revision, (uint32_t) (revisionEnd - revision), &revisionId)) {
+            continue;
+        }
+
+        *FF_LIST_ADD(FFIdsIndexParent, builder->parents) = (FFIdsIndexParent) {
+            .id = device << 8 | revisionId,
+            .name = idsIndexAddName(builder, revisionEnd + 2, end),
+        };
+    }
+}
+
+static int idsIndexCmp(const void* a, const void* b) {
+    // Both parents and children start with the id
+    uint32_t x = *(const uint32_t*) a, y = *(const uint32_t*) b;
+    return x < y ? -1 : x > y;
+}
+
+static bool idsIndexInit(FFIdsIndex* index, const void* data, size_t size, const struct stat* source) {
+    const FFIdsIndexHeader* header = data;
+    if (size < sizeof(*header) || memcmp(header->magic, FF_IDS_INDEX_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != FF_IDS_INDEX_VERSION ||
+        header->sourceMtime != (uint64_t) source->st_mtim.tv_sec * 1000000000ULL + (uint64_t) source->st_mtim.tv_nsec ||
+        header->sourceSize != (uint64_t) source->st_size ||
+        header->sourceInode != (uint64_t) source->st_ino ||
+        header->namesSize == 0 ||
+        size != sizeof(*header) + header->nParents * sizeof(FFIdsIndexParent) + header->nChildren * sizeof(FFIdsIndexChild) + header->namesSize) {
+        return false;
+    }
+
+    index->header = header;
+    index->parents = (const FFIdsIndexParent*) (header + 1);
+    index->children = (const FFIdsIndexChild*) (index->parents + header->nParents);
+    index->names = (const char*) (index->children + header->nChildren);
+    return index->names[header->namesSize - 1] == '\0';
+}
+
+static bool idsIndexMapCache(FFIdsIndex* index, const char* cachePath, const struct stat* source) {
+    FF_AUTO_CLOSE_FD int fd = open(cachePath, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(FFIdsIndexHeader)) {
+        return false;
+    }
+
+    void* data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    if (!idsIndexInit(index, data, (size_t) st.st_size, source)) {
+        *index = (FFIdsIndex) {};
+        munmap(data, (size_t) st.st_size);
+        return false;
+    }
+    return true;
+}
+
+static void idsIndexLoad(FFIdsIndex* index, const char* sourcePath, const char* cacheName, void (*parse)(const FFstrbuf* content, FFIdsIndexBuilder* builder)) {
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    struct stat source;
+    if (stat(ffIoResolvePath(sourcePath, false, &rooted), &source) < 0) {
+        return;
+    }
+
+    FF_STRBUF_AUTO_DESTROY cachePath = ffStrbufCreateCopy(&instance.state.platform.cacheDir);
+    ffStrbufEnsureEndsWithC(&cachePath, '/');
+    ffStrbufAppendF(&cachePath, "fastfetch/%s.bin", cacheName);
+    if (idsIndexMapCache(index, cachePath.chars, &source)) {
+        return;
+    }
+
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    if (!ffReadFileBuffer(sourcePath, &content)) {
+        return;
+    }
+
+    FFIdsIndexBuilder builder = {};
+    ffStrbufInit(&builder.names);
+    parse(&content, &builder);
+
+    FF_LIST_FOR_EACH (FFIdsIndexParent, parent, builder.parents) {
+        qsort(FF_LIST_GET(FFIdsIndexChild, builder.children, parent->firstChild), parent->nChildren, sizeof(FFIdsIndexChild), idsIndexCmp);
+    }
+    ffListSort(&builder.parents, sizeof(FFIdsIndexParent), idsIndexCmp);
+    if (builder.names.length == 0) {
+        ffStrbufAppendC(&builder.names, '\0');
+    }
+
+    FFIdsIndexHeader header = {
+        .magic = FF_IDS_INDEX_MAGIC,
+        .version = FF_IDS_INDEX_VERSION,
+        .sourceMtime = (uint64_t) source.st_mtim.tv_sec * 1000000000ULL + (uint64_t) source.st_mtim.tv_nsec,
+        .sourceSize = (uint64_t) source.st_size,
+        .sourceInode = (uint64_t) source.st_ino,
+        .nParents = builder.parents.length,
+        .nChildren = builder.children.length,
+        .namesSize = builder.names.length,
+    };
+
+    // Kept for the rest of the run, like the mapped cache
+    FFstrbuf* data = malloc(sizeof(*data));
+    ffStrbufInitA(data, (uint32_t) (sizeof(header) + header.nParents * sizeof(FFIdsIndexParent) + header.nChildren * sizeof(FFIdsIndexChild) + header.namesSize));
+    ffStrbufAppendNS(data, sizeof(header), (const char*) &header);
+    ffStrbufAppendNS(data, header.nParents * (uint32_t) sizeof(FFIdsIndexParent), (const char*) builder.parents.data);
+    ffStrbufAppendNS(data, header.nChildren * (uint32_t) sizeof(FFIdsIndexChild), (const char*) builder.children.data);
+    ffStrbufAppend(data, &builder.names);
+    ffListDestroy(&builder.parents);
+    ffListDestroy(&builder.children);
+    ffStrbufDestroy(&builder.names);
+
+    // Written to a temporary file first, so that concurrent runs never map a partially written index
+    FF_STRBUF_AUTO_DESTROY tempPath = ffStrbufCreateCopy(&cachePath);
+    ffStrbufAppendF(&tempPath, ".%d.tmp", (int) getpid());
+    if (ffWriteFileBuffer(tempPath.chars, data) && rename(tempPath.chars, cachePath.chars) < 0) {
+        unlink(tempPath.chars);
+    }
+
+    idsIndexInit(index, data->chars, data->length, &source);
+}
+
+static const FFIdsIndexParent* idsIndexFind(const FFIdsIndex* index, uint32_t id) {
+    if (!index->header) {
+        return NULL;
+    }
+    return bsearch(&id, index->parents, index->header->nParents, sizeof(*index->parents), idsIndexCmp);
+}
+
+static const FFIdsIndexChild* idsIndexFindChild(const FFIdsIndex* index, const FFIdsIndexParent* parent, uint32_t id) {
+    if (parent->firstChild > index->header->nChildren || parent->nChildren > index->header->nChildren - parent->firstChild) {
+        return NULL;
+    }
+    return bsearch(&id, index->children + parent->firstChild, parent->nChildren, sizeof(*index->children), idsIndexCmp);
+}
+
+static const char* idsIndexName(const FFIdsIndex* index, uint32_t offset) {
+    return offset < index->header->namesSize ? index->names + offset : "";
+}
+
+static const char* findPciIdsPath(void) {
 #ifdef FF_CUSTOM_PCI_IDS_PATH
 
-    ffReadFileBuffer(FF_STR(FF_CUSTOM_PCI_IDS_PATH), &pciids);
+    return FF_STR(FF_CUSTOM_PCI_IDS_PATH);
 
 #else // FF_CUSTOM_PCI_IDS_PATH
 
+    static const char* const paths[] = {
     #if __linux__
-    ffReadFileBuffer(FASTFETCH_TARGET_DIR_USR "/share/hwdata/pci.ids", &pciids);
-    if (pciids.length == 0) {
-        ffReadFileBuffer(FASTFETCH_TARGET_DIR_USR "/share/misc/pci.ids", &pciids); // debian?
-        if (pciids.length == 0) {
-            ffReadFileBuffer(FASTFETCH_TARGET_DIR_USR "/local/share/hwdata/pci.ids", &pciids);
-        }
-    }
+        FASTFETCH_TARGET_DIR_USR "/share/hwdata/pci.ids",
+        FASTFETCH_TARGET_DIR_USR "/share/misc/pci.ids", // debian?
+        FASTFETCH_TARGET_DIR_USR "/local/share/hwdata/pci.ids",
     #elif __OpenBSD__ || __FreeBSD__ || __NetBSD__
-    ffReadFileBuffer(_PATH_LOCALBASE "/share/hwdata/pci.ids", &pciids);
-    if (pciids.length == 0) {
-        ffReadFileBuffer(_PATH_LOCALBASE "/share/pciids/pci.ids", &pciids);
-    }
+        _PATH_LOCALBASE "/share/hwdata/pci.ids",
+        _PATH_LOCALBASE "/share/pciids/pci.ids",
     #elif __sun
-    ffReadFileBuffer(FASTFETCH_TARGET_DIR_ROOT "/usr/share/hwdata/pci.ids", &pciids);
+        FASTFETCH_TARGET_DIR_ROOT "/usr/share/hwdata/pci.ids",
     #elif __HAIKU__
-    ffReadFileBuffer(FASTFETCH_TARGET_DIR_ROOT "/system/data/hwdata/pci.ids", &pciids);
+        FASTFETCH_TARGET_DIR_ROOT "/system/data/hwdata/pci.ids",
     #endif
+        NULL,
+    };
 
-#endif // FF_CUSTOM_PCI_IDS_PATH
+    for (const char* const* path = paths; *path; ++path) {
+        if (ffPathExists(*path, FF_PATHTYPE_FILE)) {
+            return *path;
+        }
+    }
+    return NULL;
 
-    return &pciids;
+#endif // FF_CUSTOM_PCI_IDS_PATH
 }
 
-static void parsePciIdsFile(const FFstrbuf* content, uint8_t subclass, uint16_t vendor, uint16_t device, FFGPUResult* gpu) {
-    if (content->length) {
-        char buffer[32];
+static const FFIdsIndex* loadPciIds() {
+    static FFIdsIndex index;
+    static bool loaded;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
 
-        // Search for vendor
-        uint32_t len = (uint32_t) snprintf(buffer, ARRAY_SIZE(buffer), "\n%04x  ", vendor);
-        char* start = (char*) memmem(content->chars, content->length, buffer, len);
-        char* end = content->chars + content->length;
-        if (start) {
-            start += len;
-            end = memchr(start, '\n', (uint32_t) (end - start));
-            if (!end) {
-                end = content->chars + content->length;
-            }
-            if (!gpu->vendor.length) {
-                ffStrbufSetNS(&gpu->vendor, (uint32_t) (end - start), start);
-            }
+    if (!loaded) {
+        loaded = true;
+        const char* path = findPciIdsPath();
+        if (path) {
+            idsIndexLoad(&index, path, "pciids", parsePciIds);
+        }
+    }
 
-            start = end;     // point to '\n' of vendor
-            end = start + 1; // point to start of devices
-            // find the start of next vendor
-            while (end[0] == '\t' || end[0] == '#') {
-                end = strchr(end, '\n');
-                if (!end) {
-                    end = content->chars + content->length;
-                    break;
-                } else {
-                    end++;
-                }
-            }
+    ffThreadMutexUnlock(&mutex);
+    return &index;
+}
 
-            // Search for device
-            len = (uint32_t) snprintf(buffer, ARRAY_SIZE(buffer), "\n\t%04x  ", device);
-            start = memmem(start, (size_t) (end - start), buffer, len);
-            if (start) {
-                start += len;
-                end = memchr(start, '\n', (uint32_t) (end - start));
-                if (!end) {
-                    end = content->chars + content->length;
-                }
-
-                char* closingBracket = end - 1;
-                if (*closingBracket == ']') {
-                    char* openingBracket = memrchr(start, '[', (size_t) (closingBracket - start));
-                    if (openingBracket) {
-                        openingBracket++;
-                        ffStrbufSetNS(&gpu->name, (uint32_t) (closingBracket - openingBracket), openingBracket);
-                    }
-                }
-                if (!gpu->name.length) {
-                    ffStrbufSetNS(&gpu->name, (uint32_t) (end - start), start);
-                }
+static const FFIdsIndex* loadAmdGpuIds() {
+    static FFIdsIndex index;
+    static bool loaded;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
+
+    if (!loaded) {
+        loaded = true;
+#ifdef FF_CUSTOM_AMDGPU_IDS_PATH
+        idsIndexLoad(&index, FF_STR(FF_CUSTOM_AMDGPU_IDS_PATH), "amdgpuids", parseAmdGpuIds);
+#else
+        FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+        FF_LIST_FOR_EACH (FFstrbuf, dataDir, instance.state.platform.dataDirs) {
+            ffStrbufSet(&path, dataDir);
+            ffStrbufAppendS(&path, "libdrm/amdgpu.ids");
+            if (ffPathExists(path.chars, FF_PATHTYPE_FILE)) {
+                idsIndexLoad(&index, path.chars, "amdgpuids", parseAmdGpuIds);
+                break;
             }
         }
+#endif
     }
 
+    ffThreadMutexUnlock(&mutex);
+    return &index;
+}
+
+// Prefers the marketing name in brackets, e.g. `GA102 [GeForce RTX 3080]`
+static void setDeviceName(FFGPUResult* gpu, const char* name) {
+    uint32_t nameLen = (uint32_t) strlen(name);
+    if (nameLen > 0 && name[nameLen - 1] == ']') {
+        const char* closingBracket = name + nameLen - 1;
+        const char* openingBracket = memrchr(name, '[', nameLen - 1);
+        if (openingBracket) {
+            openingBracket++;
+            ffStrbufSetNS(&gpu->name, (uint32_t) (closingBracket - openingBracket), openingBracket);
+        }
+    }
     if (!gpu->name.length) {
-        const char* subclassStr;
-        switch (subclass) {
-            case 0 /*PCI_CLASS_DISPLAY_VGA*/:
-                subclassStr = " (VGA compatible)";
-                break;
-            case 1 /*PCI_CLASS_DISPLAY_XGA*/:
-                subclassStr = " (XGA compatible)";
-                break;
-            case 2 /*PCI_CLASS_DISPLAY_3D*/:
-                subclassStr = " (3D)";
-                break;
-            default:
-                subclassStr = "";
-                break;
+        ffStrbufSetNS(&gpu->name, nameLen, name);
+    }
+}
+
+static void setUnknownDeviceName(uint8_t subclass, uint16_t device, FFGPUResult* gpu) {
+    const char* subclassStr;
+    switch (subclass) {
+        case 0 /*PCI_CLASS_DISPLAY_VGA*/:
+            subclassStr = " (VGA compatible)";
+            break;
+        case 1 /*PCI_CLASS_DISPLAY_XGA*/:
+            subclassStr = " (XGA compatible)";
+            break;
+        case 2 /*PCI_CLASS_DISPLAY_3D*/:
+            subclassStr = " (3D)";
+            break;
+        default:
+            subclassStr = "";
+            break;
+    }
+
+    ffStrbufSetF(&gpu->name, "%s Device %04X%s", gpu->vendor.length ? gpu->vendor.chars : "Unknown", device, subclassStr);
+}
+
+static void loadPciIdsFile(uint8_t subclass, uint16_t vendor, uint16_t device, FFGPUResult* gpu) {
+    const FFIdsIndex* index = loadPciIds();
+    const FFIdsIndexParent* pvendor = idsIndexFind(index, vendor);
+    if (pvendor) {
+        if (!gpu->vendor.length) {
+            ffStrbufSetS(&gpu->vendor, idsIndexName(index, pvendor->name));
         }
 
-        ffStrbufSetF(&gpu->name, "%s Device %04X%s", gpu->vendor.length ? gpu->vendor.chars : "Unknown", device, subclassStr);
+        const FFIdsIndexChild* pdevice = idsIndexFindChild(index, pvendor, device);
+        if (pdevice) {
+            setDeviceName(gpu, idsIndexName(index, pdevice->name));
+        }
+    }
+
+    if (!gpu->name.length) {
+        setUnknownDeviceName(subclass, device, gpu);
     }
 }
 
 #if FF_HAVE_EMBEDDED_PCIIDS
+static inline int pciVendorCmp(const uint16_t* key, const FFPciVendor* element) {
+    return (int) *key - (int) element->id;
+}
+
 static inline int pciDeviceCmp(const uint16_t* key, const FFPciDevice* element) {
     return (int) *key - (int) element->id;
 }
 
 static bool loadPciidsInc(uint8_t subclass, uint16_t vendor, uint16_t device, FFGPUResult* gpu) {
-    for (const FFPciVendor* pvendor = ffPciVendors; pvendor->name; pvendor++) {
-        if (pvendor->id != vendor) {
-            continue;
-        }
-
-        if (!gpu->vendor.length) {
-            ffStrbufSetS(&gpu->vendor, pvendor->name);
-        }
-
-        const FFPciDevice* pdevice = (const FFPciDevice*) bsearch(&device, pvendor->devices, pvendor->nDevices, sizeof(*pdevice), (void*) pciDeviceCmp);
-
-        if (pdevice) {
-            uint32_t nameLen = (uint32_t) strlen(pdevice->name);
-            const char* closingBracket = pdevice->name + nameLen - 1;
-            if (*closingBracket == ']') {
-                const char* openingBracket = memrchr(pdevice->name, '[', nameLen - 1);
-                if (openingBracket) {
-                    openingBracket++;
-                    ffStrbufSetNS(&gpu->name, (uint32_t) (closingBracket - openingBracket), openingBracket);
-                }
-            }
-            if (!gpu->name.length) {
-                ffStrbufSetNS(&gpu->name, nameLen, pdevice->name);
-            }
-            return true;
-        }
+    // The last one is a sentinel
+    const FFPciVendor* pvendor = (const FFPciVendor*) bsearch(&vendor, ffPciVendors, ARRAY_SIZE(ffPciVendors) - 1, sizeof(*pvendor), (void*) pciVendorCmp);
+    if (!pvendor) {
+        return false;
+    }
 
-        if (!gpu->name.length) {
-            const char* subclassStr;
-            switch (subclass) {
-                case 0 /*PCI_CLASS_DISPLAY_VGA*/:
-                    subclassStr = " (VGA compatible)";
-                    break;
-                case 1 /*PCI_CLASS_DISPLAY_XGA*/:
-                    subclassStr = " (XGA compatible)";
-                    break;
-                case 2 /*PCI_CLASS_DISPLAY_3D*/:
-                    subclassStr = " (3D)";
-                    break;
-                default:
-                    subclassStr = "";
-                    break;
-            }
+    if (!gpu->vendor.length) {
+        ffStrbufSetS(&gpu->vendor, pvendor->name);
+    }
 
-            ffStrbufSetF(&gpu->name, "%s Device %04X%s", gpu->vendor.length ? gpu->vendor.chars : "Unknown", device, subclassStr);
-        }
-        return true;
+    const FFPciDevice* pdevice = (const FFPciDevice*) bsearch(&device, pvendor->devices, pvendor->nDevices, sizeof(*pdevice), (void*) pciDeviceCmp);
+    if (pdevice) {
+        setDeviceName(gpu, pdevice->name);
+    } else if (!gpu->name.length) {
+        setUnknownDeviceName(subclass, device, gpu);
     }
-    return false;
+    return true;
 }
 #endif
 
@@ -210,7 +465,7 @@ void ffGPUFillVendorAndName(uint8_t subclass, uint16_t vendor, uint16_t device,
         return;
     }
 #endif
-    return parsePciIdsFile(loadPciIds(), subclass, vendor, device, gpu);
+    return loadPciIdsFile(subclass, vendor, device, gpu);
 }
 
 #if FF_HAVE_EMBEDDED_AMDGPUIDS
@@ -230,14 +485,12 @@ static bool loadAmdGpuIdsInc(uint16_t deviceId, uint8_t revision, FFGPUResult* g
 }
 #endif
 
-static void parseAmdGpuIdsFile(uint16_t deviceId, uint8_t revision, FFGPUResult* gpu) {
-    char query[32];
-    snprintf(query, ARRAY_SIZE(query), "%X,\t%X,", (unsigned) deviceId, (unsigned) revision);
-#ifdef FF_CUSTOM_AMDGPU_IDS_PATH
-    ffParsePropFile(FF_STR(FF_CUSTOM_AMDGPU_IDS_PATH), query, &gpu->name);
-#else
-    ffParsePropFileData("libdrm/amdgpu.ids", query, &gpu->name);
-#endif
+static void loadAmdGpuIdsFile(uint16_t deviceId, uint8_t revision, FFGPUResult* gpu) {
+    const FFIdsIndex* index = loadAmdGpuIds();
+    const FFIdsIndexParent* product = idsIndexFind(index, (uint32_t) deviceId << 8 | revision);
+    if (product) {
+        ffStrbufSetS(&gpu->name, idsIndexName(index, product->name));
+    }
 }
 
 void ffGPUQueryAmdGpuName(uint16_t deviceId, uint8_t revisionId, FFGPUResult* gpu) {
@@ -247,5 +500,5 @@ void ffGPUQueryAmdGpuName(uint16_t deviceId, uint8_t revisionId, FFGPUResult* gp
         return;
     }
 #endif
-    return parseAmdGpuIdsFile(deviceId, revisionId, gpu);
+    return loadAmdGpuIdsFile(deviceId, revisionId, gpu);
 }
@@ -52,9 +52,12 @@ static void detectGTKFromSettings(FFGTKResult* result) {
     static const char* wallpaper = NULL;
 
     static bool init = false;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
 
     if (init) {
         applyGTKSettings(result, themeName, iconsName, fontName, cursorTheme, cursorSize, wallpaper);
+        ffThreadMutexUnlock(&mutex);
         return;
     }
 
@@ -109,6 +112,7 @@ static void detectGTKFromSettings(FFGTKResult* result) {
     }
 
     applyGTKSettings(result, themeName, iconsName, fontName, cursorTheme, cursorSize, wallpaper);
+    ffThreadMutexUnlock(&mutex);
 }
 
 static void detectGTKFromConfigFile(const char* filename, FFGTKResult* result) {
@@ -176,19 +180,22 @@ static void detectGTK(const char* version, FFGTKResult* result) {
     }
 }
 
-#define FF_DETECT_GTK_IMPL(version)   \
-    static FFGTKResult result;        \
-    static bool init = false;         \
-    if (init)                         \
-        return &result;               \
-    init = true;                      \
-    ffStrbufInit(&result.theme);      \
-    ffStrbufInit(&result.icons);      \
-    ffStrbufInit(&result.font);       \
-    ffStrbufInit(&result.cursor);     \
-    ffStrbufInit(&result.cursorSize); \
-    ffStrbufInit(&result.wallpaper);  \
-    detectGTK(#version, &result);     \
+#define FF_DETECT_GTK_IMPL(version)                           \
+    static FFGTKResult result;                                \
+    static bool init = false;                                 \
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER; \
+    ffThreadMutexLock(&mutex);                                \
+    if (!init) {                                              \
+        init = true;                                          \
+        ffStrbufInit(&result.theme);                          \
+        ffStrbufInit(&result.icons);                          \
+        ffStrbufInit(&result.font);                           \
+        ffStrbufInit(&result.cursor);                         \
+        ffStrbufInit(&result.cursorSize);                     \
+        ffStrbufInit(&result.wallpaper);                      \
+        detectGTK(#version, &result);                         \
+    }                                                         \
+    ffThreadMutexUnlock(&mutex);                              \
     return &result;
 
 const FFGTKResult* ffDetectGTK2(void) {
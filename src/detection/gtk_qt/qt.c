@@ -176,7 +176,10 @@ const FFQtResult* ffDetectQt(void) {
     static FFQtResult result;
 
     static bool init = false;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
     if (init) {
+        ffThreadMutexUnlock(&mutex);
         return &result;
     }
     init = true;
@@ -205,5 +208,6 @@ const FFQtResult* ffDetectQt(void) {
         detectKvantum(&result);
     }
 
+    ffThreadMutexUnlock(&mutex);
     return &result;
 }
@@ -10,12 +10,24 @@
 #define FF_SYSTEMD_USERS_PATH "/run/systemd/users/"
 
 static const char* getGdmVersion(FFstrbuf* version) {
-    const char* error = ffProcessAppendStdOut(version, (char* const[]) { "gdm", "--version", NULL });
-    if (error || version->length == 0) {
-        error = ffProcessAppendStdOut(version, (char* const[]) { "gdm3", "--version", NULL });
-        if (error || version->length == 0) {
-            return "Failed to get GDM version";
-        }
+    // The binary is named gdm3 on Debian. Both candidates are probed at once
+    FFProcessReactor reactor;
+    ffProcessReactorInit(&reactor);
+    FFProcessJob* gdm = ffProcessReactorSpawn(&reactor, (char* const[]) { "gdm", "--version", NULL }, false);
+    FFProcessJob* gdm3 = ffProcessReactorSpawn(&reactor, (char* const[]) { "gdm3", "--version", NULL }, false);
+    ffProcessReactorWait(&reactor, NULL);
+
+    const char* error = NULL;
+    if (gdm->error == NULL && gdm->output.length > 0) {
+        ffStrbufSet(version, &gdm->output);
+    } else if (gdm3->error == NULL && gdm3->output.length > 0) {
+        ffStrbufSet(version, &gdm3->output);
+    } else {
+        error = "Failed to get GDM version";
+    }
+    ffProcessReactorDestroy(&reactor);
+    if (error) {
+        return error;
     }
 
     // GDM 44.1
@@ -24,7 +36,7 @@ static const char* getGdmVersion(FFstrbuf* version) {
 }
 
 static const char* getSshdVersion(FFstrbuf* version) {
-    const char* error = ffProcessAppendStdErr(version, (char* const[]) { "sshd", "-V", NULL });
+    const char* error = ffProcessReactorAppendOutput(version, (char* const[]) { "sshd", "-V", NULL }, true);
     if (error) {
         return error;
     }
@@ -87,7 +99,7 @@ static const char* getSddmVersion(FF_A_UNUSED FFstrbuf* version) {
 #endif
 
 static const char* getXfwmVersion(FFstrbuf* version) {
-    const char* error = ffProcessAppendStdOut(version, (char* const[]) { "xfwm4", "--version", NULL });
+    const char* error = ffProcessReactorAppendOutput(version, (char* const[]) { "xfwm4", "--version", NULL }, false);
     if (error) {
         return error;
     }
@@ -100,7 +112,7 @@ static const char* getXfwmVersion(FFstrbuf* version) {
 }
 
 static const char* getLightdmVersion(FFstrbuf* version) {
-    const char* error = ffProcessAppendStdErr(version, (char* const[]) { "lightdm", "--version", NULL });
+    const char* error = ffProcessReactorAppendOutput(version, (char* const[]) { "lightdm", "--version", NULL }, true);
     if (error) {
         return error;
     }
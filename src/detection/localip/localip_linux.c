@@ -3,6 +3,7 @@
 #include "common/netif.h"
 #include "common/stringUtils.h"
 #include "common/debug.h"
+#include "common/thread.h"
 
 #include <string.h>
 #include <ctype.h>
@@ -173,11 +174,14 @@ static FFLocalIpIpv6Type getIpv6Type(struct ifaddrs* ifa) {
 #elif __linux__
     static FFlist addresses = {};
     static bool initialized = false;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
     if (!initialized) {
         initialized = true;
         ffListInit(&addresses);
         FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreate();
         if (!ffReadFileBuffer("/proc/net/if_inet6", &buffer)) {
+            ffThreadMutexUnlock(&mutex);
             return result;
         }
 
@@ -193,6 +197,7 @@ static FFLocalIpIpv6Type getIpv6Type(struct ifaddrs* ifa) {
             }
         }
     }
+    ffThreadMutexUnlock(&mutex);
     if (addresses.capacity == 0) {
         return result;
     }
@@ -1,5 +1,6 @@
 #include "media.h"
 #include "common/io.h"
+#include "common/thread.h"
 
 void ffDetectMediaImpl(FFMediaResult* media, bool saveCover);
 
@@ -13,6 +14,8 @@ static void removeMediaCoverFile(void) {
 }
 
 const FFMediaResult* ffDetectMedia(bool saveCover) {
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
     if (result.error.chars == NULL) {
         ffStrbufInit(&result.error);
         ffStrbufInit(&result.playerId);
@@ -40,6 +43,7 @@ const FFMediaResult* ffDetectMedia(bool saveCover) {
             atexit(removeMediaCoverFile);
         }
     }
+    ffThreadMutexUnlock(&mutex);
 
     return &result;
 }
@@ -19,6 +19,19 @@ void ffPrepareNetIO(FFNetIOOptions* options) {
     time1 = ffTimeGetNow();
 }
 
+// The baseline may have been detected with different options, e.g. by `fastfetch --daemon`
+static bool isSameBaseline(const FFlist* result) {
+    if (result->length != ioCounters1.length) {
+        return false;
+    }
+    for (uint32_t i = 0; i < result->length; ++i) {
+        if (!ffStrbufEqual(&FF_LIST_GET(FFNetIOResult, ioCounters1, i)->name, &FF_LIST_GET(FFNetIOResult, *result, i)->name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 const char* ffDetectNetIO(FFlist* result, FFNetIOOptions* options) {
     const char* error = NULL;
 
@@ -43,7 +56,10 @@ const char* ffDetectNetIO(FFlist* result, FFNetIOOptions* options) {
         return "No network interfaces found";
     }
 
-    uint64_t time2 = ffTimeGetNow();
+    bool rebased = false;
+    uint64_t time2;
+measure:
+    time2 = ffTimeGetNow();
     while (time2 - time1 < options->waitTime) {
         ffTimeSleep((uint32_t) (options->waitTime - (time2 - time1)));
         time2 = ffTimeGetNow();
@@ -54,6 +70,19 @@ const char* ffDetectNetIO(FFlist* result, FFNetIOOptions* options) {
         return error;
     }
 
+    if (!rebased && !isSameBaseline(result)) {
+        // Use the current counters as the new baseline and measure again
+        FF_LIST_FOR_EACH (FFNetIOResult, counter, ioCounters1) {
+            ffStrbufDestroy(&counter->name);
+        }
+        ffListDestroy(&ioCounters1);
+        ioCounters1 = *result;
+        ffListInit(result);
+        time1 = time2;
+        rebased = true;
+        goto measure;
+    }
+
     if (result->length != ioCounters1.length) {
         return "Different number of network interfaces. Network change?";
     }
@@ -71,7 +100,7 @@ const char* ffDetectNetIO(FFlist* result, FFNetIOOptions* options) {
             uint64_t* currValue = (uint64_t*) ((uint8_t*) icCurr + off);
             uint64_t temp = *currValue;
             *currValue -= *prevValue;
-            *currValue /= (time2 - time1) / 1000 /* seconds */;
+            *currValue = *currValue * 1000 / (time2 - time1); // per second
             *prevValue = temp;
         }
     }
@@ -56,7 +56,7 @@ static void getData(FFstrbuf* buffer, const char* ifName, bool isDefaultRoute, i
 }
 
 const char* ffNetIOGetIoCounters(FFlist* result, FFNetIOOptions* options) {
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir("/sys/class/net");
+    FF_AUTO_CLOSE_DIR DIR* dirp = ffOpenDir("/sys/class/net");
     if (!dirp) {
         return "opendir(\"/sys/class/net\") == NULL";
     }
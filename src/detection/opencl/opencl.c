@@ -1,4 +1,5 @@
 #include "detection/opencl/opencl.h"
+#include "common/thread.h"
 #include "detection/gpu/gpu.h"
 
 #if !defined(FF_HAVE_OPENCL) && defined(__APPLE__) && defined(MAC_OS_X_VERSION_10_15)
@@ -199,6 +200,8 @@ static const char* detectOpenCL(FFOpenCLResult* result) {
 FFOpenCLResult* ffDetectOpenCL(void) {
     static FFOpenCLResult result;
     static bool initialized;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
 
     if (!initialized) {
         initialized = true;
@@ -214,5 +217,6 @@ FFOpenCLResult* ffDetectOpenCL(void) {
 #endif
     }
 
+    ffThreadMutexUnlock(&mutex);
     return &result;
 }
@@ -1,9 +1,12 @@
 #include "os.h"
+#include "common/thread.h"
 
 void ffDetectOSImpl(FFOSResult* os);
 
 const FFOSResult* ffDetectOS(void) {
     static FFOSResult result;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
     if (result.name.chars == NULL) {
         ffStrbufInit(&result.name);
         ffStrbufInit(&result.prettyName);
@@ -17,5 +20,6 @@ const FFOSResult* ffDetectOS(void) {
         ffStrbufInit(&result.variantID);
         ffDetectOSImpl(&result);
     }
+    ffThreadMutexUnlock(&mutex);
     return &result;
 }
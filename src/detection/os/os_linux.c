@@ -1,4 +1,5 @@
 #include "os.h"
+#include "common/cache.h"
 #include "common/properties.h"
 #include "common/parsing.h"
 #include "common/io.h"
@@ -369,7 +370,7 @@ static void detectOS(FFOSResult* os) {
     }
 }
 
-void ffDetectOSImpl(FFOSResult* os) {
+static void detectOSImpl(FFOSResult* os) {
     detectOS(os);
 
 #if __linux__ || __GNU__
@@ -395,3 +396,52 @@ void ffDetectOSImpl(FFOSResult* os) {
     }
 #endif
 }
+
+#define FF_OS_CACHE_VERSION 1
+
+static void initCacheKey(FFCache* cache) {
+    ffCacheKeyAddKernelRelease(cache);
+    ffCacheKeyAddS(cache, instance.state.platform.sysinfo.name.chars);
+    ffCacheKeyAddS(cache, getenv("XDG_CONFIG_DIRS"));
+    ffCacheKeyAddS(cache, getenv("BEDROCK_RESTRICT"));
+    ffCacheKeyAddFile(cache, FASTFETCH_TARGET_DIR_ROOT "/bedrock/strata/bedrock/etc/os-release");
+    ffCacheKeyAddFile(cache, FASTFETCH_TARGET_DIR_ETC "/os-release");
+    ffCacheKeyAddFile(cache, FASTFETCH_TARGET_DIR_ETC "/lsb-release");
+    ffCacheKeyAddFile(cache, FASTFETCH_TARGET_DIR_USR "/lib/os-release");
+    ffCacheKeyAddFile(cache, FASTFETCH_TARGET_DIR_ETC "/os-version");
+    ffCacheKeyAddFile(cache, "/etc/debian_version");
+    ffCacheKeyAddFile(cache, "/etc/rpi-issue");
+    ffCacheKeyAddFile(cache, "/boot/dietpi/.version");
+    ffCacheKeyAddFile(cache, "/var/lib/dpkg/status"); // Flavour detection of Debian derivatives
+}
+
+void ffDetectOSImpl(FFOSResult* os) {
+    FFstrbuf* fields[] = {
+        &os->name, &os->prettyName, &os->id, &os->idLike, &os->variant,
+        &os->variantID, &os->version, &os->versionID, &os->codename, &os->buildID,
+    };
+
+    FF_A_CLEANUP(ffCacheDestroy) FFCache cache;
+    ffCacheInit(&cache);
+    initCacheKey(&cache);
+
+    if (ffCacheLoad(&cache, "os", FF_OS_CACHE_VERSION)) {
+        bool ok = true;
+        for (uint32_t i = 0; ok && i < ARRAY_SIZE(fields); ++i) {
+            ok = ffCacheGetStrbuf(&cache, fields[i]);
+        }
+        if (ok) {
+            return;
+        }
+        for (uint32_t i = 0; i < ARRAY_SIZE(fields); ++i) {
+            ffStrbufClear(fields[i]);
+        }
+    }
+
+    detectOSImpl(os);
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(fields); ++i) {
+        ffCachePutStrbuf(&cache, fields[i]);
+    }
+    ffCacheStore(&cache, "os", FF_OS_CACHE_VERSION);
+}
@@ -1,18 +1,23 @@
 #include "packages.h"
 #include "common/io.h"
-#include "common/time.h"
+#include "common/thread.h"
 
-#include <inttypes.h>
 #include <stddef.h>
 
-#ifdef __APPLE__
-    #define st_mtim st_mtimespec
+#ifndef _WIN32
+    #include <sys/mman.h>
 #endif
 
 void ffDetectPackagesImpl(FFPackagesResult* result, FFPackagesOptions* options);
+#ifndef _WIN32
+static void flushPackagesCache(void);
+#endif
 
 const char* ffDetectPackages(FFPackagesResult* result, FFPackagesOptions* options) {
     ffDetectPackagesImpl(result, options);
+#ifndef _WIN32
+    flushPackagesCache();
+#endif
 
     for (uint32_t i = 0; i < offsetof(FFPackagesResult, all) / sizeof(uint32_t); ++i) {
         result->all += ((uint32_t*) result)[i];
@@ -21,70 +26,211 @@ const char* ffDetectPackages(FFPackagesResult* result, FFPackagesOptions* option
     return NULL;
 }
 
-bool ffPackagesReadCache(FFstrbuf* cacheDir, FFstrbuf* cacheContent, const char* filePath, const char* packageId, uint32_t* result) {
 #ifndef _WIN32
+    #ifdef __APPLE__
+        #define st_mtim st_mtimespec
+    #endif
+
+    #define FF_PACKAGES_CACHE_MAGIC "FFPK"
+    #define FF_PACKAGES_CACHE_VERSION 2
+
+// `<cacheDir>/fastfetch/packages.bin`: FFPackagesCacheHeader | FFPackagesCacheEntry[length]
+typedef struct FFPackagesCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t length;
+    uint32_t reserved;
+} FFPackagesCacheHeader;
+
+// Shared by all threads. The file is mapped once, updated entries are written back by `ffDetectPackages`
+static struct {
+    bool loaded;
+    const FFPackagesCacheEntry* entries; // Mapped from the cache file
+    uint32_t length;
+    size_t mappedSize;
+    FFlist updates; // FFPackagesCacheEntry
+} packagesCache;
+
+    #ifdef FF_HAVE_THREADS
+static FFThreadMutex packagesCacheMutex = FF_THREAD_MUTEX_INITIALIZER;
+    #endif
+
+static void getPackagesCachePath(FFstrbuf* path) {
+    ffStrbufSet(path, &instance.state.platform.cacheDir);
+    ffStrbufEnsureEndsWithC(path, '/');
+    ffStrbufAppendS(path, "fastfetch/packages.bin");
+}
+
+static void loadPackagesCache(void) {
+    packagesCache.loaded = true;
+    ffListInit(&packagesCache.updates);
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getPackagesCachePath(&path);
+    FF_AUTO_CLOSE_FD int fd = open(path.chars, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+
     struct stat st;
-    if (stat(filePath, &st) < 0) // file doesn't exist or isn't accessible
-    {
-        *result = 0;
-        return true;
+    if (fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(FFPackagesCacheHeader)) {
+        return;
     }
 
-    if (__builtin_expect(st.st_mtim.tv_sec <= 0, false)) {
-        return false;
+    void* data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return;
     }
 
-    uint64_t mtime_current = (uint64_t) st.st_mtim.tv_sec * 1000ull + (uint64_t) st.st_mtim.tv_nsec / 1000000ull;
-#else
-    FF_AUTO_CLOSE_FD HANDLE handle = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    const FFPackagesCacheHeader* header = data;
+    if (memcmp(header->magic, FF_PACKAGES_CACHE_MAGIC, sizeof(header->magic)) != 0 || header->version != FF_PACKAGES_CACHE_VERSION ||
+        (size_t) st.st_size != sizeof(*header) + header->length * sizeof(FFPackagesCacheEntry)) {
+        munmap(data, (size_t) st.st_size);
+        return;
+    }
+
+    packagesCache.entries = (const FFPackagesCacheEntry*) (header + 1);
+    packagesCache.length = header->length;
+    packagesCache.mappedSize = (size_t) st.st_size;
+}
+
+// FNV-1a
+uint64_t ffPackagesCacheHashKey(const char* packageId, const char* filePath) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char* p = packageId; *p; ++p) {
+        hash = (hash ^ (uint8_t) *p) * 1099511628211ULL;
+    }
+    hash = (hash ^ '\0') * 1099511628211ULL;
+    for (const char* p = filePath; *p; ++p) {
+        hash = (hash ^ (uint8_t) *p) * 1099511628211ULL;
+    }
+    return hash;
+}
 
-    if (handle == INVALID_HANDLE_VALUE) // file doesn't exist or isn't accessible
-    {
+bool ffPackagesFindCache(uint64_t pathHash, FFPackagesCacheEntry* result) {
+    bool found = false;
+    #ifdef FF_HAVE_THREADS
+    ffThreadMutexLock(&packagesCacheMutex);
+    #endif
+    if (!packagesCache.loaded) {
+        loadPackagesCache();
+    }
+    for (uint32_t i = 0; i < packagesCache.length; ++i) {
+        if (packagesCache.entries[i].pathHash == pathHash) {
+            *result = packagesCache.entries[i];
+            found = true;
+            break;
+        }
+    }
+    #ifdef FF_HAVE_THREADS
+    ffThreadMutexUnlock(&packagesCacheMutex);
+    #endif
+    return found;
+}
+
+bool ffPackagesReadCache(FFPackagesCacheEntry* entry, const char* filePath, const char* packageId, uint32_t* result) {
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    struct stat st;
+    if (stat(ffIoResolvePath(filePath, false, &rooted), &st) < 0) { // file doesn't exist or isn't accessible
         *result = 0;
         return true;
     }
 
-    uint64_t mtime_current;
-    FILE_BASIC_INFORMATION fileInfo;
-    IO_STATUS_BLOCK iosb;
-    if (!NT_SUCCESS(NtQueryInformationFile(handle, &iosb, &fileInfo, sizeof(fileInfo), FileBasicInformation))) {
+    *entry = (FFPackagesCacheEntry) {
+        .pathHash = ffPackagesCacheHashKey(packageId, filePath),
+        .mtime = (uint64_t) st.st_mtim.tv_sec * 1000000000ULL + (uint64_t) st.st_mtim.tv_nsec,
+        .inode = (uint64_t) st.st_ino,
+    };
+    if (__builtin_expect(entry->mtime == 0, false)) {
         return false;
     }
 
-    mtime_current = ffFileTimeToUnixMs((uint64_t) fileInfo.LastWriteTime.QuadPart);
-#endif
-
-    ffStrbufSet(cacheDir, &instance.state.platform.cacheDir);
-    ffStrbufEnsureEndsWithC(cacheDir, '/');
-    ffStrbufAppendF(cacheDir, "fastfetch/packages/%s.txt", packageId);
-
-    if (ffReadFileBuffer(cacheDir->chars, cacheContent)) {
-        uint64_t mtime_cached;
-        uint32_t num_cached;
-        if (sscanf(cacheContent->chars, "%" SCNu64 " %" SCNu32, &mtime_cached, &num_cached) == 2 &&
-            mtime_cached == mtime_current && num_cached > 0) {
-            *result = num_cached;
-            return true;
-        }
+    FFPackagesCacheEntry cached;
+    if (ffPackagesFindCache(entry->pathHash, &cached) && cached.mtime == entry->mtime && cached.inode == entry->inode && cached.count > 0) {
+        *result = cached.count;
+        return true;
     }
+    return false;
+}
 
-    ffStrbufSetF(cacheContent, "%" PRIu64 " ", mtime_current);
+void ffPackagesWriteCache(FFPackagesCacheEntry* entry, uint32_t count) {
+    if (__builtin_expect(entry->mtime == 0, false)) {
+        return;
+    }
+    entry->count = count;
 
-    return false;
+    #ifdef FF_HAVE_THREADS
+    ffThreadMutexLock(&packagesCacheMutex);
+    #endif
+    *FF_LIST_ADD(FFPackagesCacheEntry, packagesCache.updates) = *entry;
+    #ifdef FF_HAVE_THREADS
+    ffThreadMutexUnlock(&packagesCacheMutex);
+    #endif
 }
 
-bool ffPackagesWriteCache(FFstrbuf* cacheDir, FFstrbuf* cacheContent, uint32_t num_elements) {
-    if (__builtin_expect(cacheContent->length == 0, false)) {
-        return false;
+// Replaces the cache file with the mapped entries merged with the updated ones
+static void writePackagesCache(void) {
+    FFPackagesCacheHeader header = {
+        .magic = FF_PACKAGES_CACHE_MAGIC,
+        .version = FF_PACKAGES_CACHE_VERSION,
+    };
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreateA((uint32_t) (sizeof(header) + (packagesCache.length + packagesCache.updates.length) * sizeof(FFPackagesCacheEntry)));
+    ffStrbufAppendNS(&content, sizeof(header), (const char*) &header);
+
+    for (uint32_t i = 0; i < packagesCache.length; ++i) {
+        const FFPackagesCacheEntry* cached = &packagesCache.entries[i];
+        bool updated = false;
+        FF_LIST_FOR_EACH (FFPackagesCacheEntry, entry, packagesCache.updates) {
+            if (entry->pathHash == cached->pathHash) {
+                updated = true;
+                break;
+            }
+        }
+        if (!updated) {
+            ffStrbufAppendNS(&content, sizeof(*cached), (const char*) cached);
+            ++header.length;
+        }
     }
+    FF_LIST_FOR_EACH (FFPackagesCacheEntry, entry, packagesCache.updates) {
+        ffStrbufAppendNS(&content, sizeof(*entry), (const char*) entry);
+        ++header.length;
+    }
+    memcpy(content.chars, &header, sizeof(header));
 
-    ffStrbufAppendF(cacheContent, "%" PRIu32, num_elements);
-    return ffWriteFileBuffer(cacheDir->chars, cacheContent);
+    // Written to a temporary file first, so that concurrent runs never map a partially written cache
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getPackagesCachePath(&path);
+    FF_STRBUF_AUTO_DESTROY tempPath = ffStrbufCreateCopy(&path);
+    ffStrbufAppendF(&tempPath, ".%d.tmp", (int) getpid());
+    if (ffWriteFileBuffer(tempPath.chars, &content) && rename(tempPath.chars, path.chars) < 0) {
+        unlink(tempPath.chars);
+    }
+}
+
+static void flushPackagesCache(void) {
+    #ifdef FF_HAVE_THREADS
+    ffThreadMutexLock(&packagesCacheMutex);
+    #endif
+    if (packagesCache.loaded) {
+        if (packagesCache.updates.length > 0) {
+            writePackagesCache();
+        }
+        if (packagesCache.entries) {
+            munmap((void*) ((const FFPackagesCacheHeader*) packagesCache.entries - 1), packagesCache.mappedSize);
+        }
+        ffListDestroy(&packagesCache.updates);
+        packagesCache.loaded = false;
+        packagesCache.entries = NULL;
+        packagesCache.length = 0;
+        packagesCache.mappedSize = 0;
+    }
+    #ifdef FF_HAVE_THREADS
+    ffThreadMutexUnlock(&packagesCacheMutex);
+    #endif
 }
 
-#ifndef _WIN32
 uint32_t ffPackagesGetNumElements(const char* dirname, bool isdir) {
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir(dirname);
+    FF_AUTO_CLOSE_DIR DIR* dirp = ffOpenDir(dirname);
     if (dirp == NULL) {
         return 0;
     }
@@ -116,4 +262,158 @@ uint32_t ffPackagesGetNumElements(const char* dirname, bool isdir) {
 
     return num_elements;
 }
+
+// Counts non-overlapping occurrences of a needle, like repeated `memmem` calls.
+// Blocks are filtered by comparing their bytes with the first and the last byte of the needle at once (see http://0x80.pl/articles/simd-strfind.html),
+// only candidates matching both are compared in full
+typedef struct FFNeedleScan {
+    const char* data;
+    size_t length;
+    const char* needle;
+    size_t needleLength;
+    size_t next; // Matches must not start before this offset
+    uint32_t count;
+} FFNeedleScan;
+
+// `mask`: one bit per candidate, starting at `data + offset`
+static inline void scanCandidates(FFNeedleScan* scan, size_t offset, uint64_t mask) {
+    while (mask) {
+        size_t candidate = offset + (size_t) __builtin_ctzll(mask);
+        mask &= mask - 1;
+        if (candidate >= scan->next &&
+            (scan->needleLength <= 2 || memcmp(scan->data + candidate + 1, scan->needle + 1, scan->needleLength - 2) == 0)) {
+            ++scan->count;
+            scan->next = candidate + scan->needleLength;
+        }
+    }
+}
+
+    #if defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))
+        #include <immintrin.h>
+
+// Returns the offset where the scalar scan has to continue
+static size_t scanSSE2(FFNeedleScan* scan) {
+    const __m128i first = _mm_set1_epi8(scan->needle[0]);
+    const __m128i last = _mm_set1_epi8(scan->needle[scan->needleLength - 1]);
+    size_t offset = 0;
+    for (; offset + scan->needleLength - 1 + sizeof(__m128i) <= scan->length; offset += sizeof(__m128i)) {
+        __m128i blockFirst = _mm_loadu_si128((const __m128i*) (scan->data + offset));
+        __m128i blockLast = _mm_loadu_si128((const __m128i*) (scan->data + offset + scan->needleLength - 1));
+        __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last));
+        scanCandidates(scan, offset, (uint32_t) _mm_movemask_epi8(eq));
+    }
+    return offset;
+}
+
+        #ifndef __AVX2__
+__attribute__((target("avx2")))
+        #endif
+static size_t scanAVX2(FFNeedleScan* scan) {
+    const __m256i first = _mm256_set1_epi8(scan->needle[0]);
+    const __m256i last = _mm256_set1_epi8(scan->needle[scan->needleLength - 1]);
+    size_t offset = 0;
+    for (; offset + scan->needleLength - 1 + sizeof(__m256i) <= scan->length; offset += sizeof(__m256i)) {
+        __m256i blockFirst = _mm256_loadu_si256((const __m256i*) (scan->data + offset));
+        __m256i blockLast = _mm256_loadu_si256((const __m256i*) (scan->data + offset + scan->needleLength - 1));
+        __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last));
+        scanCandidates(scan, offset, (uint32_t) _mm256_movemask_epi8(eq));
+    }
+    return offset;
+}
+
+static size_t scanSIMD(FFNeedleScan* scan) {
+        #ifndef __AVX2__
+    if (!__builtin_cpu_supports("avx2")) {
+        return scanSSE2(scan);
+    }
+        #endif
+    return scanAVX2(scan);
+}
+    #elif defined(__aarch64__) && defined(__ARM_NEON)
+        #include <arm_neon.h>
+
+static size_t scanSIMD(FFNeedleScan* scan) {
+    const uint8x16_t first = vdupq_n_u8((uint8_t) scan->needle[0]);
+    const uint8x16_t last = vdupq_n_u8((uint8_t) scan->needle[scan->needleLength - 1]);
+    size_t offset = 0;
+    for (; offset + scan->needleLength - 1 + sizeof(uint8x16_t) <= scan->length; offset += sizeof(uint8x16_t)) {
+        uint8x16_t blockFirst = vld1q_u8((const uint8_t*) scan->data + offset);
+        uint8x16_t blockLast = vld1q_u8((const uint8_t*) scan->data + offset + scan->needleLength - 1);
+        uint8x16_t eq = vandq_u8(vceqq_u8(blockFirst, first), vceqq_u8(blockLast, last));
+        // Narrow every byte to 4 bits, then keep one bit per byte
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0) & 0x1111111111111111ULL;
+        while (mask) {
+            uint32_t bit = (uint32_t) __builtin_ctzll(mask);
+            mask &= mask - 1;
+            scanCandidates(scan, offset + bit / 4, 1);
+        }
+    }
+    return offset;
+}
+    #else
+static size_t scanSIMD(FF_A_UNUSED FFNeedleScan* scan) {
+    return 0;
+}
+    #endif
+
+static uint32_t countNeedles(const char* data, size_t length, const char* needle) {
+    FFNeedleScan scan = {
+        .data = data,
+        .length = length,
+        .needle = needle,
+        .needleLength = strlen(needle),
+    };
+    if (scan.needleLength == 0 || scan.needleLength > length) {
+        return 0;
+    }
+
+    size_t offset = scanSIMD(&scan);
+    if (offset < scan.next) {
+        offset = scan.next;
+    }
+
+    const char* iter = data + offset;
+    while ((iter = memmem(iter, length - (size_t) (iter - data), needle, scan.needleLength)) != NULL) {
+        ++scan.count;
+        iter += scan.needleLength;
+    }
+    return scan.count;
+}
+
+uint32_t ffPackagesCountStrings(const char* fileName, const char* needle) {
+    FF_TRACE_SCOPE("io", "mmap", fileName);
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    fileName = ffIoResolvePath(fileName, false, &rooted);
+    FF_AUTO_CLOSE_FD int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        return 0;
+    }
+
+    if (!S_ISREG(st.st_mode) || st.st_size <= 0) {
+        // Not mappable, e.g. a file in procfs
+        FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+        if (!ffAppendFDBuffer(fd, &content)) {
+            return 0;
+        }
+        return countNeedles(content.chars, content.length, needle);
+    }
+
+    size_t length = (size_t) st.st_size;
+    void* data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return 0;
+    }
+    #ifdef MADV_SEQUENTIAL
+    madvise(data, length, MADV_SEQUENTIAL);
+    #endif
+
+    uint32_t count = countNeedles(data, length, needle);
+    munmap(data, length);
+    return count;
+}
 #endif
@@ -52,15 +52,35 @@ typedef struct FFPackagesResult {
     uint32_t all; // Make sure this goes last
 
     FFstrbuf pacmanBranch;
+
+    double elapsed[FF_PACKAGES_FLAG_COUNT]; // Milliseconds spent probing each package manager, indexed by the bit of its flag
 } FFPackagesResult;
 
 const char* ffDetectPackages(FFPackagesResult* result, FFPackagesOptions* options);
-bool ffPackagesReadCache(FFstrbuf* cacheDir, FFstrbuf* cacheContent, const char* filePath, const char* packageId, uint32_t* result);
-bool ffPackagesWriteCache(FFstrbuf* cacheDir, FFstrbuf* cacheContent, uint32_t num_elements);
 
 #if defined(__linux__) || defined(__APPLE__) || defined(__GNU__)
-uint32_t ffPackagesGetNix(FFstrbuf* baseDir, const char* dirname);
+// Queues the nix profile `baseDir + dirname` if it exists. Its package count is added to `*count` by `ffPackagesCountNix`
+void ffPackagesAddNix(FFlist* profiles, FFstrbuf* baseDir, const char* dirname, uint32_t* count);
+// Counts all queued profiles concurrently
+void ffPackagesCountNix(FFlist* profiles);
 #endif
 #ifndef _WIN32
+// A record of the package count cache, which is shared by all backends
+typedef struct FFPackagesCacheEntry {
+    uint64_t pathHash; // Of the package id and the source path
+    uint64_t mtime;    // Of the source in ns, or a fingerprint of the mtimes of a directory tree
+    uint64_t inode;    // Of the source
+    uint32_t count;
+    uint32_t depth; // Of the directory tree covered by the fingerprint, 0 for single files
+} FFPackagesCacheEntry;
+
+uint64_t ffPackagesCacheHashKey(const char* packageId, const char* filePath);
+// Copies the cached record of `pathHash` to `result`, without validating it
+bool ffPackagesFindCache(uint64_t pathHash, FFPackagesCacheEntry* result);
+// Returns true if the count of `filePath` is cached or the file doesn't exist. Otherwise `entry` is prepared for `ffPackagesWriteCache`
+bool ffPackagesReadCache(FFPackagesCacheEntry* entry, const char* filePath, const char* packageId, uint32_t* result);
+void ffPackagesWriteCache(FFPackagesCacheEntry* entry, uint32_t count);
 uint32_t ffPackagesGetNumElements(const char* dirname, bool isdir);
+// Counts non-overlapping occurrences of `needle` in the file, which is memory-mapped rather than read
+uint32_t ffPackagesCountStrings(const char* fileName, const char* needle);
 #endif
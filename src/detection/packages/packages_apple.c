@@ -48,9 +48,11 @@ void ffDetectPackagesImpl(FFPackagesResult* result, FFPackagesOptions* options)
     }
     if (!(options->disabled & FF_PACKAGES_FLAG_NIX_BIT)) {
         ffStrbufSetS(&baseDir, FASTFETCH_TARGET_DIR_ROOT);
-        result->nixDefault += ffPackagesGetNix(&baseDir, "/nix/var/nix/profiles/default");
-        result->nixSystem += ffPackagesGetNix(&baseDir, "/run/current-system");
+        FF_LIST_AUTO_DESTROY nixProfiles = ffListCreate();
+        ffPackagesAddNix(&nixProfiles, &baseDir, "/nix/var/nix/profiles/default", &result->nixDefault);
+        ffPackagesAddNix(&nixProfiles, &baseDir, "/run/current-system", &result->nixSystem);
         ffStrbufSet(&baseDir, &instance.state.platform.homeDir);
-        result->nixUser = ffPackagesGetNix(&baseDir, "/.nix-profile");
+        ffPackagesAddNix(&nixProfiles, &baseDir, "/.nix-profile", &result->nixUser);
+        ffPackagesCountNix(&nixProfiles);
     }
 }
@@ -3,17 +3,15 @@
 #include "common/settings.h"
 
 static uint32_t getSQLite3Int(const char* dbPath, const char* query, const char* packageId) {
-    FF_STRBUF_AUTO_DESTROY cacheDir = ffStrbufCreate();
-    FF_STRBUF_AUTO_DESTROY cacheContent = ffStrbufCreate();
-
+    FFPackagesCacheEntry cacheEntry;
     uint32_t num_elements;
-    if (ffPackagesReadCache(&cacheDir, &cacheContent, dbPath, packageId, &num_elements)) {
+    if (ffPackagesReadCache(&cacheEntry, dbPath, packageId, &num_elements)) {
         return num_elements;
     }
 
     num_elements = (uint32_t) ffSettingsGetSQLite3Int(dbPath, query);
 
-    ffPackagesWriteCache(&cacheDir, &cacheContent, num_elements);
+    ffPackagesWriteCache(&cacheEntry, num_elements);
 
     return num_elements;
 }
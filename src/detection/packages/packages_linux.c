@@ -1,53 +1,49 @@
 #include "packages.h"
 #include "common/io.h"
+#include "common/mallocHelper.h"
 #include "common/parsing.h"
 #include "common/properties.h"
 #include "common/settings.h"
 #include "common/stringUtils.h"
+#include "common/thread.h"
+#include "common/time.h"
+#include "common/trace.h"
 #include "detection/os/os.h"
 
+#include <endian.h>
+#include <sys/syscall.h>
+
+// Cached against the mtime of the directory, which changes whenever a package is added or removed
 static uint32_t getNumElements(FFstrbuf* baseDir, const char* dirname, bool isdir) {
     uint32_t baseDirLength = baseDir->length;
     ffStrbufAppendS(baseDir, dirname);
-    uint32_t num_elements = ffPackagesGetNumElements(baseDir->chars, isdir);
-    ffStrbufSubstrBefore(baseDir, baseDirLength);
-    return num_elements;
-}
-
-static uint32_t getNumStringsImpl(const char* filename, const char* needle) {
-    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
-    if (!ffReadFileBuffer(filename, &content)) {
-        return 0;
-    }
 
-    uint32_t count = 0;
-    char* iter = content.chars;
-    size_t needleLength = strlen(needle);
-    while ((iter = memmem(iter, content.length - (size_t) (iter - content.chars), needle, needleLength)) != NULL) {
-        ++count;
-        iter += needleLength;
+    FFPackagesCacheEntry cacheEntry;
+    uint32_t num_elements;
+    if (!ffPackagesReadCache(&cacheEntry, baseDir->chars, isdir ? "dirs" : "files", &num_elements)) {
+        num_elements = ffPackagesGetNumElements(baseDir->chars, isdir);
+        ffPackagesWriteCache(&cacheEntry, num_elements);
     }
 
-    return count;
+    ffStrbufSubstrBefore(baseDir, baseDirLength);
+    return num_elements;
 }
 
 static uint32_t getNumStrings(FFstrbuf* baseDir, const char* filename, const char* needle, const char* packageId) {
     uint32_t baseDirLength = baseDir->length;
     ffStrbufAppendS(baseDir, filename);
 
-    FF_STRBUF_AUTO_DESTROY cacheDir = ffStrbufCreate();
-    FF_STRBUF_AUTO_DESTROY cacheContent = ffStrbufCreate();
-
+    FFPackagesCacheEntry cacheEntry;
     uint32_t num_elements;
-    if (ffPackagesReadCache(&cacheDir, &cacheContent, baseDir->chars, packageId, &num_elements)) {
+    if (ffPackagesReadCache(&cacheEntry, baseDir->chars, packageId, &num_elements)) {
         ffStrbufSubstrBefore(baseDir, baseDirLength);
         return num_elements;
     }
 
-    num_elements = getNumStringsImpl(baseDir->chars, needle);
+    num_elements = ffPackagesCountStrings(baseDir->chars, needle);
     ffStrbufSubstrBefore(baseDir, baseDirLength);
 
-    ffPackagesWriteCache(&cacheDir, &cacheContent, num_elements);
+    ffPackagesWriteCache(&cacheEntry, num_elements);
 
     return num_elements;
 }
@@ -56,11 +52,9 @@ static uint32_t getSQLite3Int(FFstrbuf* baseDir, const char* dbPath, const char*
     uint32_t baseDirLength = baseDir->length;
     ffStrbufAppendS(baseDir, dbPath);
 
-    FF_STRBUF_AUTO_DESTROY cacheDir = ffStrbufCreate();
-    FF_STRBUF_AUTO_DESTROY cacheContent = ffStrbufCreate();
-
+    FFPackagesCacheEntry cacheEntry;
     uint32_t num_elements;
-    if (ffPackagesReadCache(&cacheDir, &cacheContent, baseDir->chars, packageId, &num_elements)) {
+    if (ffPackagesReadCache(&cacheEntry, baseDir->chars, packageId, &num_elements)) {
         ffStrbufSubstrBefore(baseDir, baseDirLength);
         return num_elements;
     }
@@ -68,60 +62,240 @@ static uint32_t getSQLite3Int(FFstrbuf* baseDir, const char* dbPath, const char*
     num_elements = (uint32_t) ffSettingsGetSQLite3Int(baseDir->chars, query);
     ffStrbufSubstrBefore(baseDir, baseDirLength);
 
-    ffPackagesWriteCache(&cacheDir, &cacheContent, num_elements);
+    ffPackagesWriteCache(&cacheEntry, num_elements);
 
     return num_elements;
 }
 
-static uint32_t countFilesRecursiveImpl(FFstrbuf* baseDirPath, const char* filename) {
-    uint32_t baseDirPathLength = baseDirPath->length;
+// Recursive counting of directories containing a marker file, for emerge and paludis
 
-    ffStrbufAppendC(baseDirPath, '/');
-    ffStrbufAppendS(baseDirPath, filename);
-    bool exists = ffPathExists(baseDirPath->chars, FF_PATHTYPE_FILE);
-    ffStrbufSubstrBefore(baseDirPath, baseDirPathLength);
-    if (exists) {
-        return 1;
-    }
+#define FF_PACKAGES_WALK_MAX_DEPTH 8
 
-    DIR* dirp = opendir(baseDirPath->chars);
-    if (dirp == NULL) {
-        return 0;
-    }
+typedef struct FFPackagesWalkResult {
+    uint32_t count;
+    uint32_t depth;                                        // Deepest parent of a counted directory
+    uint64_t fingerprints[FF_PACKAGES_WALK_MAX_DEPTH + 1]; // Of all walked directories, per depth
+} FFPackagesWalkResult;
 
-    ffStrbufAppendC(baseDirPath, '/');
-    baseDirPathLength = baseDirPath->length;
+// Order independent, so that it doesn't depend on the order of directory entries
+static inline uint64_t walkFingerprint(const struct stat* st) {
+    uint64_t x = ((uint64_t) st->st_ino * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t) st->st_mtim.tv_sec * 1000000000ULL + (uint64_t) st->st_mtim.tv_nsec);
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
 
-    uint32_t sum = 0;
+#ifdef __linux__
+    #define FF_DIR_READER_BUFFER_SIZE 32768
+#endif
+
+typedef struct FFDirReader {
+    int fd;
+#ifdef __linux__
+    long length;
+    long offset;
+    char* buffer; // FF_DIR_READER_BUFFER_SIZE bytes. On the heap, as readers live in every frame of the recursive walk
+#else
+    DIR* dir;
+#endif
+} FFDirReader;
+
+#ifdef __linux__
+struct FFLinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+#endif
+
+static void dirReaderInit(FFDirReader* reader, int fd) {
+    reader->fd = fd;
+    lseek(fd, 0, SEEK_SET); // The directory may have been read before
+#ifdef __linux__
+    reader->length = reader->offset = 0;
+    reader->buffer = malloc(FF_DIR_READER_BUFFER_SIZE);
+#else
+    int dupFd = dup(fd);
+    reader->dir = dupFd >= 0 ? fdopendir(dupFd) : NULL;
+#endif
+}
+
+static void dirReaderDestroy(FFDirReader* reader) {
+#ifndef __linux__
+    if (reader->dir) {
+        closedir(reader->dir);
+    }
+#else
+    free(reader->buffer);
+#endif
+}
+
+// Returns the name of the next subdirectory not starting with '.', or NULL
+static const char* dirReaderNextSubdir(FFDirReader* reader) {
+    while (true) {
+        const char* name;
+        unsigned char type;
+#ifdef __linux__
+        // Large batches of entries keep the number of syscalls low
+        if (reader->offset >= reader->length) {
+            reader->length = syscall(SYS_getdents64, reader->fd, reader->buffer, FF_DIR_READER_BUFFER_SIZE);
+            reader->offset = 0;
+            if (reader->length <= 0) {
+                return NULL;
+            }
+        }
+        const struct FFLinuxDirent64* entry = (const struct FFLinuxDirent64*) (reader->buffer + reader->offset);
+        reader->offset += entry->d_reclen;
+        name = entry->d_name;
+        type = entry->d_type;
+#else
+        const struct dirent* entry = reader->dir ? readdir(reader->dir) : NULL;
+        if (!entry) {
+            return NULL;
+        }
+        name = entry->d_name;
+        type = entry->d_type;
+#endif
 
-    struct dirent* entry;
-    while ((entry = readdir(dirp)) != NULL) {
         // According to the PMS, neither category nor package name can begin with '.', so no need to check for . or .. specifically
-        if (entry->d_type != DT_DIR || entry->d_name[0] == '.') {
+        if (name[0] == '.') {
             continue;
         }
+        if (type == DT_DIR) {
+            return name;
+        }
+        struct stat st;
+        if (type == DT_UNKNOWN && fstatat(reader->fd, name, &st, 0) == 0 && S_ISDIR(st.st_mode)) {
+            return name;
+        }
+    }
+}
+
+static bool isMarkerFile(int dfd, const char* filename) {
+    ffIoResolveRelative(dfd, filename);
+    struct stat st;
+    return fstatat(dfd, filename, &st, 0) == 0 && S_ISREG(st.st_mode);
+}
+
+// Takes ownership of `dfd`
+static void walkPackageDir(int dfd, uint32_t depth, const char* filename, FFPackagesWalkResult* result) {
+    if (isMarkerFile(dfd, filename)) {
+        ++result->count;
+        if (depth > 0 && depth - 1 > result->depth) {
+            result->depth = depth - 1;
+        }
+        close(dfd);
+        return;
+    }
+
+    struct stat st;
+    if (depth <= FF_PACKAGES_WALK_MAX_DEPTH && fstat(dfd, &st) == 0) {
+        result->fingerprints[depth] += walkFingerprint(&st);
+    }
+
+    FFDirReader reader;
+    dirReaderInit(&reader, dfd);
+    const char* name;
+    while ((name = dirReaderNextSubdir(&reader)) != NULL) {
+        int subdirFd = openat(dfd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (subdirFd >= 0) {
+            walkPackageDir(subdirFd, depth + 1, filename, result);
+        }
+    }
+    dirReaderDestroy(&reader);
+    close(dfd);
+}
+
+// Fingerprint of all directories up to `maxDepth`, as computed by `walkPackageDir`
+static uint64_t fingerprintPackageDir(int dfd, uint32_t depth, uint32_t maxDepth) {
+    struct stat st;
+    if (fstat(dfd, &st) < 0) {
+        return 0;
+    }
+    uint64_t fingerprint = walkFingerprint(&st);
+
+    if (depth < maxDepth) {
+        FFDirReader reader;
+        dirReaderInit(&reader, dfd);
+        const char* name;
+        while ((name = dirReaderNextSubdir(&reader)) != NULL) {
+            int subdirFd = openat(dfd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (subdirFd >= 0) {
+                fingerprint += fingerprintPackageDir(subdirFd, depth + 1, maxDepth);
+                close(subdirFd);
+            }
+        }
+        dirReaderDestroy(&reader);
+    }
+    return fingerprint;
+}
+
+// Runs inside a packages task, so the walk itself is serial
+static void walkPackageRoot(int rootFd, const char* filename, FFPackagesWalkResult* result) {
+    if (isMarkerFile(rootFd, filename)) {
+        result->count = 1;
+        return;
+    }
 
-        ffStrbufAppendS(baseDirPath, entry->d_name);
-        sum += countFilesRecursiveImpl(baseDirPath, filename);
-        ffStrbufSubstrBefore(baseDirPath, baseDirPathLength);
+    struct stat st;
+    if (fstat(rootFd, &st) == 0) {
+        result->fingerprints[0] = walkFingerprint(&st);
     }
 
-    closedir(dirp);
-    return sum;
+    FFDirReader reader;
+    dirReaderInit(&reader, rootFd);
+    const char* name;
+    while ((name = dirReaderNextSubdir(&reader)) != NULL) {
+        int subdirFd = openat(rootFd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (subdirFd >= 0) {
+            walkPackageDir(subdirFd, 1, filename, result);
+        }
+    }
+    dirReaderDestroy(&reader);
 }
 
-static uint32_t countFilesRecursive(FFstrbuf* baseDir, const char* dirname, const char* filename) {
+// Cached against the mtimes of all directories containing counted directories, which change whenever a package is added or removed
+static uint32_t countFilesRecursive(FFstrbuf* baseDir, const char* dirname, const char* filename, const char* packageId) {
     uint32_t baseDirLength = baseDir->length;
     ffStrbufAppendS(baseDir, dirname);
-    uint32_t sum = countFilesRecursiveImpl(baseDir, filename);
+
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    FF_AUTO_CLOSE_FD int rootFd = open(ffIoResolvePath(baseDir->chars, true, &rooted), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    uint64_t pathHash = ffPackagesCacheHashKey(packageId, baseDir->chars);
     ffStrbufSubstrBefore(baseDir, baseDirLength);
-    return sum;
+    if (rootFd < 0) {
+        return 0;
+    }
+
+    FFPackagesCacheEntry cacheEntry;
+    if (ffPackagesFindCache(pathHash, &cacheEntry) && cacheEntry.count > 0 && cacheEntry.depth <= FF_PACKAGES_WALK_MAX_DEPTH &&
+        fingerprintPackageDir(rootFd, 0, cacheEntry.depth) == cacheEntry.mtime) {
+        return cacheEntry.count;
+    }
+
+    FFPackagesWalkResult result = {};
+    walkPackageRoot(rootFd, filename, &result);
+
+    cacheEntry = (FFPackagesCacheEntry) {
+        .pathHash = pathHash,
+        .depth = result.depth,
+    };
+    for (uint32_t depth = 0; depth <= result.depth && depth <= FF_PACKAGES_WALK_MAX_DEPTH; ++depth) {
+        cacheEntry.mtime += result.fingerprints[depth];
+    }
+    ffPackagesWriteCache(&cacheEntry, result.count);
+
+    return result.count;
 }
 
 static uint32_t getNumElementsBySuffix(FFstrbuf* baseDir, const char* dirname, const char* suffix) {
     uint32_t baseDirLength = baseDir->length;
     ffStrbufAppendS(baseDir, dirname);
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir(baseDir->chars);
+    FF_AUTO_CLOSE_DIR DIR* dirp = ffOpenDir(baseDir->chars);
     ffStrbufSubstrBefore(baseDir, baseDirLength);
     if (dirp == NULL) {
         return 0;
@@ -138,7 +312,7 @@ static uint32_t getNumElementsBySuffix(FFstrbuf* baseDir, const char* dirname, c
 }
 
 static uint32_t getXBPSImpl(FFstrbuf* baseDir) {
-    DIR* dir = opendir(baseDir->chars);
+    DIR* dir = ffOpenDir(baseDir->chars);
     if (dir == NULL) {
         return 0;
     }
@@ -153,7 +327,7 @@ static uint32_t getXBPSImpl(FFstrbuf* baseDir) {
 
         ffStrbufAppendC(baseDir, '/');
         ffStrbufAppendS(baseDir, entry->d_name);
-        result = getNumStringsImpl(baseDir->chars, "<string>installed</string>");
+        result = ffPackagesCountStrings(baseDir->chars, "<string>installed</string>");
         break;
     }
 
@@ -225,9 +399,175 @@ static uint32_t getRpmFromLibrpm(void) {
 
 #endif // FF_HAVE_RPM
 
+// Native readers of the rpm databases not stored in sqlite. Like `rpmdbGetIteratorCount` of librpm,
+// they count all package headers, including the virtual `gpg-pubkey` packages
+
+#define FF_RPM_NDB_MAGIC 0x506d7052      // "RpmP"
+#define FF_RPM_NDB_SLOT_MAGIC 0x746f6c53 // "Slot"
+#define FF_RPM_NDB_HEADER_SIZE 32
+#define FF_RPM_NDB_SLOT_SIZE 16
+#define FF_RPM_NDB_PAGE_SIZE 4096
+
+// ndb (`Packages.db`): a header followed by `slotnpages` pages of slots. Every used slot refers to a package header blob
+static uint32_t countRpmNdb(const char* path) {
+    uint32_t header[FF_RPM_NDB_HEADER_SIZE / sizeof(uint32_t)]; // magic, version, generation, slotnpages, nextpkgidx
+    if (ffReadFileData(path, sizeof(header), header) != (ssize_t) sizeof(header) ||
+        le32toh(header[0]) != FF_RPM_NDB_MAGIC || le32toh(header[1]) != 0) {
+        return 0;
+    }
+
+    uint32_t slotPages = le32toh(header[3]);
+    if (slotPages == 0 || slotPages > 2048) {
+        return 0;
+    }
+
+    size_t size = (size_t) slotPages * FF_RPM_NDB_PAGE_SIZE;
+    FF_AUTO_FREE uint32_t* slots = malloc(size);
+    if (ffReadFileData(path, size, slots) != (ssize_t) size) {
+        return 0;
+    }
+
+    uint32_t count = 0;
+    // The first slots are occupied by the header. A slot is: magic, pkgidx, blkoff, blkcnt
+    for (size_t i = FF_RPM_NDB_HEADER_SIZE / sizeof(uint32_t); i < size / sizeof(uint32_t); i += FF_RPM_NDB_SLOT_SIZE / sizeof(uint32_t)) {
+        if (le32toh(slots[i]) == FF_RPM_NDB_SLOT_MAGIC && slots[i + 1] != 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+#define FF_BDB_HASH_MAGIC 0x061561
+#define FF_BDB_PAGE_HEADER_SIZE 26
+#define FF_BDB_P_HASH_UNSORTED 2
+#define FF_BDB_P_HASH 13
+#define FF_BDB_H_KEYDATA 1
+
+typedef struct FFBdbReader {
+    int fd;
+    bool swapped; // Written on a machine with different endianness
+    uint32_t pageSize;
+    uint8_t* page;
+} FFBdbReader;
+
+static inline uint32_t bdbRead32(const FFBdbReader* reader, const uint8_t* data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return reader->swapped ? __builtin_bswap32(value) : value;
+}
+
+static inline uint16_t bdbRead16(const FFBdbReader* reader, const uint8_t* data) {
+    uint16_t value;
+    memcpy(&value, data, sizeof(value));
+    return reader->swapped ? __builtin_bswap16(value) : value;
+}
+
+static bool bdbReadPage(FFBdbReader* reader, uint32_t pgno) {
+    return pread(reader->fd, reader->page, reader->pageSize, (off_t) pgno * reader->pageSize) == (ssize_t) reader->pageSize;
+}
+
+// Counts the keys of a hash page, except the record 0 used by rpm to store the next header instance
+static uint32_t bdbCountHashKeys(const FFBdbReader* reader) {
+    uint32_t count = 0;
+    uint16_t entries = bdbRead16(reader, reader->page + 20);
+    // Entries are key/data pairs. `inp` holds the offsets of the items, which are stored from the end of the page
+    for (uint16_t i = 0; i + 1 < entries; i += 2) {
+        uint16_t offset = bdbRead16(reader, reader->page + FF_BDB_PAGE_HEADER_SIZE + i * sizeof(uint16_t));
+        uint16_t end = i == 0 ? (uint16_t) reader->pageSize : bdbRead16(reader, reader->page + FF_BDB_PAGE_HEADER_SIZE + (i - 1) * sizeof(uint16_t));
+        if (offset >= end || end > reader->pageSize || reader->page[offset] != FF_BDB_H_KEYDATA) {
+            continue;
+        }
+
+        uint32_t key = 0;
+        uint16_t keyLength = (uint16_t) (end - offset - 1);
+        memcpy(&key, reader->page + offset + 1, keyLength < sizeof(key) ? keyLength : sizeof(key));
+        if (key != 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Berkeley DB hash (legacy `Packages`): walks the pages of every bucket. Package headers are stored in overflow pages, which are never read
+static uint32_t countRpmBdb(const char* path) {
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    FF_AUTO_CLOSE_FD int fd = open(ffIoResolvePath(path, false, &rooted), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return 0;
+    }
+
+    // Hash meta page: DBMETA, then max_bucket at 72, spares[32] at 96
+    uint8_t meta[224];
+    if (pread(fd, meta, sizeof(meta), 0) != (ssize_t) sizeof(meta)) {
+        return 0;
+    }
+
+    FFBdbReader reader = { .fd = fd };
+    uint32_t magic;
+    memcpy(&magic, meta + 12, sizeof(magic));
+    if (magic != FF_BDB_HASH_MAGIC) {
+        reader.swapped = true;
+        if (bdbRead32(&reader, meta + 12) != FF_BDB_HASH_MAGIC) {
+            return 0;
+        }
+    }
+
+    // Checksummed or encrypted pages have a different layout
+    reader.pageSize = bdbRead32(&reader, meta + 20);
+    if (meta[24] != 0 || (meta[26] & 0x01) || reader.pageSize < 512 || reader.pageSize > 65536) {
+        return 0;
+    }
+
+    FF_AUTO_FREE uint8_t* page = malloc(reader.pageSize);
+    reader.page = page;
+
+    uint32_t lastPgno = bdbRead32(&reader, meta + 32);
+    uint32_t maxBucket = bdbRead32(&reader, meta + 72);
+    uint32_t count = 0;
+    for (uint32_t bucket = 0; bucket <= maxBucket; ++bucket) {
+        // BUCKET_TO_PAGE: bucket + spares[ceil(log2(bucket + 1))]
+        uint32_t spare = bucket == 0 ? 0 : 32 - (uint32_t) __builtin_clz(bucket);
+        uint32_t pgno = bucket + bdbRead32(&reader, meta + 96 + spare * sizeof(uint32_t));
+
+        // Buckets overflowing one page are chained. Bounded in case of a corrupted chain
+        for (uint32_t chain = 0; pgno != 0 && pgno <= lastPgno && chain <= lastPgno; ++chain) {
+            if (!bdbReadPage(&reader, pgno)) {
+                return 0;
+            }
+
+            uint8_t type = page[25];
+            if (type != FF_BDB_P_HASH && type != FF_BDB_P_HASH_UNSORTED) {
+                break;
+            }
+            count += bdbCountHashKeys(&reader);
+            pgno = bdbRead32(&reader, page + 16); // next_pgno
+        }
+    }
+    return count;
+}
+
+static uint32_t getRpmDb(FFstrbuf* baseDir, const char* dbPath, const char* packageId, uint32_t (*countPackages)(const char* path)) {
+    uint32_t baseDirLength = baseDir->length;
+    ffStrbufAppendS(baseDir, dbPath);
+
+    FFPackagesCacheEntry cacheEntry;
+    uint32_t num_elements;
+    if (ffPackagesReadCache(&cacheEntry, baseDir->chars, packageId, &num_elements)) {
+        ffStrbufSubstrBefore(baseDir, baseDirLength);
+        return num_elements;
+    }
+
+    num_elements = countPackages(baseDir->chars);
+    ffStrbufSubstrBefore(baseDir, baseDirLength);
+
+    ffPackagesWriteCache(&cacheEntry, num_elements);
+
+    return num_elements;
+}
+
 static uint32_t getAMPackages(FFstrbuf* baseDir) {
     uint32_t baseLength = baseDir->length;
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir(baseDir->chars);
+    FF_AUTO_CLOSE_DIR DIR* dirp = ffOpenDir(baseDir->chars);
     if (!dirp) {
         return 0;
     }
@@ -275,14 +615,13 @@ static uint32_t getAMUser(void) {
     }
 
     // check if $XDG_CONFIG_HOME/appman/appman-config exists
-    FFstrbuf* baseDir = FF_LIST_FIRST(FFstrbuf, instance.state.platform.configDirs);
-    uint32_t baseLen = baseDir->length;
-    ffStrbufAppendS(baseDir, "appman/appman-config");
+    // Copied because other threads may read the config dirs meanwhile
+    FF_STRBUF_AUTO_DESTROY configPath = ffStrbufCreateCopy(FF_LIST_FIRST(FFstrbuf, instance.state.platform.configDirs));
+    ffStrbufAppendS(&configPath, "appman/appman-config");
     FF_STRBUF_AUTO_DESTROY packagesPath = ffStrbufCreate();
-    if (ffReadFileBuffer(baseDir->chars, &packagesPath)) {
+    if (ffReadFileBuffer(configPath.chars, &packagesPath)) {
         ffStrbufTrimRightSpace(&packagesPath);
     }
-    ffStrbufSubstrBefore(baseDir, baseLen);
 
     return packagesPath.length > 0 ? getAMPackages(&packagesPath) : 0;
 }
@@ -325,23 +664,34 @@ static uint32_t getGuixPackages(FFstrbuf* baseDir, const char* dirname) {
     uint32_t baseDirLength = baseDir->length;
     ffStrbufAppendS(baseDir, dirname);
     ffStrbufAppendS(baseDir, "/manifest");
-    uint32_t num_elements = getGuixPackagesImpl(baseDir->chars);
+
+    // Profiles are symlinks to generations, so switching to another one changes the inode
+    FFPackagesCacheEntry cacheEntry;
+    uint32_t num_elements;
+    if (!ffPackagesReadCache(&cacheEntry, baseDir->chars, "guix", &num_elements)) {
+        num_elements = getGuixPackagesImpl(baseDir->chars);
+        ffPackagesWriteCache(&cacheEntry, num_elements);
+    }
+
     ffStrbufSubstrBefore(baseDir, baseDirLength);
     return num_elements;
 }
 
 static inline uint32_t getFlatpakRuntimePackagesArch(FFstrbuf* baseDir) {
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir(baseDir->chars);
+    FF_AUTO_CLOSE_DIR DIR* dirp = ffOpenDir(baseDir->chars);
     if (dirp == NULL) {
         return 0;
     }
 
+    uint32_t runtimeDirLength = baseDir->length;
     uint32_t num_elements = 0;
 
     struct dirent* entry;
     while ((entry = readdir(dirp)) != NULL) {
         if (entry->d_type == DT_DIR && entry->d_name[0] != '.') {
-            num_elements += getNumElements(baseDir, entry->d_name, true);
+            ffStrbufAppendS(baseDir, entry->d_name);
+            num_elements += ffPackagesGetNumElements(baseDir->chars, true);
+            ffStrbufSubstrBefore(baseDir, runtimeDirLength);
         }
     }
 
@@ -350,7 +700,7 @@ static inline uint32_t getFlatpakRuntimePackagesArch(FFstrbuf* baseDir) {
 
 static inline uint32_t getFlatpakRuntimePackages(FFstrbuf* baseDir) {
     ffStrbufAppendS(baseDir, "runtime/");
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir(baseDir->chars);
+    FF_AUTO_CLOSE_DIR DIR* dirp = ffOpenDir(baseDir->chars);
     if (dirp == NULL) {
         return 0;
     }
@@ -384,7 +734,7 @@ static inline uint32_t getFlatpakRuntimePackages(FFstrbuf* baseDir) {
 
 static inline uint32_t getFlatpakAppPackages(FFstrbuf* baseDir) {
     ffStrbufAppendS(baseDir, "app/");
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir(baseDir->chars);
+    FF_AUTO_CLOSE_DIR DIR* dirp = ffOpenDir(baseDir->chars);
     if (dirp == NULL) {
         return 0;
     }
@@ -406,13 +756,48 @@ static inline uint32_t getFlatpakAppPackages(FFstrbuf* baseDir) {
     return num_elements;
 }
 
-static uint32_t getFlatpakPackages(FFstrbuf* baseDir, const char* dirname) {
+// flatpak touches `.changed` of the installation whenever it deploys or uninstalls anything (see `flatpak_dir_mark_changed`).
+// Together with the app and runtime directories it tells whether the traversal would give a different result.
+// Returns 0 if it can't be trusted
+static uint64_t getFlatpakFingerprint(const char* flatpakDir) {
+    FF_STRBUF_AUTO_DESTROY rooted = ffStrbufCreate();
+    FF_AUTO_CLOSE_FD int dfd = open(ffIoResolvePath(flatpakDir, true, &rooted), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd < 0) {
+        return 0;
+    }
+
+    struct stat st;
+    if (fstatat(dfd, ".changed", &st, 0) < 0) {
+        return 0;
+    }
+    uint64_t fingerprint = walkFingerprint(&st);
+
+    if (fstatat(dfd, "app", &st, 0) == 0) {
+        fingerprint += walkFingerprint(&st);
+    }
+    if (fstatat(dfd, "runtime", &st, 0) == 0) {
+        fingerprint += walkFingerprint(&st);
+    }
+    return fingerprint;
+}
+
+static uint32_t getFlatpakPackages(FFstrbuf* baseDir, const char* dirname, const char* packageId) {
     uint32_t num_elements = 0;
     uint32_t baseDirLength = baseDir->length;
     ffStrbufAppendS(baseDir, dirname);
     ffStrbufAppendS(baseDir, "/flatpak/");
     uint32_t flatpakDirLength = baseDir->length;
 
+    FFPackagesCacheEntry cacheEntry = {
+        .pathHash = ffPackagesCacheHashKey(packageId, baseDir->chars),
+        .mtime = getFlatpakFingerprint(baseDir->chars),
+    };
+    FFPackagesCacheEntry cached;
+    if (cacheEntry.mtime != 0 && ffPackagesFindCache(cacheEntry.pathHash, &cached) && cached.mtime == cacheEntry.mtime && cached.count > 0) {
+        ffStrbufSubstrBefore(baseDir, baseDirLength);
+        return cached.count;
+    }
+
     num_elements += getFlatpakAppPackages(baseDir);
     ffStrbufSubstrBefore(baseDir, flatpakDirLength);
 
@@ -420,6 +805,8 @@ static uint32_t getFlatpakPackages(FFstrbuf* baseDir, const char* dirname) {
 
     ffStrbufSubstrBefore(baseDir, baseDirLength);
 
+    ffPackagesWriteCache(&cacheEntry, num_elements);
+
     return num_elements;
 }
 
@@ -458,116 +845,271 @@ static uint32_t getPacmanPackages(FFstrbuf* baseDir) {
     return getNumElements(baseDir, dbPath.chars, true);
 }
 
-static void getPackageCounts(FFstrbuf* baseDir, FFPackagesResult* packageCounts, FFPackagesOptions* options) {
-    if (!(options->disabled & FF_PACKAGES_FLAG_APK_BIT)) {
-        packageCounts->apk += getNumStrings(baseDir, "/lib/apk/db/installed", "C:Q", "apk");
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_DPKG_BIT)) {
-        packageCounts->dpkg += getNumStrings(baseDir, "/var/lib/dpkg/status", "Status: install ok installed", "dpkg");
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_LPKG_BIT)) {
-        packageCounts->lpkg += getNumStrings(baseDir, "/opt/Loc-OS-LPKG/installed-lpkg/Listinstalled-lpkg.list", "\n", "lpkg");
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_EMERGE_BIT)) {
-        packageCounts->emerge += countFilesRecursive(baseDir, "/var/db/pkg", "SIZE");
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_EOPKG_BIT)) {
-        packageCounts->eopkg += getNumElements(baseDir, "/var/lib/eopkg/package", true);
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_FLATPAK_BIT)) {
-        packageCounts->flatpakSystem += getFlatpakPackages(baseDir, "/var/lib");
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_KISS_BIT)) {
-        packageCounts->kiss += getNumElements(baseDir, "/var/db/kiss/installed", true);
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_NIX_BIT)) {
-        packageCounts->nixDefault += ffPackagesGetNix(baseDir, "/nix/var/nix/profiles/default");
-        packageCounts->nixSystem += ffPackagesGetNix(baseDir, "/run/current-system");
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_PACMAN_BIT)) {
-        packageCounts->pacman += getPacmanPackages(baseDir);
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_LPKGBUILD_BIT)) {
-        packageCounts->lpkgbuild += getNumElements(baseDir, "/opt/Loc-OS-LPKG/lpkgbuild/remove", false);
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_PKGTOOL_BIT)) {
-        packageCounts->pkgtool += getNumElements(baseDir, "/var/log/packages", false);
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_RPM_BIT)) {
-        // `Sigmd5` is the only table that doesn't contain the virtual `gpg-pubkey` package
-        packageCounts->rpm += getSQLite3Int(baseDir, "/var/lib/rpm/rpmdb.sqlite", "SELECT count(*) FROM Sigmd5", "rpm");
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_SNAP_BIT)) {
-        packageCounts->snap += getSnap(baseDir);
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_XBPS_BIT)) {
-        packageCounts->xbps += getXBPS(baseDir, "/var/db/xbps");
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_BREW_BIT)) {
-        packageCounts->brewCask += getNumElements(baseDir, "/home/linuxbrew/.linuxbrew/Caskroom", true);
-        packageCounts->brew += getNumElements(baseDir, "/home/linuxbrew/.linuxbrew/Cellar", true);
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_PALUDIS_BIT)) {
-        packageCounts->paludis += countFilesRecursive(baseDir, "/var/db/paludis/repositories", "environment.bz2");
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_OPKG_BIT)) {
-        packageCounts->opkg += getNumStrings(baseDir, "/usr/lib/opkg/status", "Package:", "opkg"); // openwrt
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_AM_BIT)) {
-        packageCounts->amSystem = getAMSystem(baseDir);
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_SORCERY_BIT)) {
-        packageCounts->sorcery += getNumStrings(baseDir, "/var/state/sorcery/packages", ":installed:", "sorcery");
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_GUIX_BIT)) {
-        packageCounts->guixSystem += getGuixPackages(baseDir, "/run/current-system/profile");
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_LINGLONG_BIT)) {
-        packageCounts->linglong += getNumElements(baseDir, "/var/lib/linglong/layers", true);
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_PACSTALL_BIT)) {
-        packageCounts->pacstall += getNumElements(baseDir, "/var/lib/pacstall/metadata", false);
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_PISI_BIT)) {
-        packageCounts->pisi += getNumElements(baseDir, "/var/lib/pisi/package", true);
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_PKGSRC_BIT)) {
-        packageCounts->pkgsrc += getNumElements(baseDir, "/usr/pkg/pkgdb", DT_DIR);
-    }
-    if (!(options->disabled & FF_PACKAGES_FLAG_MOSS_BIT)) {
-        packageCounts->moss += getSQLite3Int(baseDir, "/.moss/db/state", "SELECT COUNT(*) FROM state_selections WHERE state_id = (SELECT MAX(id) FROM state)", "moss");
+static uint32_t countApk(FFstrbuf* baseDir) {
+    return getNumStrings(baseDir, "/lib/apk/db/installed", "C:Q", "apk");
+}
+
+static uint32_t countDpkg(FFstrbuf* baseDir) {
+    return getNumStrings(baseDir, "/var/lib/dpkg/status", "Status: install ok installed", "dpkg");
+}
+
+static uint32_t countLpkg(FFstrbuf* baseDir) {
+    return getNumStrings(baseDir, "/opt/Loc-OS-LPKG/installed-lpkg/Listinstalled-lpkg.list", "\n", "lpkg");
+}
+
+static uint32_t countEmerge(FFstrbuf* baseDir) {
+    return countFilesRecursive(baseDir, "/var/db/pkg", "SIZE", "emerge");
+}
+
+static uint32_t countEopkg(FFstrbuf* baseDir) {
+    return getNumElements(baseDir, "/var/lib/eopkg/package", true);
+}
+
+static uint32_t countFlatpakSystem(FFstrbuf* baseDir) {
+    return getFlatpakPackages(baseDir, "/var/lib", "flatpak-system");
+}
+
+static uint32_t countKiss(FFstrbuf* baseDir) {
+    return getNumElements(baseDir, "/var/db/kiss/installed", true);
+}
+
+static uint32_t countLpkgbuild(FFstrbuf* baseDir) {
+    return getNumElements(baseDir, "/opt/Loc-OS-LPKG/lpkgbuild/remove", false);
+}
+
+static uint32_t countPkgtool(FFstrbuf* baseDir) {
+    return getNumElements(baseDir, "/var/log/packages", false);
+}
+
+static uint32_t countRpm(FFstrbuf* baseDir) {
+    // `Sigmd5` is the only table that doesn't contain the virtual `gpg-pubkey` package
+    uint32_t count = getSQLite3Int(baseDir, "/var/lib/rpm/rpmdb.sqlite", "SELECT count(*) FROM Sigmd5", "rpm");
+    if (count == 0) {
+        count = getRpmDb(baseDir, "/var/lib/rpm/Packages.db", "rpm-ndb", countRpmNdb); // openSUSE
     }
-    if (!(options->disabled & FF_PACKAGES_FLAG_CARDS_BIT)) {
-        packageCounts->cards += getNumElements(baseDir, "/var/lib/pkg/DB", true);
+    if (count == 0) {
+        count = getRpmDb(baseDir, "/var/lib/rpm/Packages", "rpm-bdb", countRpmBdb); // RHEL 8 and older
     }
+    return count;
 }
 
-static void getPackageCountsRegular(FFstrbuf* baseDir, FFPackagesResult* packageCounts, FFPackagesOptions* options) {
-    getPackageCounts(baseDir, packageCounts, options);
+static uint32_t countXbps(FFstrbuf* baseDir) {
+    return getXBPS(baseDir, "/var/db/xbps");
+}
 
-    if (!(options->disabled & FF_PACKAGES_FLAG_PACMAN_BIT)) {
-        uint32_t baseDirLength = baseDir->length;
-        ffStrbufAppendS(baseDir, FASTFETCH_TARGET_DIR_ETC "/pacman-mirrors.conf");
-        if (ffParsePropFile(baseDir->chars, "Branch =", &packageCounts->pacmanBranch) && packageCounts->pacmanBranch.length == 0) {
-            ffStrbufAppendS(&packageCounts->pacmanBranch, "stable");
+static uint32_t countBrewCask(FFstrbuf* baseDir) {
+    return getNumElements(baseDir, "/home/linuxbrew/.linuxbrew/Caskroom", true);
+}
+
+static uint32_t countBrew(FFstrbuf* baseDir) {
+    return getNumElements(baseDir, "/home/linuxbrew/.linuxbrew/Cellar", true);
+}
+
+static uint32_t countPaludis(FFstrbuf* baseDir) {
+    return countFilesRecursive(baseDir, "/var/db/paludis/repositories", "environment.bz2", "paludis");
+}
+
+static uint32_t countOpkg(FFstrbuf* baseDir) {
+    return getNumStrings(baseDir, "/usr/lib/opkg/status", "Package:", "opkg"); // openwrt
+}
+
+static uint32_t countSorcery(FFstrbuf* baseDir) {
+    return getNumStrings(baseDir, "/var/state/sorcery/packages", ":installed:", "sorcery");
+}
+
+static uint32_t countGuixSystem(FFstrbuf* baseDir) {
+    return getGuixPackages(baseDir, "/run/current-system/profile");
+}
+
+static uint32_t countLinglong(FFstrbuf* baseDir) {
+    return getNumElements(baseDir, "/var/lib/linglong/layers", true);
+}
+
+static uint32_t countPacstall(FFstrbuf* baseDir) {
+    return getNumElements(baseDir, "/var/lib/pacstall/metadata", false);
+}
+
+static uint32_t countPisi(FFstrbuf* baseDir) {
+    return getNumElements(baseDir, "/var/lib/pisi/package", true);
+}
+
+static uint32_t countPkgsrc(FFstrbuf* baseDir) {
+    return getNumElements(baseDir, "/usr/pkg/pkgdb", true);
+}
+
+static uint32_t countMoss(FFstrbuf* baseDir) {
+    return getSQLite3Int(baseDir, "/.moss/db/state", "SELECT COUNT(*) FROM state_selections WHERE state_id = (SELECT MAX(id) FROM state)", "moss");
+}
+
+static uint32_t countCards(FFstrbuf* baseDir) {
+    return getNumElements(baseDir, "/var/lib/pkg/DB", true);
+}
+
+static uint32_t countGuixUser(FFstrbuf* baseDir) {
+    return getGuixPackages(baseDir, ".guix-profile");
+}
+
+static uint32_t countGuixHome(FFstrbuf* baseDir) {
+    return getGuixPackages(baseDir, ".guix-home/profile");
+}
+
+static uint32_t countFlatpakUser(FFstrbuf* baseDir) {
+    return getFlatpakPackages(baseDir, "/.local/share", "flatpak-user");
+}
+
+static uint32_t countAmUser(FF_A_UNUSED FFstrbuf* baseDir) {
+    return getAMUser();
+}
+
+static uint32_t countSoar(FFstrbuf* baseDir) {
+    return getSQLite3Int(baseDir, ".local/share/soar/db/soar.db", "SELECT COUNT(DISTINCT pkg_id || pkg_name) FROM packages WHERE is_installed = true", "soar");
+}
+
+static uint32_t countAppImages(FFstrbuf* baseDir) {
+    return getNumElementsBySuffix(baseDir, "/AppImages", ".appimage");
+}
+
+static uint32_t countApplications(FFstrbuf* baseDir) {
+    return getNumElementsBySuffix(baseDir, "/Applications", ".appimage");
+}
+
+// A package manager probe, independent of all other probes
+typedef struct FFPackagesBackend {
+    const char* name; // For tracing
+    FFPackagesFlags flag;
+    uint16_t offset; // Of the counter in `FFPackagesResult`
+    uint32_t (*count)(FFstrbuf* baseDir);
+} FFPackagesBackend;
+
+#define FF_PACKAGES_BACKEND(name, flag, counter, fn) { name, FF_PACKAGES_FLAG_##flag##_BIT, offsetof(FFPackagesResult, counter), fn }
+
+// Probed in the root directory, or in every stratum on Bedrock Linux.
+// Nix profiles are counted by `ffPackagesCountNix` instead
+static const FFPackagesBackend systemBackends[] = {
+    FF_PACKAGES_BACKEND("apk", APK, apk, countApk),
+    FF_PACKAGES_BACKEND("dpkg", DPKG, dpkg, countDpkg),
+    FF_PACKAGES_BACKEND("lpkg", LPKG, lpkg, countLpkg),
+    FF_PACKAGES_BACKEND("emerge", EMERGE, emerge, countEmerge),
+    FF_PACKAGES_BACKEND("eopkg", EOPKG, eopkg, countEopkg),
+    FF_PACKAGES_BACKEND("flatpak", FLATPAK, flatpakSystem, countFlatpakSystem),
+    FF_PACKAGES_BACKEND("kiss", KISS, kiss, countKiss),
+    FF_PACKAGES_BACKEND("pacman", PACMAN, pacman, getPacmanPackages),
+    FF_PACKAGES_BACKEND("lpkgbuild", LPKGBUILD, lpkgbuild, countLpkgbuild),
+    FF_PACKAGES_BACKEND("pkgtool", PKGTOOL, pkgtool, countPkgtool),
+    FF_PACKAGES_BACKEND("rpm", RPM, rpm, countRpm),
+    FF_PACKAGES_BACKEND("snap", SNAP, snap, getSnap),
+    FF_PACKAGES_BACKEND("xbps", XBPS, xbps, countXbps),
+    FF_PACKAGES_BACKEND("brew", BREW, brewCask, countBrewCask),
+    FF_PACKAGES_BACKEND("brew", BREW, brew, countBrew),
+    FF_PACKAGES_BACKEND("paludis", PALUDIS, paludis, countPaludis),
+    FF_PACKAGES_BACKEND("opkg", OPKG, opkg, countOpkg),
+    FF_PACKAGES_BACKEND("am", AM, amSystem, getAMSystem),
+    FF_PACKAGES_BACKEND("sorcery", SORCERY, sorcery, countSorcery),
+    FF_PACKAGES_BACKEND("guix", GUIX, guixSystem, countGuixSystem),
+    FF_PACKAGES_BACKEND("linglong", LINGLONG, linglong, countLinglong),
+    FF_PACKAGES_BACKEND("pacstall", PACSTALL, pacstall, countPacstall),
+    FF_PACKAGES_BACKEND("pisi", PISI, pisi, countPisi),
+    FF_PACKAGES_BACKEND("pkgsrc", PKGSRC, pkgsrc, countPkgsrc),
+    FF_PACKAGES_BACKEND("moss", MOSS, moss, countMoss),
+    FF_PACKAGES_BACKEND("cards", CARDS, cards, countCards),
+};
+
+// Probed in the home directory
+static const FFPackagesBackend userBackends[] = {
+    FF_PACKAGES_BACKEND("guix", GUIX, guixUser, countGuixUser),
+    FF_PACKAGES_BACKEND("guix", GUIX, guixHome, countGuixHome),
+    FF_PACKAGES_BACKEND("flatpak", FLATPAK, flatpakUser, countFlatpakUser),
+    FF_PACKAGES_BACKEND("am", AM, amUser, countAmUser),
+    FF_PACKAGES_BACKEND("soar", SOAR, soar, countSoar),
+    FF_PACKAGES_BACKEND("appimage", APPIMAGE, appimage, countAppImages),
+    FF_PACKAGES_BACKEND("appimage", APPIMAGE, appimage, countApplications),
+};
+
+typedef struct FFPackagesTask {
+    const FFPackagesBackend* backend;
+    const char* baseDir;
+    uint32_t count;
+    double elapsed;
+} FFPackagesTask;
+
+typedef struct FFPackagesTaskQueue {
+    FFlist tasks; // FFPackagesTask
+    uint32_t nextTask;
+} FFPackagesTaskQueue;
+
+#define FF_PACKAGES_MAX_THREADS 4
+
+static void addTasks(FFPackagesTaskQueue* queue, const FFPackagesBackend* backends, uint32_t length, const char* baseDir, FFPackagesOptions* options) {
+    for (uint32_t i = 0; i < length; ++i) {
+        if (!(options->disabled & backends[i].flag)) {
+            *FF_LIST_ADD(FFPackagesTask, queue->tasks) = (FFPackagesTask) {
+                .backend = &backends[i],
+                .baseDir = baseDir,
+            };
         }
-        ffStrbufSubstrBefore(baseDir, baseDirLength);
     }
 }
 
-static void getPackageCountsBedrock(FFstrbuf* baseDir, FFPackagesResult* packageCounts, FFPackagesOptions* options) {
-    uint32_t baseDirLength = baseDir->length;
+static void runTasks(FFPackagesTaskQueue* queue) {
+    FF_STRBUF_AUTO_DESTROY baseDir = ffStrbufCreateA(512);
+    while (true) {
+        uint32_t index = __atomic_fetch_add(&queue->nextTask, 1, __ATOMIC_RELAXED);
+        if (index >= queue->tasks.length) {
+            break;
+        }
+
+        FFPackagesTask* task = FF_LIST_GET(FFPackagesTask, queue->tasks, index);
+        FF_TRACE_SCOPE("packages", task->backend->name, task->baseDir);
+        double start = ffTimeGetTick();
+        ffStrbufSetS(&baseDir, task->baseDir);
+        task->count = task->backend->count(&baseDir);
+        task->elapsed = ffTimeGetTick() - start;
+    }
+}
+
+#ifdef FF_HAVE_THREADS
+FF_THREAD_ENTRY_DECL_WRAPPER(runTasks, FFPackagesTaskQueue*)
+#endif
+
+static void addNixProfiles(FFlist* nixProfiles, FFPackagesResult* result, const FFlist* roots) {
+    FF_STRBUF_AUTO_DESTROY baseDir = ffStrbufCreate();
+    FF_LIST_FOR_EACH (FFstrbuf, root, *roots) {
+        ffStrbufSet(&baseDir, root);
+        ffPackagesAddNix(nixProfiles, &baseDir, "/nix/var/nix/profiles/default", &result->nixDefault);
+        ffPackagesAddNix(nixProfiles, &baseDir, "/run/current-system", &result->nixSystem);
+    }
+
+    ffStrbufSet(&baseDir, &instance.state.platform.homeDir);
+    // Count packages from $HOME/.nix-profile
+    ffPackagesAddNix(nixProfiles, &baseDir, ".nix-profile", &result->nixUser);
+
+    // Check in $XDG_STATE_HOME/nix/profile
+    FF_STRBUF_AUTO_DESTROY stateHome = ffStrbufCreate();
+    const char* stateHomeEnv = getenv("XDG_STATE_HOME");
+    if (ffStrSet(stateHomeEnv)) {
+        ffStrbufSetS(&stateHome, stateHomeEnv);
+        ffStrbufEnsureEndsWithC(&stateHome, '/');
+    } else {
+        ffStrbufSet(&stateHome, &instance.state.platform.homeDir);
+        ffStrbufAppendS(&stateHome, ".local/state/");
+    }
+    ffPackagesAddNix(nixProfiles, &stateHome, "nix/profile", &result->nixUser);
+
+    // Check in /etc/profiles/per-user/$USER
+    FF_STRBUF_AUTO_DESTROY userPkgsDir = ffStrbufCreateStatic("/etc/profiles/per-user/");
+    ffPackagesAddNix(nixProfiles, &userPkgsDir, instance.state.platform.userName.chars, &result->nixUser);
+}
 
-    ffStrbufAppendS(baseDir, "/bedrock/strata");
+// Root directories of all strata on Bedrock Linux
+static void getBedrockStrata(FFlist* roots) {
+    FF_STRBUF_AUTO_DESTROY baseDir = ffStrbufCreateS(FASTFETCH_TARGET_DIR_ROOT "/bedrock/strata");
 
-    FF_AUTO_CLOSE_DIR DIR* dir = opendir(baseDir->chars);
+    FF_AUTO_CLOSE_DIR DIR* dir = ffOpenDir(baseDir.chars);
     if (dir == NULL) {
-        ffStrbufSubstrBefore(baseDir, baseDirLength);
         return;
     }
 
-    ffStrbufAppendC(baseDir, '/');
-    uint32_t baseDirLength2 = baseDir->length;
+    ffStrbufAppendC(&baseDir, '/');
 
     struct dirent* entry;
     while ((entry = readdir(dir)) != NULL) {
@@ -578,74 +1120,88 @@ static void getPackageCountsBedrock(FFstrbuf* baseDir, FFPackagesResult* package
             continue;
         }
 
-        ffStrbufAppendS(baseDir, entry->d_name);
-        getPackageCounts(baseDir, packageCounts, options);
-        ffStrbufSubstrBefore(baseDir, baseDirLength2);
+        FFstrbuf* root = FF_LIST_ADD(FFstrbuf, *roots);
+        ffStrbufInitCopy(root, &baseDir);
+        ffStrbufAppendS(root, entry->d_name);
     }
-
-    ffStrbufSubstrBefore(baseDir, baseDirLength);
 }
 
 void ffDetectPackagesImpl(FFPackagesResult* result, FFPackagesOptions* options) {
-    FF_STRBUF_AUTO_DESTROY baseDir = ffStrbufCreateA(512);
-    ffStrbufAppendS(&baseDir, FASTFETCH_TARGET_DIR_ROOT);
+    bool bedrock = ffStrbufIgnCaseEqualS(&ffDetectOS()->id, "bedrock");
 
-    if (ffStrbufIgnCaseEqualS(&ffDetectOS()->id, "bedrock")) {
-        getPackageCountsBedrock(&baseDir, result, options);
+    FF_LIST_AUTO_DESTROY roots = ffListCreate();
+    if (bedrock) {
+        getBedrockStrata(&roots);
     } else {
-        getPackageCountsRegular(&baseDir, result, options);
-    }
-
-// If SQL failed, we can still try with librpm.
-// This is needed on openSUSE, which seems to use a proprietary database file
-// This method doesn't work on bedrock, so we do it here.
-#ifdef FF_HAVE_RPM
-    if (!(options->disabled & FF_PACKAGES_FLAG_RPM_BIT) && result->rpm == 0) {
-        result->rpm = getRpmFromLibrpm();
+        ffStrbufInitS(FF_LIST_ADD(FFstrbuf, roots), FASTFETCH_TARGET_DIR_ROOT);
+    }
+
+    // Every backend is probed by its own task, in a private copy of its base directory.
+    // The tasks run on a small thread pool and their results are summed up when all of them are done
+    FFPackagesTaskQueue queue = {};
+    ffListInitA(&queue.tasks, sizeof(FFPackagesTask), (roots.length * ARRAY_SIZE(systemBackends)) + ARRAY_SIZE(userBackends));
+    FF_LIST_FOR_EACH (FFstrbuf, root, roots) {
+        addTasks(&queue, systemBackends, ARRAY_SIZE(systemBackends), root->chars, options);
+    }
+    addTasks(&queue, userBackends, ARRAY_SIZE(userBackends), instance.state.platform.homeDir.chars, options);
+
+#ifdef FF_HAVE_THREADS
+    FFThreadType threads[FF_PACKAGES_MAX_THREADS];
+    uint32_t nThreads = 0;
+    if (instance.config.general.multithreading) {
+        uint32_t maxThreads = queue.tasks.length < FF_PACKAGES_MAX_THREADS ? queue.tasks.length : FF_PACKAGES_MAX_THREADS;
+        while (nThreads < maxThreads) {
+            FFThreadType thread = ffThreadCreate(runTasksThreadMain, &queue);
+            if (!thread) {
+                break;
+            }
+            threads[nThreads++] = thread;
+        }
     }
 #endif
 
-    ffStrbufSet(&baseDir, &instance.state.platform.homeDir);
+    // Nix profiles are counted by child processes, which are awaited in the calling thread meanwhile
     if (!(options->disabled & FF_PACKAGES_FLAG_NIX_BIT)) {
-        // Count packages from $HOME/.nix-profile
-        result->nixUser += ffPackagesGetNix(&baseDir, ".nix-profile");
-
-        // Check in $XDG_STATE_HOME/nix/profile
-        FF_STRBUF_AUTO_DESTROY stateHome = ffStrbufCreate();
-        const char* stateHomeEnv = getenv("XDG_STATE_HOME");
-        if (ffStrSet(stateHomeEnv)) {
-            ffStrbufSetS(&stateHome, stateHomeEnv);
-            ffStrbufEnsureEndsWithC(&stateHome, '/');
-        } else {
-            ffStrbufSet(&stateHome, &instance.state.platform.homeDir);
-            ffStrbufAppendS(&stateHome, ".local/state/");
-        }
-        result->nixUser += ffPackagesGetNix(&stateHome, "nix/profile");
-
-        // Check in /etc/profiles/per-user/$USER
-        FF_STRBUF_AUTO_DESTROY userPkgsDir = ffStrbufCreateStatic("/etc/profiles/per-user/");
-        result->nixUser += ffPackagesGetNix(&userPkgsDir, instance.state.platform.userName.chars);
+        FF_TRACE_SCOPE("packages", "nix", NULL);
+        double start = ffTimeGetTick();
+        FF_LIST_AUTO_DESTROY nixProfiles = ffListCreate();
+        addNixProfiles(&nixProfiles, result, &roots);
+        ffPackagesCountNix(&nixProfiles);
+        result->elapsed[__builtin_ctzll(FF_PACKAGES_FLAG_NIX_BIT)] += ffTimeGetTick() - start;
     }
 
-    if (!(options->disabled & FF_PACKAGES_FLAG_GUIX_BIT)) {
-        result->guixUser += getGuixPackages(&baseDir, ".guix-profile");
-        result->guixHome += getGuixPackages(&baseDir, ".guix-home/profile");
+    // Help with the remaining tasks, or run all of them if no thread was created
+    runTasks(&queue);
+
+#ifdef FF_HAVE_THREADS
+    for (uint32_t i = 0; i < nThreads; ++i) {
+        ffThreadJoin(threads[i], 0);
     }
+#endif
 
-    if (!(options->disabled & FF_PACKAGES_FLAG_FLATPAK_BIT)) {
-        result->flatpakUser = getFlatpakPackages(&baseDir, "/.local/share");
+    FF_LIST_FOR_EACH (FFPackagesTask, task, queue.tasks) {
+        *(uint32_t*) ((uint8_t*) result + task->backend->offset) += task->count;
+        result->elapsed[__builtin_ctzll(task->backend->flag)] += task->elapsed;
     }
+    ffListDestroy(&queue.tasks);
 
-    if (!(options->disabled & FF_PACKAGES_FLAG_AM_BIT)) {
-        result->amUser = getAMUser();
+    if (!bedrock && !(options->disabled & FF_PACKAGES_FLAG_PACMAN_BIT)) {
+        if (ffParsePropFile(FASTFETCH_TARGET_DIR_ETC "/pacman-mirrors.conf", "Branch =", &result->pacmanBranch) && result->pacmanBranch.length == 0) {
+            ffStrbufAppendS(&result->pacmanBranch, "stable");
+        }
     }
 
-    if (!(options->disabled & FF_PACKAGES_FLAG_SOAR_BIT)) {
-        result->soar += getSQLite3Int(&baseDir, ".local/share/soar/db/soar.db", "SELECT COUNT(DISTINCT pkg_id || pkg_name) FROM packages WHERE is_installed = true", "soar");
+// If no database could be read natively, we can still try with librpm.
+// This method doesn't work on bedrock, so we do it here.
+#ifdef FF_HAVE_RPM
+    if (!(options->disabled & FF_PACKAGES_FLAG_RPM_BIT) && result->rpm == 0) {
+        double start = ffTimeGetTick();
+        result->rpm = getRpmFromLibrpm();
+        result->elapsed[__builtin_ctzll(FF_PACKAGES_FLAG_RPM_BIT)] += ffTimeGetTick() - start;
     }
+#endif
 
-    if (!(options->disabled & FF_PACKAGES_FLAG_APPIMAGE_BIT)) {
-        result->appimage += getNumElementsBySuffix(&baseDir, "/AppImages", ".appimage");
-        result->appimage += getNumElementsBySuffix(&baseDir, "/Applications", ".appimage");
+    FF_LIST_FOR_EACH (FFstrbuf, root, roots) {
+        ffStrbufDestroy(root);
     }
 }
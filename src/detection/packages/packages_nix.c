@@ -1,6 +1,7 @@
 #include "packages.h"
 #include "common/io.h"
 #include "common/processing.h"
+#include "common/settings.h"
 #include "common/stringUtils.h"
 
 static bool isValidNixPkg(FFstrbuf* pkg) {
@@ -85,65 +86,153 @@ static bool writeNixCache(FFstrbuf* cacheDir, FFstrbuf* hash, uint32_t count) {
     return ffWriteFileBuffer(cacheDir->chars, &cacheContent);
 }
 
-static uint32_t getNixPackagesImpl(char* path) {
-    // Nix detection is kinda slow, so we only do it if the dir exists
-    if (!ffPathExists(path, FF_PATHTYPE_DIRECTORY)) {
-        return 0;
-    }
-
-    FF_STRBUF_AUTO_DESTROY cacheDir = ffStrbufCreateCopy(&instance.state.platform.cacheDir);
-    ffStrbufEnsureEndsWithC(&cacheDir, '/');
-    ffStrbufAppendS(&cacheDir, "fastfetch/packages/nix");
-    ffStrbufAppendS(&cacheDir, path);
-
-    // Check the hash first to determine if we need to recompute the count
-    FF_STRBUF_AUTO_DESTROY hash = ffStrbufCreateA(64);
-    FF_STRBUF_AUTO_DESTROY cacheHash = ffStrbufCreateA(64);
-    uint32_t count = 0;
-
-    ffProcessAppendStdOut(&hash, (char* const[]) { "nix-store", "--query", "--hash", path, NULL });
-
-    if (checkNixCache(&cacheDir, &cacheHash, &count) && ffStrbufEqual(&hash, &cacheHash)) {
-        return count;
-    }
-
-    // Cache is invalid, recompute the count
-    count = 0;
-
+static uint32_t countValidNixPkgs(FFstrbuf* output) {
     // Implementation based on bash script from here:
     // https://github.com/fastfetch-cli/fastfetch/issues/195#issuecomment-1191748222
 
-    FF_STRBUF_AUTO_DESTROY output = ffStrbufCreateA(1024);
-
-    ffProcessAppendStdOut(&output, (char* const[]) { "nix-store", "--query", "--requisites", path, NULL });
-
+    uint32_t count = 0;
     uint32_t lineLength = 0;
-    for (uint32_t i = 0; i < output.length; i++) {
-        if (output.chars[i] != '\n') {
+    for (uint32_t i = 0; i < output->length; i++) {
+        if (output->chars[i] != '\n') {
             lineLength++;
             continue;
         }
 
-        output.chars[i] = '\0';
+        output->chars[i] = '\0';
         FFstrbuf line = {
             .allocated = 0,
             .length = lineLength,
-            .chars = output.chars + i - lineLength
+            .chars = output->chars + i - lineLength
         };
         if (isValidNixPkg(&line)) {
             count++;
         }
         lineLength = 0;
     }
-
-    writeNixCache(&cacheDir, &hash, count);
     return count;
 }
 
-uint32_t ffPackagesGetNix(FFstrbuf* baseDir, const char* dirname) {
+typedef struct FFNixProfile {
+    FFstrbuf path;
+    FFstrbuf storePath; // The profile with all symlinks resolved, e.g. `/nix/store/<hash>-user-environment`
+    FFstrbuf hash;      // Of `storePath`, changes with every generation of the profile
+    uint32_t* count;
+    FFProcessJob* job;
+} FFNixProfile;
+
+static void getNixCachePath(const FFNixProfile* profile, FFstrbuf* cacheDir) {
+    ffStrbufSet(cacheDir, &instance.state.platform.cacheDir);
+    ffStrbufEnsureEndsWithC(cacheDir, '/');
+    ffStrbufAppendS(cacheDir, "fastfetch/packages/nix");
+    ffStrbufAppend(cacheDir, &profile->path);
+}
+
+static bool resolveNixProfile(FFNixProfile* profile) {
+    char resolved[PATH_MAX];
+    if (!realpath(profile->path.chars, resolved)) {
+        return false;
+    }
+    ffStrbufSetS(&profile->storePath, resolved);
+
+    const char* name = strrchr(resolved, '/') + 1;
+    const char* dash = strchr(name, '-');
+    if (!dash) {
+        return false;
+    }
+    ffStrbufSetNS(&profile->hash, (uint32_t) (dash - name), name);
+    return true;
+}
+
+// Walks the references of the profile in the database of the nix store, like `nix-store --query --requisites` does
+static bool countNixRequisitesSQLite(const FFNixProfile* profile, uint32_t* count) {
+    // The store path is quoted in the query
+    uint32_t storeIndex = ffStrbufFirstIndexS(&profile->storePath, "/nix/store/");
+    if (storeIndex == profile->storePath.length || ffStrbufContainC(&profile->storePath, '\'')) {
+        return false;
+    }
+
+    FF_STRBUF_AUTO_DESTROY dbPath = ffStrbufCreateNS(storeIndex, profile->storePath.chars);
+    ffStrbufAppendS(&dbPath, "/nix/var/nix/db/db.sqlite");
+
+    // `Refs` is indexed by `referrer`
+    FF_STRBUF_AUTO_DESTROY query = ffStrbufCreateF(
+        "WITH RECURSIVE closure(id) AS ("
+        "SELECT id FROM ValidPaths WHERE path = '%s' "
+        "UNION SELECT reference FROM Refs JOIN closure ON referrer = closure.id"
+        ") SELECT group_concat(path, char(10)) || char(10) FROM ValidPaths JOIN closure USING (id)",
+        profile->storePath.chars + storeIndex);
+
+    FF_STRBUF_AUTO_DESTROY paths = ffStrbufCreate();
+    if (!ffSettingsGetSQLite3String(dbPath.chars, query.chars, &paths) || paths.length == 0) {
+        return false;
+    }
+
+    *count = countValidNixPkgs(&paths);
+    return true;
+}
+
+void ffPackagesAddNix(FFlist* profiles, FFstrbuf* baseDir, const char* dirname, uint32_t* count) {
     uint32_t baseDirLength = baseDir->length;
     ffStrbufAppendS(baseDir, dirname);
-    uint32_t num_elements = getNixPackagesImpl(baseDir->chars);
+
+    // Nix detection is kinda slow, so we only do it if the dir exists
+    if (ffPathExists(baseDir->chars, FF_PATHTYPE_DIRECTORY)) {
+        FFNixProfile* profile = FF_LIST_ADD(FFNixProfile, *profiles);
+        ffStrbufInitCopy(&profile->path, baseDir);
+        ffStrbufInit(&profile->storePath);
+        ffStrbufInit(&profile->hash);
+        profile->count = count;
+        profile->job = NULL;
+    }
+
     ffStrbufSubstrBefore(baseDir, baseDirLength);
-    return num_elements;
+}
+
+void ffPackagesCountNix(FFlist* profiles) {
+    if (profiles->length == 0) {
+        return;
+    }
+
+    // Profiles whose cached count is outdated are counted from the database of the nix store.
+    // If it can't be read, nix-store is called for all of them concurrently
+    FFProcessReactor reactor;
+    ffProcessReactorInit(&reactor);
+
+    FF_STRBUF_AUTO_DESTROY cacheDir = ffStrbufCreate();
+    FF_STRBUF_AUTO_DESTROY cacheHash = ffStrbufCreateA(64);
+    FF_LIST_FOR_EACH (FFNixProfile, profile, *profiles) {
+        if (!resolveNixProfile(profile)) {
+            continue;
+        }
+        getNixCachePath(profile, &cacheDir);
+
+        // Check the hash first to determine if we need to recompute the count
+        uint32_t count = 0;
+        if (checkNixCache(&cacheDir, &cacheHash, &count) && ffStrbufEqual(&profile->hash, &cacheHash)) {
+            *profile->count += count;
+        } else if (countNixRequisitesSQLite(profile, &count)) {
+            writeNixCache(&cacheDir, &profile->hash, count);
+            *profile->count += count;
+        } else {
+            profile->job = ffProcessReactorSpawn(&reactor, (char* const[]) { "nix-store", "--query", "--requisites", profile->path.chars, NULL }, false);
+        }
+    }
+    ffProcessReactorWait(&reactor, NULL);
+
+    FF_LIST_FOR_EACH (FFNixProfile, profile, *profiles) {
+        if (profile->job) {
+            uint32_t count = countValidNixPkgs(&profile->job->output);
+            getNixCachePath(profile, &cacheDir);
+            writeNixCache(&cacheDir, &profile->hash, count);
+            *profile->count += count;
+        }
+    }
+
+    ffProcessReactorDestroy(&reactor);
+    FF_LIST_FOR_EACH (FFNixProfile, profile, *profiles) {
+        ffStrbufDestroy(&profile->path);
+        ffStrbufDestroy(&profile->storePath);
+        ffStrbufDestroy(&profile->hash);
+    }
+    ffListClear(profiles);
 }
@@ -1,6 +1,7 @@
 #include "physicaldisk.h"
 #include "common/io.h"
 #include "common/properties.h"
+#include "common/sensors.h"
 #include "common/stringUtils.h"
 
 #include <ctype.h>
@@ -8,22 +9,18 @@
 #include <unistd.h>
 #include <fcntl.h>
 
-static double detectNvmeTemp(int devfd) {
-    char pathHwmon[] = "hwmon$/temp1_input";
+static double detectTemp(const char* devName) {
+    // nvme and drivetemp register hwmon under the device of the disk
+    char devicePath[sizeof("/sys/block//device") + NAME_MAX];
+    snprintf(devicePath, ARRAY_SIZE(devicePath), "/sys/block/%s/device", devName);
 
-    for (char c = '0'; c <= '9'; c++) // hopefully there's only one digit
-    {
-        pathHwmon[strlen("hwmon")] = c;
-        char buffer[64];
-        ssize_t size = ffReadFileDataRelative(devfd, pathHwmon, ARRAY_SIZE(buffer), buffer);
-        if (size > 0) {
-            buffer[size] = '\0';
-            double temp = strtod(buffer, NULL);
-            return temp > 0 && temp < 10000000 /*VMware*/ ? temp / 1000 : FF_PHYSICALDISK_TEMP_UNSET;
-        }
+    FFSensor* sensor = ffSensorsFindByDevice(devicePath);
+    if (!sensor) {
+        return FF_PHYSICALDISK_TEMP_UNSET;
     }
 
-    return FF_PHYSICALDISK_TEMP_UNSET;
+    double temp = ffSensorReadTemp(sensor, 1);
+    return temp > 0 && temp < 10000 /*VMware*/ ? temp : FF_PHYSICALDISK_TEMP_UNSET;
 }
 
 static void parsePhysicalDisk(int dfd, const char* devName, FFPhysicalDiskOptions* options, FFlist* result) {
@@ -156,7 +153,7 @@ static void parsePhysicalDisk(int dfd, const char* devName, FFPhysicalDiskOption
         }
 
         if (options->temp) {
-            device->temperature = detectNvmeTemp(devfd);
+            device->temperature = detectTemp(devName);
         }
     }
 
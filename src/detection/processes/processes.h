@@ -2,4 +2,5 @@
 
 #include "fastfetch.h"
 
-const char* ffDetectProcesses(uint32_t* result);
+// Counts threads (kernel scheduling entities) instead of processes if `threads` is set
+const char* ffDetectProcesses(bool threads, uint32_t* result);
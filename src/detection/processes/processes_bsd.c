@@ -5,12 +5,53 @@
     #include <sys/types.h>
     #include <sys/user.h>
 #endif
+#ifdef __APPLE__
+    #include <mach/mach.h>
+#endif
 
 #ifndef KERN_PROC_PROC
     #define KERN_PROC_PROC KERN_PROC_ALL // Apple
 #endif
 
-const char* ffDetectProcesses(uint32_t* result) {
+static const char* detectThreads(uint32_t* result) {
+#if defined(__APPLE__)
+    // What `top` reports. Does not enumerate tasks
+    processor_set_name_t pset;
+    if (processor_set_default(mach_host_self(), &pset) != KERN_SUCCESS) {
+        return "processor_set_default() failed";
+    }
+
+    struct processor_set_load_info info;
+    mach_msg_type_number_t count = PROCESSOR_SET_LOAD_INFO_COUNT;
+    kern_return_t ret = processor_set_statistics(pset, PROCESSOR_SET_LOAD_INFO, (processor_set_info_t) &info, &count);
+    mach_port_deallocate(mach_task_self(), pset);
+    if (ret != KERN_SUCCESS) {
+        return "processor_set_statistics(PROCESSOR_SET_LOAD_INFO) failed";
+    }
+
+    *result = (uint32_t) info.thread_count;
+    return NULL;
+#elif defined(KERN_PROC_INC_THREAD)
+    int request[] = { CTL_KERN, KERN_PROC, KERN_PROC_PROC | KERN_PROC_INC_THREAD };
+    size_t length;
+
+    if (sysctl(request, ARRAY_SIZE(request), NULL, &length, NULL, 0) != 0) {
+        return "sysctl({CTL_KERN, KERN_PROC, KERN_PROC_PROC | KERN_PROC_INC_THREAD}) failed";
+    }
+
+    *result = (uint32_t) (length / sizeof(struct kinfo_proc));
+    return NULL;
+#else
+    FF_UNUSED(result);
+    return "Counting threads is not supported on this platform";
+#endif
+}
+
+const char* ffDetectProcesses(bool threads, uint32_t* result) {
+    if (threads) {
+        return detectThreads(result);
+    }
+
     int request[] = { CTL_KERN, KERN_PROC, KERN_PROC_PROC };
     size_t length;
 
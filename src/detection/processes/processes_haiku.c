@@ -2,13 +2,13 @@
 
 #include <OS.h>
 
-const char* ffDetectProcesses(uint32_t* result) {
+const char* ffDetectProcesses(bool threads, uint32_t* result) {
     system_info info;
     if (get_system_info(&info) != B_OK) {
         return "Error getting system info";
     }
 
-    *result = info.used_teams;
+    *result = threads ? (uint32_t) info.used_threads : (uint32_t) info.used_teams;
 
     return NULL;
 }
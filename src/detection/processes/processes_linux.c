@@ -1,9 +1,58 @@
 #include "processes.h"
 
 #include "common/io.h"
+#include "common/processing.h"
 #include "common/stringUtils.h"
 
-const char* ffDetectProcesses(uint32_t* result) {
+#include <stdlib.h>
+#ifdef __linux__
+    #include <sys/sysinfo.h>
+#endif
+
+static const char* detectThreads(uint32_t* result) {
+    // "0.00 0.01 0.05 2/1234 5678": the 4th field is running/total kernel scheduling entities.
+    // Unlike listing /proc, it is not affected by `hidepid`
+    char buf[128];
+    ssize_t length = ffReadFileData("/proc/loadavg", sizeof(buf) - 1, buf);
+    if (length > 0) {
+        buf[length] = '\0';
+        const char* slash = strchr(buf, '/');
+        if (slash) {
+            uint32_t num = (uint32_t) strtoul(slash + 1, NULL, 10);
+            if (num > 0) {
+                *result = num;
+                return NULL;
+            }
+        }
+    }
+
+#ifdef __linux__
+    // `procs` is 16-bit and wraps around with more than 65535 threads
+    struct sysinfo info;
+    if (sysinfo(&info) == 0 && info.procs > 0) {
+        *result = info.procs;
+        return NULL;
+    }
+#endif
+
+    return "Failed to read the thread count from /proc/loadavg";
+}
+
+const char* ffDetectProcesses(bool threads, uint32_t* result) {
+    if (threads) {
+        return detectThreads(result);
+    }
+
+#if __linux__ || __GNU__
+    // Reuse the process table if DE / WM detection has already read it
+    uint32_t count = ffProcessTableGetCount();
+    if (count > 0) {
+        *result = count;
+        return NULL;
+    }
+#endif
+
+    // The kernel only exposes the number of threads in O(1), so processes are still counted by listing /proc
     FF_AUTO_CLOSE_DIR DIR* dir = opendir("/proc");
     if (dir == NULL) {
         return "opendir(\"/proc\") failed";
@@ -1,8 +1,37 @@
 #include "processes.h"
+#include "common/mallocHelper.h"
 
 #include <sys/sysctl.h>
 
-const char* ffDetectProcesses(uint32_t* result) {
+static const char* detectThreads(uint32_t* result) {
+    int request[] = { CTL_KERN, KERN_PROC2, KERN_PROC_ALL, -1, sizeof(struct kinfo_proc2), 0 };
+    size_t length = 0;
+
+    if (sysctl(request, ARRAY_SIZE(request), NULL, &length, NULL, 0) != 0) {
+        return "sysctl({CTL_KERN, KERN_PROC2, KERN_PROC_ALL}) failed";
+    }
+
+    // Processes may be created between the two calls
+    length += length / 8;
+    FF_AUTO_FREE struct kinfo_proc2* procs = malloc(length);
+    request[5] = (int) (length / sizeof(struct kinfo_proc2));
+    if (sysctl(request, ARRAY_SIZE(request), procs, &length, NULL, 0) != 0) {
+        return "sysctl({CTL_KERN, KERN_PROC2, KERN_PROC_ALL}) failed";
+    }
+
+    uint32_t num = 0;
+    for (size_t i = 0; i < length / sizeof(struct kinfo_proc2); ++i) {
+        num += (uint32_t) procs[i].p_nlwps;
+    }
+    *result = num;
+    return NULL;
+}
+
+const char* ffDetectProcesses(bool threads, uint32_t* result) {
+    if (threads) {
+        return detectThreads(result);
+    }
+
     int request[] = { CTL_KERN, KERN_PROC2, KERN_PROC_ALL, -1, sizeof(struct kinfo_proc2), 0 };
     size_t length = 0;
 
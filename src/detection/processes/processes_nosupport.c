@@ -1,5 +1,5 @@
 #include "processes.h"
 
-const char* ffDetectProcesses(uint32_t* result) {
+const char* ffDetectProcesses(FF_A_UNUSED bool threads, FF_A_UNUSED uint32_t* result) {
     return "Not supported on this platform";
 }
@@ -4,12 +4,27 @@
 #include <sys/sysctl.h>
 #include <kvm.h>
 
-const char* ffDetectProcesses(uint32_t* result) {
+const char* ffDetectProcesses(bool threads, uint32_t* result) {
     kvm_t* kd = kvm_open(NULL, NULL, NULL, KVM_NO_FILES, NULL);
-    const void* ret = kvm_getprocs(kd, KERN_PROC_ALL, 0, 1, result);
-    kvm_close(kd);
-    if (!ret) {
+    int count = 0;
+    const struct kinfo_proc* procs = kvm_getprocs(kd, threads ? KERN_PROC_ALL | KERN_PROC_SHOW_THREADS : KERN_PROC_ALL, 0, sizeof(struct kinfo_proc), &count);
+    if (!procs) {
+        kvm_close(kd);
         return "kvm_getprocs() failed";
     }
+
+    if (threads) {
+        // Every process is followed by one entry per thread
+        uint32_t num = 0;
+        for (int i = 0; i < count; ++i) {
+            if (procs[i].p_tid != -1) {
+                ++num;
+            }
+        }
+        *result = num;
+    } else {
+        *result = (uint32_t) count;
+    }
+    kvm_close(kd);
     return NULL;
 }
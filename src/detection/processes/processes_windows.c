@@ -4,7 +4,7 @@
 #include <ntstatus.h>
 #include <winternl.h>
 
-const char* ffDetectProcesses(uint32_t* result) {
+const char* ffDetectProcesses(bool threads, uint32_t* result) {
     SYSTEM_PROCESS_INFORMATION* FF_AUTO_FREE pstart = NULL;
 
     // Multiple attempts in case processes change while
@@ -25,10 +25,14 @@ const char* ffDetectProcesses(uint32_t* result) {
         }
     }
 
-    *result = 1; // Init with 1 because we test for ptr->NextEntryOffset
-    for (SYSTEM_PROCESS_INFORMATION* ptr = pstart; ptr->NextEntryOffset; ptr = (SYSTEM_PROCESS_INFORMATION*) ((uint8_t*) ptr + ptr->NextEntryOffset)) {
-        ++*result;
+    uint32_t num = 0;
+    for (SYSTEM_PROCESS_INFORMATION* ptr = pstart;; ptr = (SYSTEM_PROCESS_INFORMATION*) ((uint8_t*) ptr + ptr->NextEntryOffset)) {
+        num += threads ? (uint32_t) ptr->NumberOfThreads : 1;
+        if (!ptr->NextEntryOffset) {
+            break;
+        }
     }
+    *result = num;
 
     return NULL;
 }
@@ -37,7 +37,7 @@ static bool getFileVersion(const FFstrbuf* exePath, const wchar_t* stringName, F
 #endif
 
 static bool getExeVersionRaw(FFstrbuf* exe, FFstrbuf* version) {
-    return ffProcessAppendStdOut(version, (char* const[]) { exe->chars, "--version", NULL }) == NULL;
+    return ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "--version", NULL }, false) == NULL;
 }
 
 static bool getExeVersionGeneral(FFstrbuf* exe, FFstrbuf* version) {
@@ -119,28 +119,36 @@ static bool getShellVersionPwsh(FFstrbuf* exe, FFstrbuf* version) {
 }
 
 static bool getShellVersionKsh(FFstrbuf* exe, FFstrbuf* version) {
-    if (ffProcessAppendStdErr(version, (char* const[]) { exe->chars, "--version", NULL }) == NULL && ffStrbufSubstrAfterFirstS(version, " (AT&T Research) ")) {
+    // AT&T ksh reports its version with --version, PD ksh derivatives only in $KSH_VERSION. Both are probed at once
+    FFProcessReactor reactor;
+    ffProcessReactorInit(&reactor);
+    FFProcessJob* att = ffProcessReactorSpawn(&reactor, (char* const[]) { exe->chars, "--version", NULL }, true);
+    FFProcessJob* pd = ffProcessReactorSpawn(&reactor, (char* const[]) { exe->chars, "-c", "echo $KSH_VERSION", NULL }, false);
+    ffProcessReactorWait(&reactor, NULL);
+
+    bool result = false;
+    if (att->error == NULL && ffStrbufSubstrAfterFirstS(&att->output, " (AT&T Research) ")) {
         // version         sh (AT&T Research) 93u+ 2012-08-01
-        ffStrbufSubstrBeforeFirstC(version, ' ');
-        return true;
-    }
-
-    ffStrbufClear(version);
-    if (ffProcessAppendStdOut(version, (char* const[]) { exe->chars, "-c", "echo $KSH_VERSION", NULL }) == NULL && ffStrbufSubstrAfterFirstS(version, " KSH ")) {
+        ffStrbufSubstrBeforeFirstC(&att->output, ' ');
+        ffStrbufSet(version, &att->output);
+        result = true;
+    } else if (pd->error == NULL && ffStrbufSubstrAfterFirstS(&pd->output, " KSH ")) {
         // OKSH: @(#)PD KSH v5.2.14 99/07/13.2
         // MKSH: @(#)MIRBSD KSH R59 2025/04/26 +Debian
         // $OKSH_VERSION doesn't exist on OpenBSD
-        ffStrbufSubstrBeforeFirstC(version, ' ');
-        ffStrbufTrimLeft(version, 'v');
-        return true;
+        ffStrbufSubstrBeforeFirstC(&pd->output, ' ');
+        ffStrbufTrimLeft(&pd->output, 'v');
+        ffStrbufSet(version, &pd->output);
+        result = true;
     }
 
-    return false;
+    ffProcessReactorDestroy(&reactor);
+    return result;
 }
 
 static bool getShellVersionOksh(FFstrbuf* exe, FFstrbuf* version) {
     // Homebrew version
-    if (ffProcessAppendStdOut(version, (char* const[]) { exe->chars, "-c", "echo $OKSH_VERSION", NULL }) != NULL) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "-c", "echo $OKSH_VERSION", NULL }, false) != NULL) {
         return false;
     }
 
@@ -150,7 +158,7 @@ static bool getShellVersionOksh(FFstrbuf* exe, FFstrbuf* version) {
 }
 
 static bool getShellVersionOils(FFstrbuf* exe, FFstrbuf* version) {
-    if (ffProcessAppendStdOut(version, (char* const[]) { exe->chars, "--version", NULL }) != NULL) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "--version", NULL }, false) != NULL) {
         return false;
     }
 
@@ -170,8 +178,8 @@ static bool getShellVersionNushell(FFstrbuf* exe, FFstrbuf* version) {
 
 static bool getShellVersionAsh(FFstrbuf* exe, FFstrbuf* version) {
     const char* error = ffStrbufEndsWithS(exe, "busybox")
-        ? ffProcessAppendStdErr(version, (char* const[]) { exe->chars, "ash", "--help", NULL })
-        : ffProcessAppendStdErr(version, (char* const[]) { exe->chars, "--help", NULL });
+        ? ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "ash", "--help", NULL }, true)
+        : ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "--help", NULL }, true);
     if (error != NULL) {
         return false;
     }
@@ -190,7 +198,7 @@ static bool getShellVersionXonsh(FF_A_UNUSED FFstrbuf* exe, FFstrbuf* version) {
     }
 
     // exe is python here
-    if (ffProcessAppendStdErr(version, (char* const[]) { "xonsh", "--version", NULL }) != NULL) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { "xonsh", "--version", NULL }, true) != NULL) {
         return false;
     }
 
@@ -230,7 +238,7 @@ static bool getShellVersionWinPowerShell(FFstrbuf* exe, FFstrbuf* version) {
         return true;
     }
 
-    return ffProcessAppendStdOut(version, (char* const[]) { exe->chars, "-NoLogo", "-NoProfile", "-Command", "$PSVersionTable.PSVersion.ToString()", NULL }) == NULL;
+    return ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "-NoLogo", "-NoProfile", "-Command", "$PSVersionTable.PSVersion.ToString()", NULL }, false) == NULL;
 }
 #endif
 
@@ -320,7 +328,7 @@ FF_A_UNUSED static bool getTerminalVersionGnome(FFstrbuf* exe, FFstrbuf* version
         }
     }
 
-    if (ffProcessAppendStdOut(version, (char* const[]) { "gnome-terminal", "--version", NULL })) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { "gnome-terminal", "--version", NULL }, false)) {
         return false;
     }
 
@@ -342,7 +350,7 @@ FF_A_UNUSED static bool getTerminalVersionXfce4Terminal(FFstrbuf* exe, FFstrbuf*
 }
 
 FF_A_UNUSED static bool getTerminalVersionKgx(FFstrbuf* version) {
-    if (ffProcessAppendStdOut(version, (char* const[]) { "kgx", "--version", NULL })) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { "kgx", "--version", NULL }, false)) {
         return false;
     }
 
@@ -420,7 +428,7 @@ FF_A_UNUSED static bool getTerminalVersionCockpit(FFstrbuf* exe, FFstrbuf* versi
 FF_A_UNUSED static bool getTerminalVersionXterm(FFstrbuf* exe, FFstrbuf* version) {
     ffStrbufSetS(version, getenv("XTERM_VERSION"));
     if (!version->length) {
-        if (ffProcessAppendStdOut(version, (char* const[]) { exe->chars, "-v", NULL })) {
+        if (ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "-v", NULL }, false)) {
             return false;
         }
     }
@@ -432,7 +440,7 @@ FF_A_UNUSED static bool getTerminalVersionXterm(FFstrbuf* exe, FFstrbuf* version
 }
 
 FF_A_UNUSED static bool getTerminalVersionBlackbox(FFstrbuf* exe, FFstrbuf* version) {
-    if (ffProcessAppendStdOut(version, (char* const[]) { exe->chars, "--version", NULL })) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "--version", NULL }, false)) {
         return false;
     }
 
@@ -443,9 +451,10 @@ FF_A_UNUSED static bool getTerminalVersionBlackbox(FFstrbuf* exe, FFstrbuf* vers
 }
 
 FF_A_UNUSED static bool getTerminalVersionUrxvt(FF_A_UNUSED FFstrbuf* exe, FFstrbuf* version) {
-    if (ffProcessAppendStdErr(version, (char* const[]) { "urxvt", // Don't use exe because of urxvtd
-                                           "-invalid",
-                                           NULL })) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { "urxvt", // Don't use exe because of urxvtd
+                                                                "-invalid",
+                                                                NULL },
+            true)) {
         return false;
     }
 
@@ -458,7 +467,7 @@ FF_A_UNUSED static bool getTerminalVersionUrxvt(FF_A_UNUSED FFstrbuf* exe, FFstr
 }
 
 FF_A_UNUSED static bool getTerminalVersionSt(FF_A_UNUSED FFstrbuf* exe, FFstrbuf* version) {
-    if (ffProcessAppendStdErr(version, (char* const[]) { exe->chars, "-v", NULL })) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "-v", NULL }, true)) {
         return false;
     }
 
@@ -479,7 +488,7 @@ FF_A_UNUSED static bool getTerminalVersionLxterminal(FFstrbuf* exe, FFstrbuf* ve
 
 FF_A_UNUSED static bool getTerminalVersionWeston(FF_A_UNUSED FFstrbuf* exe, FFstrbuf* version) {
     // weston-terminal doesn't report a version, use weston version instead
-    if (ffProcessAppendStdOut(version, (char* const[]) { "weston", "--version", NULL })) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { "weston", "--version", NULL }, false)) {
         return false;
     }
 
@@ -514,7 +523,7 @@ static bool getTerminalVersionScreen(FFstrbuf* exe, FFstrbuf* version) {
 }
 
 static bool getTerminalVersionTmux(FFstrbuf* exe, FFstrbuf* version) {
-    if (ffProcessAppendStdOut(version, (char* const[]) { exe->chars, "-V", NULL }) != NULL) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "-V", NULL }, false) != NULL) {
         return false;
     }
 
@@ -542,7 +551,7 @@ static bool getTerminalVersionZed(FFstrbuf* exe, FFstrbuf* version) {
 #endif
     );
 
-    if (ffProcessAppendStdOut(version, (char* const[]) { cli.chars, "--version", NULL }) != NULL) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { cli.chars, "--version", NULL }, false) != NULL) {
         return false;
     }
 
@@ -579,7 +588,7 @@ static bool getTerminalVersionSshd(FFstrbuf* exe, FFstrbuf* version) {
         return true;
     }
 
-    if (ffProcessAppendStdOut(version, (char* const[]) { exePath.chars, "-V", NULL }) != NULL) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { exePath.chars, "-V", NULL }, false) != NULL) {
         return false;
     }
 
@@ -645,7 +654,7 @@ static bool getTerminalVersionKitty(FFstrbuf* exe, FFstrbuf* version) {
 }
 
 FF_A_UNUSED static bool getTerminalVersionPtyxis(FF_A_UNUSED FFstrbuf* exe, FFstrbuf* version) {
-    if (ffProcessAppendStdOut(version, (char* const[]) { "ptyxis", "--version", NULL }) != NULL) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { "ptyxis", "--version", NULL }, false) != NULL) {
         return false;
     }
 
@@ -662,7 +671,7 @@ FF_A_UNUSED static bool getTerminalVersionTilix(FFstrbuf* exe, FFstrbuf* version
         }
     }
 
-    if (ffProcessAppendStdOut(version, (char* const[]) { exe->chars, "--version", NULL }) != NULL) {
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "--version", NULL }, false) != NULL) {
         return false;
     }
 
@@ -680,7 +689,7 @@ FF_A_UNUSED static bool getTerminalVersionTilix(FFstrbuf* exe, FFstrbuf* version
 }
 
 FF_A_UNUSED static bool getTerminalVersionSakura(FFstrbuf* exe, FFstrbuf* version) {
-    if (ffProcessAppendStdErr(version, (char* const[]) { exe->chars, "--version", NULL }) != NULL) { // sakura version is 3.8.8
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "--version", NULL }, true) != NULL) { // sakura version is 3.8.8
         return false;
     }
 
@@ -689,7 +698,7 @@ FF_A_UNUSED static bool getTerminalVersionSakura(FFstrbuf* exe, FFstrbuf* versio
 }
 
 FF_A_UNUSED static bool getTerminalVersionTermite(FFstrbuf* exe, FFstrbuf* version) {
-    if (ffProcessAppendStdOut(version, (char* const[]) { exe->chars, "--version", NULL }) != NULL) { // termite v16.9\nvte 0.78.1 +BIDI +GNUTLS +ICU +SYSTEMD
+    if (ffProcessReactorAppendOutput(version, (char* const[]) { exe->chars, "--version", NULL }, false) != NULL) { // termite v16.9\nvte 0.78.1 +BIDI +GNUTLS +ICU +SYSTEMD
         return false;
     }
 
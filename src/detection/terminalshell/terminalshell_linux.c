@@ -381,10 +381,15 @@ static void setTerminalInfoDetails(FFTerminalResult* result) {
     #define FF_EXE_PATH_LEN 260
 #endif
 
-const FFShellResult* ffDetectShell() {
+// The shell process, without its version. The terminal is searched from the parent of the shell,
+// so that detecting the terminal doesn't wait for the version probe of the shell
+static FFShellResult* detectShellProcess(void) {
     static FFShellResult result;
     static bool init = false;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
     if (init) {
+        ffThreadMutexUnlock(&mutex);
         return &result;
     }
     init = true;
@@ -398,7 +403,7 @@ const FFShellResult* ffDetectShell() {
     result.ppid = 0;
     result.tty = -1;
 
-    pid_t ppid = getppid();
+    pid_t ppid = (pid_t) instance.state.platform.ppid;
 
     const char* ignoreParent = getenv("FFTS_IGNORE_PARENT");
     if (ignoreParent && ffStrEquals(ignoreParent, "1")) {
@@ -408,15 +413,31 @@ const FFShellResult* ffDetectShell() {
 
     ppid = getShellInfo(&result, ppid);
     getUserShellFromEnv(&result);
-    setShellInfoDetails(&result);
 
+    ffThreadMutexUnlock(&mutex);
     return &result;
 }
 
+const FFShellResult* ffDetectShell() {
+    static bool init = false;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    FFShellResult* result = detectShellProcess();
+    ffThreadMutexLock(&mutex);
+    if (!init) {
+        init = true;
+        setShellInfoDetails(result);
+    }
+    ffThreadMutexUnlock(&mutex);
+    return result;
+}
+
 const FFTerminalResult* ffDetectTerminal() {
     static FFTerminalResult result;
     static bool init = false;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
     if (init) {
+        ffThreadMutexUnlock(&mutex);
         return &result;
     }
     init = true;
@@ -430,7 +451,7 @@ const FFTerminalResult* ffDetectTerminal() {
     result.pid = 0;
     result.ppid = 0;
 
-    pid_t ppid = (pid_t) ffDetectShell()->ppid;
+    pid_t ppid = (pid_t) detectShellProcess()->ppid;
 
     if (ppid) {
         ppid = getTerminalInfo(&result, ppid);
@@ -438,5 +459,6 @@ const FFTerminalResult* ffDetectTerminal() {
     getTerminalFromEnv(&result);
     setTerminalInfoDetails(&result);
 
+    ffThreadMutexUnlock(&mutex);
     return &result;
 }
@@ -297,7 +297,10 @@ bool fftsGetTerminalVersion(FFstrbuf* processName, FFstrbuf* exe, FFstrbuf* vers
 const FFShellResult* ffDetectShell(void) {
     static FFShellResult result;
     static bool init = false;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
     if (init) {
+        ffThreadMutexUnlock(&mutex);
         return &result;
     }
     init = true;
@@ -314,6 +317,7 @@ const FFShellResult* ffDetectShell(void) {
 
     uint32_t ppid;
     if (!ffProcessGetInfoWindows(0, &ppid, NULL, NULL, NULL, NULL, NULL)) {
+        ffThreadMutexUnlock(&mutex);
         return &result;
     }
 
@@ -335,13 +339,17 @@ const FFShellResult* ffDetectShell(void) {
         fftsGetShellVersion(result.exePath.length > 0 ? &result.exePath : &result.exe, tmp, &result.version);
     }
 
+    ffThreadMutexUnlock(&mutex);
     return &result;
 }
 
 const FFTerminalResult* ffDetectTerminal(void) {
     static FFTerminalResult result;
     static bool init = false;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
     if (init) {
+        ffThreadMutexUnlock(&mutex);
         return &result;
     }
     init = true;
@@ -373,5 +381,6 @@ const FFTerminalResult* ffDetectTerminal(void) {
         fftsGetTerminalVersion(&result.processName, result.exePath.length > 0 ? &result.exePath : &result.exe, &result.version);
     }
 
+    ffThreadMutexUnlock(&mutex);
     return &result;
 }
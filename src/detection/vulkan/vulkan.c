@@ -1,4 +1,5 @@
 #include "fastfetch.h"
+#include "common/thread.h"
 #include "common/debug.h"
 #include "detection/gpu/gpu.h"
 #include "detection/vulkan/vulkan.h"
@@ -305,6 +306,8 @@ static const char* detectVulkan(FFVulkanResult* result) {
 FFVulkanResult* ffDetectVulkan(void) {
     static FFVulkanResult result;
     static bool initialized;
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    ffThreadMutexLock(&mutex);
 
     if (!initialized) {
         FF_DEBUG("Initializing Vulkan detection cache");
@@ -328,5 +331,6 @@ FFVulkanResult* ffDetectVulkan(void) {
         FF_DEBUG("Reusing cached Vulkan detection result");
     }
 
+    ffThreadMutexUnlock(&mutex);
     return &result;
 }
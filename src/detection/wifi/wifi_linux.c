@@ -96,6 +96,7 @@ static bool ffWifiNlAppendAttr(struct nlmsghdr* nlh, size_t maxLen, uint16_t typ
 }
 
 static bool ffWifiNlGetFamilyId(FFWifiNlContext* ctx) {
+    FF_TRACE_SCOPE("netlink", "CTRL_CMD_GETFAMILY", NL80211_GENL_NAME);
     struct {
         struct nlmsghdr nlh;
         struct genlmsghdr genl;
@@ -467,6 +468,7 @@ static void ffWifiParseBssAttr(const struct nlattr* bssAttr, FFWifiResult* item)
 }
 
 static bool ffWifiFetchScanInfo(FFWifiNlContext* ctx, FFWifiResult* item, uint32_t ifIndex) {
+    FF_TRACE_SCOPE("netlink", "NL80211_CMD_GET_SCAN", NULL);
     struct {
         struct nlmsghdr nlh;
         struct genlmsghdr genl;
@@ -581,6 +583,7 @@ static void ffWifiParseStationInfo(const struct nlattr* staInfoAttr, FFWifiResul
 }
 
 static bool ffWifiFetchStationInfo(FFWifiNlContext* ctx, FFWifiResult* item, uint32_t ifIndex) {
+    FF_TRACE_SCOPE("netlink", "NL80211_CMD_GET_STATION", NULL);
     struct {
         struct nlmsghdr nlh;
         struct genlmsghdr genl;
@@ -3,10 +3,13 @@
 #include "detection/version/version.h"
 #include "logo/logo.h"
 #include "common/commandoption.h"
+#include "common/daemon.h"
+#include "common/frame.h"
 #include "common/init.h"
 #include "common/io.h"
 #include "common/jsonconfig.h"
 #include "common/time.h"
+#include "common/trace.h"
 #include "common/stringUtils.h"
 #include "common/mallocHelper.h"
 #include "fastfetch_datatext.h"
@@ -399,6 +402,8 @@ static bool parseJsoncFile(FFdata* data, const char* path, yyjson_read_flag flg)
         yyjson_val* const root = yyjson_doc_get_root(data->configDoc);
         if (!yyjson_is_obj(root)) {
             error = "Invalid JSON config format. Root value must be an object";
+        } else if (data->genConfigPath.length == 0) {
+            ffPrepareJsonConfigSampling(data);
         }
 
         if (
@@ -653,6 +658,12 @@ static void parseCommand(FFdata* data, char* key, char* value) {
         }
     } else if (ffStrEqualsIgnCase(key, "--dynamic-interval")) {
         instance.state.dynamicInterval = ffOptionParseUInt32(key, value); // seconds to milliseconds
+    } else if (ffStrEqualsIgnCase(key, "--trace")) {
+        if (value == NULL) {
+            fprintf(stderr, "Error: usage: %s <file>\n", key);
+            exit(400);
+        }
+        ffTraceStart(value);
     } else {
         return;
     }
@@ -751,13 +762,11 @@ static void run(FFdata* data) {
         ffLogoPrint();
     }
 
-#if defined(_WIN32)
-    if (!instance.config.display.noBuffer) {
-        fflush(stdout);
-    }
-#endif
-
     while (true) {
+        if (instance.state.dynamicInterval > 0) {
+            ffFrameBegin();
+        }
+
         if (useJsonConfig) {
             ffPrintJsonConfig(data, false);
         } else {
@@ -765,9 +774,11 @@ static void run(FFdata* data) {
         }
 
         if (instance.state.dynamicInterval > 0) {
-            fflush(stdout);
+            if (instance.config.logo.printRemaining) {
+                ffLogoPrintRemaining();
+            }
+            ffFrameEnd();
             ffTimeSleep(instance.state.dynamicInterval);
-            fputs("\e[H", stdout);
         } else {
             break;
         }
@@ -825,10 +836,7 @@ static void writeConfigFile(FFdata* data) {
     }
 }
 
-int main(int argc, char** argv) {
-    ffInitInstance();
-    atexit(ffDestroyInstance);
-
+static int runMain(int argc, char** argv) {
     // Data stores things only needed for the configuration of fastfetch
     FFdata data = {
         .structure = ffStrbufCreate(),
@@ -858,4 +866,39 @@ int main(int argc, char** argv) {
     yyjson_doc_free(data.configDoc);
     yyjson_mut_doc_free(data.resultDoc);
     ffStrbufDestroy(&data.genConfigPath);
+
+    return 0;
+}
+
+// `--daemon` and `--connect` must be handled before anything else is parsed
+static void handleDaemonArguments(int* argc, char** argv) {
+    for (int i = 1; i < *argc; i++) {
+        const char* key = argv[i];
+        const char* value = i + 1 < *argc && argv[i + 1][0] != '-' ? argv[i + 1] : NULL;
+
+        if (ffStrEqualsIgnCase(key, "--daemon")) {
+            const char* error = ffDaemonServe(value, runMain);
+            fprintf(stderr, "Error: failed to start daemon: %s\n", error);
+            exit(1);
+        }
+
+        if (ffStrEqualsIgnCase(key, "--connect")) {
+            // Forward every other argument. If no daemon is running, fall back to doing the work ourselves
+            int skip = value ? 2 : 1;
+            for (int j = i + skip; j <= *argc; j++) {
+                argv[j - skip] = argv[j];
+            }
+            *argc -= skip;
+            ffDaemonConnect(value, *argc, argv);
+            return;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    ffInitInstance();
+    atexit(ffDestroyInstance);
+
+    handleDaemonArguments(&argc, argv);
+    return runMain(argc, argv);
 }
@@ -5740,3 +5740,5 @@ const FFlogo* ffLogoBuiltins[] = {
     Y,
     Z,
 };
+
+#include "logo_builtin_index.h"
@@ -1,5 +1,6 @@
 #include "logo/logo.h"
 #include "common/io.h"
+#include "common/output.h"
 #include "common/printing.h"
 #include "common/processing.h"
 #include "common/textModifier.h"
@@ -39,7 +40,72 @@ static void logoLineCachePush(const FFstrbuf* chars, uint32_t width, FFLogoLineC
     line->width = width;
 }
 
-static void logoLineCacheBuild(FFLogoLineCacheState* cache, const char* data, bool doColorReplacement) {
+// Starts a logo line with the modifiers and padding every line has. Returns the width of the padding
+static uint32_t logoLineBegin(FFstrbuf* line, const FFstrbuf* carryColor, bool keepCarryColor) {
+    FFOptionsLogo* options = &instance.config.logo;
+
+    if (!instance.config.display.pipe && instance.config.display.brightColor) {
+        ffStrbufAppendS(line, FASTFETCH_TEXT_MODIFIER_BOLT);
+    }
+
+    if (keepCarryColor && carryColor->length > 0) {
+        ffStrbufAppend(line, carryColor);
+    }
+
+    if ((options->position != FF_LOGO_POSITION_RIGHT) && options->paddingLeft > 0) {
+        ffStrbufAppendNC(line, options->paddingLeft, ' ');
+        return options->paddingLeft;
+    }
+    return 0;
+}
+
+static inline void logoAppendColor(FFstrbuf* buffer, const FFstrbuf* color) {
+    ffStrbufAppendS(buffer, "\e[");
+    ffStrbufAppend(buffer, color);
+    ffStrbufAppendC(buffer, 'm');
+}
+
+// Builds the lines from the layout generated at build time, equivalent to parsing `data` with color replacement.
+// Returns the number of lines
+static uint32_t logoLineCacheBuildLayout(FFLogoLineCacheState* cache, const char* data, const uint16_t* layout, FFstrbuf* carryColor, bool keepCarryColor, uint32_t* maxLineWidth) {
+    FFOptionsLogo* options = &instance.config.logo;
+    bool pipe = instance.config.display.pipe;
+
+    FF_STRBUF_AUTO_DESTROY line = ffStrbufCreateA(256);
+    uint32_t lineCount = *layout++;
+    for (uint32_t i = 0; i < lineCount; ++i) {
+        ffStrbufClear(&line);
+        uint32_t lineWidth = logoLineBegin(&line, carryColor, keepCarryColor) + layout[pipe ? 1 : 0];
+        uint32_t spanCount = layout[2];
+        layout += 3;
+
+        for (uint32_t j = 0; j < spanCount; ++j, layout += 3) {
+            uint16_t color = layout[0];
+            if (color == FF_LOGO_SPAN_DOLLAR) {
+                if (pipe) {
+                    continue;
+                }
+            } else if (color > 0 && !pipe) {
+                if (keepCarryColor) {
+                    ffStrbufClear(carryColor);
+                    logoAppendColor(carryColor, &options->colors[color - 1]);
+                    ffStrbufAppend(&line, carryColor);
+                } else {
+                    logoAppendColor(&line, &options->colors[color - 1]);
+                }
+            }
+            ffStrbufAppendNS(&line, layout[2], data + layout[1]);
+        }
+
+        logoLineCachePush(&line, lineWidth, cache);
+        if (lineWidth > *maxLineWidth) {
+            *maxLineWidth = lineWidth;
+        }
+    }
+    return lineCount;
+}
+
+static void logoLineCacheBuild(FFLogoLineCacheState* cache, const char* data, const uint16_t* layout, bool doColorReplacement) {
     FFOptionsLogo* options = &instance.config.logo;
     bool keepCarryColor = options->type != FF_LOGO_TYPE_IMAGE_CHAFA;
 
@@ -59,23 +125,13 @@ static void logoLineCacheBuild(FFLogoLineCacheState* cache, const char* data, bo
         logoLineCachePush(NULL, 0, cache);
     }
 
-    if (*data != '\0') {
+    if (layout && doColorReplacement) {
+        uint32_t lineCount = logoLineCacheBuildLayout(cache, data, layout, &carryColor, keepCarryColor, &maxLineWidth);
+        parsedHeight = lineCount > 0 ? lineCount - 1 : 0;
+    } else if (*data != '\0') {
         while (true) {
             FF_STRBUF_AUTO_DESTROY line = ffStrbufCreateA(256);
-            uint32_t lineWidth = 0;
-
-            if (!instance.config.display.pipe && instance.config.display.brightColor) {
-                ffStrbufAppendS(&line, FASTFETCH_TEXT_MODIFIER_BOLT);
-            }
-
-            if (keepCarryColor && carryColor.length > 0) {
-                ffStrbufAppend(&line, &carryColor);
-            }
-
-            if ((options->position != FF_LOGO_POSITION_RIGHT) && options->paddingLeft > 0) {
-                ffStrbufAppendNC(&line, options->paddingLeft, ' ');
-                lineWidth += options->paddingLeft;
-            }
+            uint32_t lineWidth = logoLineBegin(&line, &carryColor, keepCarryColor);
 
             while (*data != '\0' && *data != '\n' && !(*data == '\r' && *(data + 1) == '\n')) {
                 if (*data == '\t') {
@@ -224,6 +280,7 @@ static bool ffLogoPrintCharsRaw(const char* data, size_t length, bool printError
             ffStrbufAppendF(&buf, "\e[2J\e[3J\e[%u;9999999H\e[%uD", (unsigned) options->paddingTop + 1, (unsigned) options->paddingRight + options->width);
         }
         ffStrbufAppendNS(&buf, (uint32_t) length, data);
+        ffOutputFlush();
         ffWriteFDBuffer(FFUnixFD2NativeFD(STDOUT_FILENO), &buf);
 
         if (options->position == FF_LOGO_POSITION_LEFT || options->position == FF_LOGO_POSITION_RIGHT) {
@@ -277,11 +334,11 @@ static bool ffLogoPrintCharsRaw(const char* data, size_t length, bool printError
     return true;
 }
 
-void ffLogoPrintChars(const char* data, bool doColorReplacement) {
+static void logoPrintText(const char* data, const uint16_t* layout, bool doColorReplacement) {
     FFOptionsLogo* options = &instance.config.logo;
     FFLogoLineCacheState* cache = &instance.state.logoLineCache;
 
-    logoLineCacheBuild(cache, data, doColorReplacement);
+    logoLineCacheBuild(cache, data, layout, doColorReplacement);
 
     if (options->position != FF_LOGO_POSITION_TOP) {
         return;
@@ -298,6 +355,10 @@ void ffLogoPrintChars(const char* data, bool doColorReplacement) {
     logoLineCacheClear(cache);
 }
 
+void ffLogoPrintChars(const char* data, bool doColorReplacement) {
+    logoPrintText(data, NULL, doColorReplacement);
+}
+
 static void logoApplyColors(const FFlogo* logo, bool replacement) {
     if (instance.config.display.colorTitle.length == 0) {
         ffStrbufAppendS(&instance.config.display.colorTitle, logo->colorTitle ?: logo->colors[0]);
@@ -338,12 +399,34 @@ static bool logoHasName(const FFlogo* logo, const FFstrbuf* name, bool small) {
     return false;
 }
 
+// FNV-1a of the ASCII lower case name. Keep in sync with `hash_name` in scripts/gen-logos.cmake
+static uint32_t logoHashName(const FFstrbuf* name, uint32_t seed) {
+    uint32_t hash = seed;
+    for (uint32_t i = 0; i < name->length; ++i) {
+        uint8_t c = (uint8_t) name->chars[i];
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        hash = (hash ^ c) * 16777619u;
+    }
+    return hash;
+}
+
+// Returns the NULL terminated list of logos that may have the name, in the order they appear in builtin.c
+static const FFlogo* const* logoBuiltinIndexFind(const FFstrbuf* name) {
+    const FFLogoBuiltinIndex* index = &ffLogoBuiltinIndex;
+    uint32_t hash = logoHashName(name, index->seed);
+    uint32_t slot = ((hash >> 16) ^ index->displacements[hash & index->bucketMask]) & index->slotMask;
+    return &index->candidates[index->slots[slot]];
+}
+
 static const FFlogo* logoGetBuiltin(const FFstrbuf* name, FFLogoSize size) {
     if (name->length == 0 || !isalpha(name->chars[0])) {
         return NULL;
     }
 
-    for (const FFlogo* logo = ffLogoBuiltins[toupper(name->chars[0]) - 'A']; *logo->names; ++logo) {
+    for (const FFlogo* const* candidate = logoBuiltinIndexFind(name); *candidate; ++candidate) {
+        const FFlogo* logo = *candidate;
         switch (size) {
             // Never use alternate logos
             case FF_LOGO_SIZE_NORMAL:
@@ -415,7 +498,7 @@ static const FFlogo* logoGetBuiltinDetected(FFLogoSize size) {
 static void logoPrintStruct(const FFlogo* logo) {
     logoApplyColors(logo, true);
 
-    ffLogoPrintChars(logo->lines, true);
+    logoPrintText(logo->lines.chars, logo->lines.layout, true);
 }
 
 static void logoPrintNone(void) {
@@ -530,6 +613,7 @@ static bool logoPrintFileIfExists(bool doColorReplacement, bool raw) {
 }
 
 static bool logoPrintImageIfExists(FFLogoType logo, bool printError) {
+    ffOutputFlush(); // Image protocols write to stdout directly
     if (!ffLogoPrintImageIfExists(logo, printError)) {
         return false;
     }
@@ -692,6 +776,10 @@ void ffLogoPrint(void) {
 }
 
 void ffLogoPrintLine(void) {
+    if (ffOutputDeferLogoLine()) {
+        return;
+    }
+
     uint32_t printedLineWidth = 0;
     FFLogoLineCacheState* cache = &instance.state.logoLineCache;
     FFOptionsLogo* logo = &instance.config.logo;
@@ -700,11 +788,11 @@ void ffLogoPrintLine(void) {
         FFLogoCachedLine* line = FF_LIST_GET(FFLogoCachedLine, cache->lines, cache->nextLine);
 
         if (logo->position == FF_LOGO_POSITION_RIGHT && line->chars.length > 0) {
-            printf("\033[9999999C\033[%uD", cache->rightOffset);
-            ffStrbufWriteTo(&line->chars, stdout);
-            fputs("\033[G", stdout);
+            ffOutputWriteF("\033[9999999C\033[%uD", cache->rightOffset);
+            ffOutputWriteStrbuf(&line->chars);
+            ffOutputWriteS("\033[G");
         } else {
-            ffStrbufWriteTo(&line->chars, stdout);
+            ffOutputWriteStrbuf(&line->chars);
             printedLineWidth = line->width;
         }
 
@@ -717,17 +805,18 @@ void ffLogoPrintLine(void) {
             remaining = printedLineWidth < remaining ? remaining - printedLineWidth : 0;
             ffPrintCharTimes(' ', remaining);
         } else {
-            printf("\033[%uC", instance.state.logoWidth);
+            ffOutputWriteF("\033[%uC", instance.state.logoWidth);
         }
     }
 
-    if (instance.state.dynamicInterval > 0) {
-        fputs("\033[K", stdout); // Clear to the end of the line
-    }
-
     ++instance.state.keysHeight;
 }
 
+void ffLogoRewind(void) {
+    instance.state.logoLineCache.nextLine = 0;
+    instance.state.keysHeight = 0;
+}
+
 void ffLogoPrintRemaining(void) {
     FFLogoLineCacheState* cache = &instance.state.logoLineCache;
     FFOptionsLogo* logo = &instance.config.logo;
@@ -737,19 +826,21 @@ void ffLogoPrintRemaining(void) {
             FFLogoCachedLine* line = FF_LIST_GET(FFLogoCachedLine, cache->lines, cache->nextLine);
 
             if (logo->position == FF_LOGO_POSITION_RIGHT) {
-                printf("\033[9999999C\033[%uD", cache->rightOffset);
+                ffOutputWriteF("\033[9999999C\033[%uD", cache->rightOffset);
             }
-            ffStrbufPutTo(&line->chars, stdout);
+            ffOutputPutStrbuf(&line->chars);
 
             ++cache->nextLine;
         }
 
         if (!instance.config.display.pipe) {
-            fputs(FASTFETCH_TEXT_MODIFIER_RESET, stdout);
+            ffOutputWriteS(FASTFETCH_TEXT_MODIFIER_RESET);
         }
 
         instance.state.keysHeight = instance.state.logoHeight + 1;
-        logoLineCacheClear(cache);
+        if (instance.state.dynamicInterval == 0) {
+            logoLineCacheClear(cache); // Printed again in every frame otherwise
+        }
         return;
     }
 
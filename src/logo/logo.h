@@ -15,8 +15,19 @@ typedef enum FF_A_PACKED FFLogoSize {
     FF_LOGO_SIZE_SMALL,
 } FFLogoSize;
 
+// Color of a span in `FFLogoText::layout`: 0 for plain text, 1 - 9 for `$1` - `$9` before the text,
+// or FF_LOGO_SPAN_DOLLAR for a `$` followed by a char that isn't a color index, which is dropped when piping
+#define FF_LOGO_SPAN_DOLLAR 10
+
+typedef struct FFLogoText {
+    const char* chars;
+    // Generated by scripts/gen-logos.cmake, NULL if the text must be parsed. Flat list of uint16_t:
+    // lineCount, { width, pipeWidth, spanCount, { color, offset, length } * spanCount } * lineCount
+    const uint16_t* layout;
+} FFLogoText;
+
 typedef struct FFlogo {
-    const char* lines;
+    FFLogoText lines;
     const char* names[FASTFETCH_LOGO_MAX_NAMES];
     const char* colors[FASTFETCH_LOGO_MAX_COLORS];
     const char* colorKeys;
@@ -29,6 +40,8 @@ void ffLogoPrint(void);
 void ffLogoPrintChars(const char* data, bool doColorReplacement);
 void ffLogoPrintLine(void);
 void ffLogoPrintRemaining(void);
+// Prints the logo from its first line again, used by --dynamic-interval
+void ffLogoRewind(void);
 void ffLogoBuiltinPrint(void);
 void ffLogoBuiltinList(void);
 void ffLogoBuiltinListAutocompletion(void);
@@ -39,5 +52,17 @@ const FFlogo* ffLogoGetBuiltinDetected(FFLogoSize size);
 extern const FFlogo* ffLogoBuiltins[];
 extern const FFlogo ffLogoUnknown;
 
+// Perfect hash of builtin logo names, generated by scripts/gen-logos.cmake
+typedef struct FFLogoBuiltinIndex {
+    uint32_t seed;
+    uint16_t bucketMask;
+    uint16_t slotMask;
+    const uint16_t* displacements;   // [bucketMask + 1]
+    const uint16_t* slots;           // [slotMask + 1], index of the first candidate
+    const FFlogo* const* candidates; // NULL terminated lists of logos that may have the name
+} FFLogoBuiltinIndex;
+
+extern const FFLogoBuiltinIndex ffLogoBuiltinIndex;
+
 // image/image.c
 bool ffLogoPrintImageIfExists(FFLogoType type, bool printError);
@@ -45,11 +45,11 @@ bool ffPrintBios(FFBiosOptions* options) {
 
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(key.chars, 0, &options->moduleArgs, FF_PRINT_TYPE_NO_CUSTOM_KEY);
-        ffStrbufWriteTo(&bios.version, stdout);
+        ffOutputWriteStrbuf(&bios.version);
         if (bios.release.length) {
-            printf(" (%s)\n", bios.release.chars);
+            ffOutputWriteF(" (%s)\n", bios.release.chars);
         } else {
-            putchar('\n');
+            ffOutputWriteC('\n');
         }
     } else {
         FF_PRINT_FORMAT_CHECKED(key.chars, 0, &options->moduleArgs, FF_PRINT_TYPE_NO_CUSTOM_KEY, ((FFformatarg[]) {
@@ -25,11 +25,11 @@ bool ffPrintBoard(FFBoardOptions* options) {
 
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_BOARD_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-        ffStrbufWriteTo(&result.name, stdout);
+        ffOutputWriteStrbuf(&result.name);
         if (result.version.length) {
-            printf(" (%s)", result.version.chars);
+            ffOutputWriteF(" (%s)", result.version.chars);
         }
-        putchar('\n');
+        ffOutputWriteC('\n');
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_BOARD_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                           FF_ARG(result.name, "name"),
@@ -26,11 +26,11 @@ bool ffPrintBootmgr(FFBootmgrOptions* options) {
 
         if (options->moduleArgs.outputFormat.length == 0) {
             ffPrintLogoAndKey(FF_BOOTMGR_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-            ffStrbufWriteTo(&bootmgr.name, stdout);
+            ffOutputWriteStrbuf(&bootmgr.name);
             if (firmwareName.length > 0) {
-                printf(" - %s\n", firmwareName.chars);
+                ffOutputWriteF(" - %s\n", firmwareName.chars);
             } else {
-                putchar('\n');
+                ffOutputWriteC('\n');
             }
         } else {
             FF_PRINT_FORMAT_CHECKED(FF_BOOTMGR_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
@@ -4,7 +4,7 @@
 
 bool ffPrintBreak(FF_A_UNUSED FFBreakOptions* options) {
     ffLogoPrintLine();
-    putchar('\n');
+    ffOutputWriteC('\n');
     return true;
 }
 
@@ -35,7 +35,7 @@ bool ffPrintBrightness(FFBrightnessOptions* options) {
         }
 
         ffPrintLogoAndKey(FF_BRIGHTNESS_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-        ffStrbufPutTo(&str, stdout);
+        ffOutputPutStrbuf(&str);
         return true;
     }
 
@@ -74,7 +74,7 @@ bool ffPrintBrightness(FFBrightnessOptions* options) {
 
             ffStrbufAppendS(&str, item->builtin ? " [Built-in]" : " [External]");
 
-            ffStrbufPutTo(&str, stdout);
+            ffOutputPutStrbuf(&str);
         } else {
             FF_STRBUF_AUTO_DESTROY valueNum = ffStrbufCreate();
             if (percentType & FF_PERCENTAGE_TYPE_NUM_BIT) {
@@ -198,6 +198,7 @@ FFModuleBaseInfo ffBrightnessModuleInfo = {
     .printModule = (void*) ffPrintBrightness,
     .generateJsonResult = (void*) ffGenerateBrightnessJsonResult,
     .generateJsonConfig = (void*) ffGenerateBrightnessJsonConfig,
+    .serialized = true,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "Screen brightness (percentage num)", "percentage" },
         { "Screen name", "name" },
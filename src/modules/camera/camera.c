@@ -9,16 +9,16 @@ static void printDevice(FFCameraOptions* options, const FFCameraResult* device,
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_CAMERA_MODULE_NAME, index, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
 
-        ffStrbufWriteTo(&device->name, stdout);
+        ffOutputWriteStrbuf(&device->name);
         if (device->colorspace.length > 0) {
-            fputs(" - ", stdout);
-            ffStrbufWriteTo(&device->colorspace, stdout);
+            ffOutputWriteS(" - ");
+            ffOutputWriteStrbuf(&device->colorspace);
         }
 
         if (device->width > 0 && device->height > 0) {
-            printf(" (%ux%u px)\n", (unsigned) device->width, (unsigned) device->height);
+            ffOutputWriteF(" (%ux%u px)\n", (unsigned) device->width, (unsigned) device->height);
         } else {
-            putchar('\n');
+            ffOutputWriteC('\n');
         }
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_CAMERA_MODULE_NAME, index, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, (((FFformatarg[]) {
@@ -27,11 +27,11 @@ bool ffPrintChassis(FFChassisOptions* options) {
 
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_CHASSIS_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-        ffStrbufWriteTo(&result.type, stdout);
+        ffOutputWriteStrbuf(&result.type);
         if (result.version.length) {
-            printf(" (%s)", result.version.chars);
+            ffOutputWriteF(" (%s)", result.version.chars);
         }
-        putchar('\n');
+        ffOutputWriteC('\n');
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_CHASSIS_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                             FF_ARG(result.type, "type"),
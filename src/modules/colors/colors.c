@@ -47,7 +47,7 @@ bool ffPrintColors(FFColorsOptions* options) {
             if (!instance.config.display.pipe || options->symbol == FF_COLORS_SYMBOL_BACKGROUND) {
                 ffStrbufAppendS(&result, FASTFETCH_TEXT_MODIFIER_RESET);
             }
-            ffStrbufPutTo(&result, stdout);
+            ffOutputPutStrbuf(&result);
             ffStrbufClear(&result);
         }
 
@@ -132,7 +132,7 @@ bool ffPrintColors(FFColorsOptions* options) {
         if (!instance.config.display.pipe || options->symbol == FF_COLORS_SYMBOL_BACKGROUND) {
             ffStrbufAppendS(&result, FASTFETCH_TEXT_MODIFIER_RESET);
         }
-        ffStrbufPutTo(&result, stdout);
+        ffOutputPutStrbuf(&result);
     }
 
     if (!flag) {
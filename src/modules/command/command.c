@@ -24,7 +24,7 @@ bool ffPrintCommand(FFCommandOptions* options) {
         while (ffStrbufGetline(&line, &len, &result)) {
             if (options->moduleArgs.outputFormat.length == 0) {
                 ffPrintLogoAndKey(FF_COMMAND_MODULE_NAME, ++index, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-                puts(line);
+                ffOutputPutS(line);
             } else {
                 FF_PRINT_FORMAT_CHECKED(FF_COMMAND_MODULE_NAME, ++index, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) { FF_ARG(line, "result") }));
             }
@@ -32,7 +32,7 @@ bool ffPrintCommand(FFCommandOptions* options) {
     } else {
         if (options->moduleArgs.outputFormat.length == 0) {
             ffPrintLogoAndKey(FF_COMMAND_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-            ffStrbufPutTo(&result, stdout);
+            ffOutputPutStrbuf(&result);
         } else {
             FF_PRINT_FORMAT_CHECKED(FF_COMMAND_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) { FF_ARG(result, "result") }));
         }
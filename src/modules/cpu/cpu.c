@@ -80,7 +80,7 @@ bool ffPrintCPU(FFCPUOptions* options) {
                 ffTempsAppendNum(cpu.temperature, &str, options->tempConfig, &options->moduleArgs);
             }
 
-            ffStrbufPutTo(&str, stdout);
+            ffOutputPutStrbuf(&str);
         } else {
             FF_STRBUF_AUTO_DESTROY freqBase = ffStrbufCreate();
             ffFreqAppendNum(cpu.frequencyBase, &freqBase);
@@ -236,6 +236,11 @@ void ffDestroyCPUOptions(FFCPUOptions* options) {
     ffStrbufDestroy(&options->tempSensor);
 }
 
+// Temperature is the only value that changes
+static bool isCPUInvariant(FFCPUOptions* options) {
+    return !options->temp;
+}
+
 FFModuleBaseInfo ffCPUModuleInfo = {
     .name = FF_CPU_MODULE_NAME,
     .description = "Print CPU name, frequency, etc.",
@@ -245,6 +250,7 @@ FFModuleBaseInfo ffCPUModuleInfo = {
     .printModule = (void*) ffPrintCPU,
     .generateJsonResult = (void*) ffGenerateCPUJsonResult,
     .generateJsonConfig = (void*) ffGenerateCPUJsonConfig,
+    .isInvariant = (void*) isCPUInvariant,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "Name", "name" },
         { "Vendor", "vendor" },
@@ -1,5 +1,6 @@
 #include "common/printing.h"
 #include "common/jsonconfig.h"
+#include "common/frequency.h"
 #include "common/percent.h"
 #include "common/stringUtils.h"
 #include "detection/cpuusage/cpuusage.h"
@@ -9,7 +10,8 @@
 
 bool ffPrintCPUUsage(FFCPUUsageOptions* options) {
     FF_LIST_AUTO_DESTROY percentages = ffListCreate();
-    const char* error = ffGetCpuUsageResult(options, &percentages);
+    FF_LIST_AUTO_DESTROY frequencies = ffListCreate();
+    const char* error = ffGetCpuUsageResult(options, &percentages, options->showFrequencies ? &frequencies : NULL);
 
     if (error) {
         ffPrintError(FF_CPUUSAGE_DISPLAY_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "%s", error);
@@ -51,6 +53,19 @@ bool ffPrintCPUUsage(FFCPUUsageOptions* options) {
     }
 #endif
 
+    // Of the cores whose frequency is known. 0 if none is
+    uint32_t avgFreq = 0, freqCount = 0;
+    uint64_t sumFreq = 0;
+    FF_LIST_FOR_EACH (uint32_t, freq, frequencies) {
+        if (*freq > 0) {
+            sumFreq += *freq;
+            ++freqCount;
+        }
+    }
+    if (freqCount > 0) {
+        avgFreq = (uint32_t) (sumFreq / freqCount);
+    }
+
     FFPercentageTypeFlags percentType = options->percent.type == 0 ? instance.config.display.percentType : options->percent.type;
 
     if (options->moduleArgs.outputFormat.length == 0) {
@@ -67,15 +82,28 @@ bool ffPrintCPUUsage(FFCPUUsageOptions* options) {
                 }
                 ffPercentAppendNum(&str, avgValue, options->percent, str.length > 0, &options->moduleArgs);
             }
+            if (avgFreq > 0) {
+                ffStrbufAppendS(&str, " (");
+                ffFreqAppendNum(avgFreq, &str);
+                ffStrbufAppendC(&str, ')');
+            }
         } else {
+            uint32_t index = 0;
             FF_LIST_FOR_EACH (double, percent, percentages) {
                 if (str.length > 0) {
                     ffStrbufAppendC(&str, ' ');
                 }
                 ffPercentAppendNum(&str, *percent, options->percent, false, &options->moduleArgs);
+                uint32_t freq = index < frequencies.length ? *FF_LIST_GET(uint32_t, frequencies, index) : 0;
+                if (freq > 0) {
+                    ffStrbufAppendS(&str, " (");
+                    ffFreqAppendNum(freq, &str);
+                    ffStrbufAppendC(&str, ')');
+                }
+                ++index;
             }
         }
-        ffStrbufPutTo(&str, stdout);
+        ffOutputPutStrbuf(&str);
     } else {
         FF_STRBUF_AUTO_DESTROY avgNum = ffStrbufCreate();
         if (percentType & FF_PERCENTAGE_TYPE_NUM_BIT) {
@@ -101,6 +129,8 @@ bool ffPrintCPUUsage(FFCPUUsageOptions* options) {
         if (percentType & FF_PERCENTAGE_TYPE_BAR_BIT) {
             ffPercentAppendBar(&maxBar, maxValue, options->percent, &options->moduleArgs);
         }
+        FF_STRBUF_AUTO_DESTROY freq = ffStrbufCreate();
+        ffFreqAppendNum(avgFreq, &freq);
 
         FF_PRINT_FORMAT_CHECKED(FF_CPUUSAGE_DISPLAY_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                               FF_ARG(avgNum, "avg"),
@@ -111,6 +141,7 @@ bool ffPrintCPUUsage(FFCPUUsageOptions* options) {
                                                                                                               FF_ARG(avgBar, "avg-bar"),
                                                                                                               FF_ARG(maxBar, "max-bar"),
                                                                                                               FF_ARG(minBar, "min-bar"),
+                                                                                                              FF_ARG(freq, "freq"),
                                                                                                           }));
     }
 
@@ -130,6 +161,11 @@ void ffParseCPUUsageJsonObject(FFCPUUsageOptions* options, yyjson_val* module) {
             continue;
         }
 
+        if (unsafe_yyjson_equals_str(key, "showFrequencies")) {
+            options->showFrequencies = yyjson_get_bool(val);
+            continue;
+        }
+
         if (unsafe_yyjson_equals_str(key, "waitTime")) {
             options->waitTime = (uint32_t) yyjson_get_uint(val);
             continue;
@@ -148,6 +184,8 @@ void ffGenerateCPUUsageJsonConfig(FFCPUUsageOptions* options, yyjson_mut_doc* do
 
     yyjson_mut_obj_add_bool(doc, module, "separate", options->separate);
 
+    yyjson_mut_obj_add_bool(doc, module, "showFrequencies", options->showFrequencies);
+
     ffPercentGenerateJsonConfig(doc, module, options->percent);
 
     yyjson_mut_obj_add_uint(doc, module, "waitTime", options->waitTime);
@@ -155,7 +193,8 @@ void ffGenerateCPUUsageJsonConfig(FFCPUUsageOptions* options, yyjson_mut_doc* do
 
 bool ffGenerateCPUUsageJsonResult(FFCPUUsageOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module) {
     FF_LIST_AUTO_DESTROY percentages = ffListCreate();
-    const char* error = ffGetCpuUsageResult(options, &percentages);
+    FF_LIST_AUTO_DESTROY frequencies = ffListCreate();
+    const char* error = ffGetCpuUsageResult(options, &percentages, options->showFrequencies ? &frequencies : NULL);
 
     if (error) {
         yyjson_mut_obj_add_str(doc, module, "error", error);
@@ -165,6 +204,12 @@ bool ffGenerateCPUUsageJsonResult(FFCPUUsageOptions* options, yyjson_mut_doc* do
     FF_LIST_FOR_EACH (double, percent, percentages) {
         yyjson_mut_arr_add_real(doc, result, *percent);
     }
+    if (options->showFrequencies) {
+        yyjson_mut_val* frequency = yyjson_mut_obj_add_arr(doc, module, "frequencies");
+        FF_LIST_FOR_EACH (uint32_t, freq, frequencies) {
+            yyjson_mut_arr_add_uint(doc, frequency, *freq);
+        }
+    }
 
     return true;
 }
@@ -172,6 +217,7 @@ bool ffGenerateCPUUsageJsonResult(FFCPUUsageOptions* options, yyjson_mut_doc* do
 void ffInitCPUUsageOptions(FFCPUUsageOptions* options) {
     ffOptionInitModuleArg(&options->moduleArgs, "󰓅");
     options->separate = false;
+    options->showFrequencies = false;
     options->percent = (FFPercentageModuleConfig) { 50, 80, 0 };
     options->waitTime = 200;
 }
@@ -189,6 +235,7 @@ FFModuleBaseInfo ffCPUUsageModuleInfo = {
     .printModule = (void*) ffPrintCPUUsage,
     .generateJsonResult = (void*) ffGenerateCPUUsageJsonResult,
     .generateJsonConfig = (void*) ffGenerateCPUUsageJsonConfig,
+    .isSampling = ffOptionIsSampling,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "CPU usage (percentage num, average)", "avg" },
         { "CPU usage (percentage num, maximum)", "max" },
@@ -198,5 +245,6 @@ FFModuleBaseInfo ffCPUUsageModuleInfo = {
         { "CPU usage (percentage bar, average)", "avg-bar" },
         { "CPU usage (percentage bar, maximum)", "max-bar" },
         { "CPU usage (percentage bar, minimum)", "min-bar" },
+        { "CPU frequency (average of all cores). Requires `showFrequencies`", "freq" },
     }))
 };
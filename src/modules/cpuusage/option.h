@@ -7,6 +7,7 @@ typedef struct FFCPUUsageOptions {
     FFModuleArgs moduleArgs;
 
     bool separate;
+    bool showFrequencies;
     FFPercentageModuleConfig percent;
     uint32_t waitTime; // in ms
 } FFCPUUsageOptions;
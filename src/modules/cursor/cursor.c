@@ -26,13 +26,13 @@ bool ffPrintCursor(FFCursorOptions* options) {
 
         if (options->moduleArgs.outputFormat.length == 0) {
             ffPrintLogoAndKey(FF_CURSOR_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-            ffStrbufWriteTo(&result.theme, stdout);
+            ffOutputWriteStrbuf(&result.theme);
 
             if (result.size.length > 0 && !ffStrbufEqualS(&result.size, "0")) {
-                printf(" (%spx)", result.size.chars);
+                ffOutputWriteF(" (%spx)", result.size.chars);
             }
 
-            putchar('\n');
+            ffOutputWriteC('\n');
         } else {
             FF_PRINT_FORMAT_CHECKED(FF_CURSOR_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                                FF_ARG(result.theme, "theme"),
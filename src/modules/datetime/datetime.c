@@ -118,7 +118,7 @@ bool ffPrintDateTime(FFDateTimeOptions* options) {
 
     ffPrintLogoAndKey(FF_DATETIME_DISPLAY_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
 
-    puts(buffer);
+    ffOutputPutS(buffer);
     return true;
 }
 
@@ -19,14 +19,14 @@ bool ffPrintDE(FFDEOptions* options) {
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_DE_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
 
-        ffStrbufWriteTo(&result->dePrettyName, stdout);
+        ffOutputWriteStrbuf(&result->dePrettyName);
 
         if (version.length > 0) {
-            putchar(' ');
-            ffStrbufWriteTo(&version, stdout);
+            ffOutputWriteC(' ');
+            ffOutputWriteStrbuf(&version);
         }
 
-        putchar('\n');
+        ffOutputWriteC('\n');
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_DE_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) { FF_ARG(result->deProcessName, "process-name"), FF_ARG(result->dePrettyName, "pretty-name"), FF_ARG(version, "version") }));
     }
@@ -90,6 +90,7 @@ FFModuleBaseInfo ffDEModuleInfo = {
     .printModule = (void*) ffPrintDE,
     .generateJsonResult = (void*) ffGenerateDEJsonResult,
     .generateJsonConfig = (void*) ffGenerateDEJsonConfig,
+    .serialized = true,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "DE process name", "process-name" },
         { "DE pretty name", "pretty-name" },
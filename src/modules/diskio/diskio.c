@@ -59,7 +59,7 @@ bool ffPrintDiskIO(FFDiskIOOptions* options) {
                 ffStrbufAppendS(&buffer, "/s");
             }
             ffStrbufAppendS(&buffer, " (W)");
-            ffStrbufPutTo(&buffer, stdout);
+            ffOutputPutStrbuf(&buffer);
         } else {
             ffSizeAppendNum(dev->bytesRead, &buffer);
             if (!options->detectTotal) {
@@ -171,6 +171,11 @@ void ffDestroyDiskIOOptions(FFDiskIOOptions* options) {
     ffStrbufDestroy(&options->namePrefix);
 }
 
+// Total counters are read directly
+static bool isDiskIOSampling(FFDiskIOOptions* options) {
+    return !options->detectTotal;
+}
+
 FFModuleBaseInfo ffDiskIOModuleInfo = {
     .name = FF_DISKIO_MODULE_NAME,
     .description = "Print physical disk I/O throughput",
@@ -180,6 +185,7 @@ FFModuleBaseInfo ffDiskIOModuleInfo = {
     .printModule = (void*) ffPrintDiskIO,
     .generateJsonResult = (void*) ffGenerateDiskIOJsonResult,
     .generateJsonConfig = (void*) ffGenerateDiskIOJsonConfig,
+    .isSampling = (void*) isDiskIOSampling,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "Size of data read [per second] (formatted)", "size-read" },
         { "Size of data written [per second] (formatted)", "size-written" },
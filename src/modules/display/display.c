@@ -56,7 +56,7 @@ bool ffPrintDisplay(FFDisplayOptions* options) {
         }
         ffStrbufTrimRight(&buffer, ' ');
         ffStrbufTrimRight(&buffer, ',');
-        ffStrbufPutTo(&buffer, stdout);
+        ffOutputPutStrbuf(&buffer);
         return true;
     }
 
@@ -136,7 +136,7 @@ bool ffPrintDisplay(FFDisplayOptions* options) {
                 ffStrbufAppendS(&buffer, " *");
             }
 
-            ffStrbufPutTo(&buffer, stdout);
+            ffOutputPutStrbuf(&buffer);
             ffStrbufClear(&buffer);
         } else {
             double ppi = inch == 0 ? 0 : sqrt(result->width * result->width + result->height * result->height) / inch;
@@ -427,6 +427,7 @@ FFModuleBaseInfo ffDisplayModuleInfo = {
     .printModule = (void*) ffPrintDisplay,
     .generateJsonResult = (void*) ffGenerateDisplayJsonResult,
     .generateJsonConfig = (void*) ffGenerateDisplayJsonConfig,
+    .serialized = true,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "Screen configured width (in pixels)", "width" },
         { "Screen configured height (in pixels)", "height" },
@@ -23,14 +23,14 @@ bool ffPrintEditor(FFEditorOptions* options) {
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_EDITOR_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
         if (result.exe.length) {
-            ffStrbufWriteTo(&result.exe, stdout);
+            ffOutputWriteStrbuf(&result.exe);
             if (result.version.length) {
-                printf(" %s", result.version.chars);
+                ffOutputWriteF(" %s", result.version.chars);
             }
         } else {
-            ffStrbufWriteTo(&result.name, stdout);
+            ffOutputWriteStrbuf(&result.name);
         }
-        putchar('\n');
+        ffOutputWriteC('\n');
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_EDITOR_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                            FF_ARG(result.type, "type"),
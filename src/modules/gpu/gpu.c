@@ -81,7 +81,7 @@ static void printGPUResult(FFGPUOptions* options, uint8_t index, const FFGPUResu
             ffStrbufAppendF(&output, " [%s]", type);
         }
 
-        ffStrbufPutTo(&output, stdout);
+        ffOutputPutStrbuf(&output);
     } else {
         FF_STRBUF_AUTO_DESTROY tempStr = ffStrbufCreate();
         ffTempsAppendNum(gpu->temperature, &tempStr, options->tempConfig, &options->moduleArgs);
@@ -462,6 +462,7 @@ FFModuleBaseInfo ffGPUModuleInfo = {
     .printModule = (void*) ffPrintGPU,
     .generateJsonResult = (void*) ffGenerateGPUJsonResult,
     .generateJsonConfig = (void*) ffGenerateGPUJsonConfig,
+    .serialized = true,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "GPU vendor", "vendor" },
         { "GPU name", "name" },
@@ -41,7 +41,7 @@ bool ffPrintHost(FFHostOptions* options) {
             ffStrbufAppendF(&output, " (%s)", host.version.chars);
         }
 
-        ffStrbufPutTo(&output, stdout);
+        ffOutputPutStrbuf(&output);
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_HOST_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                          FF_ARG(host.family, "family"),
@@ -144,6 +144,7 @@ FFModuleBaseInfo ffHostModuleInfo = {
     .printModule = (void*) ffPrintHost,
     .generateJsonResult = (void*) ffGenerateHostJsonResult,
     .generateJsonConfig = (void*) ffGenerateHostJsonConfig,
+    .isInvariant = ffOptionIsInvariant,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "Product family", "family" },
         { "Product name", "name" },
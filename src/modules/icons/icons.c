@@ -20,15 +20,15 @@ bool ffPrintIcons(FFIconsOptions* options) {
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_ICONS_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
         if (result.icons1.length) {
-            ffStrbufWriteTo(&result.icons1, stdout);
+            ffOutputWriteStrbuf(&result.icons1);
         }
         if (result.icons2.length) {
             if (result.icons1.length) {
-                fputs(", ", stdout);
+                ffOutputWriteS(", ");
             }
-            ffStrbufWriteTo(&result.icons2, stdout);
+            ffOutputWriteStrbuf(&result.icons2);
         }
-        putchar('\n');
+        ffOutputWriteC('\n');
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_ICONS_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                           FF_ARG(result.icons1, "icons1"),
@@ -24,11 +24,11 @@ bool ffPrintInitSystem(FFInitSystemOptions* options) {
 
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_INITSYSTEM_DISPLAY_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-        ffStrbufWriteTo(&result.name, stdout);
+        ffOutputWriteStrbuf(&result.name);
         if (result.version.length) {
-            printf(" %s\n", result.version.chars);
+            ffOutputWriteF(" %s\n", result.version.chars);
         } else {
-            putchar('\n');
+            ffOutputWriteC('\n');
         }
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_INITSYSTEM_DISPLAY_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
@@ -8,7 +8,7 @@ bool ffPrintKernel(FFKernelOptions* options) {
     const FFPlatformSysinfo* info = &instance.state.platform.sysinfo;
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_KERNEL_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-        printf("%s %s\n", info->name.chars, info->release.chars);
+        ffOutputWriteF("%s %s\n", info->name.chars, info->release.chars);
     } else {
         FF_STRBUF_AUTO_DESTROY str = ffStrbufCreate();
         ffSizeAppendNum(info->pageSize, &str);
@@ -70,6 +70,7 @@ FFModuleBaseInfo ffKernelModuleInfo = {
     .printModule = (void*) ffPrintKernel,
     .generateJsonResult = (void*) ffGenerateKernelJsonResult,
     .generateJsonConfig = (void*) ffGenerateKernelJsonConfig,
+    .isInvariant = ffOptionIsInvariant,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "Sysname", "sysname" },
         { "Release", "release" },
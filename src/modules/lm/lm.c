@@ -24,14 +24,14 @@ bool ffPrintLM(FFLMOptions* options) {
 
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_LM_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-        ffStrbufWriteTo(&result.service, stdout);
+        ffOutputWriteStrbuf(&result.service);
         if (result.version.length) {
-            printf(" %s", result.version.chars);
+            ffOutputWriteF(" %s", result.version.chars);
         }
         if (result.type.length) {
-            printf(" (%s)", result.type.chars);
+            ffOutputWriteF(" (%s)", result.type.chars);
         }
-        putchar('\n');
+        ffOutputWriteC('\n');
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_LM_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                        FF_ARG(result.service, "service"),
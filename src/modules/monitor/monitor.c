@@ -39,17 +39,17 @@ bool ffPrintMonitor(FFMonitorOptions* options) {
         if (options->moduleArgs.outputFormat.length == 0) {
             ffPrintLogoAndKey(key.chars, 0, &options->moduleArgs, FF_PRINT_TYPE_NO_CUSTOM_KEY);
 
-            printf("%ux%u px", display->width, display->height);
+            ffOutputWriteF("%ux%u px", display->width, display->height);
             if (display->refreshRate > 0) {
-                printf(" @ %g Hz", ((int) (display->refreshRate * 1000 + 0.5)) / 1000.0);
+                ffOutputWriteF(" @ %g Hz", ((int) (display->refreshRate * 1000 + 0.5)) / 1000.0);
             }
             if (inch > 0) {
-                printf(" - %ux%u mm (%.2f inches, %.2f ppi)", display->physicalWidth, display->physicalHeight, inch, ppi);
+                ffOutputWriteF(" - %ux%u mm (%.2f inches, %.2f ppi)", display->physicalWidth, display->physicalHeight, inch, ppi);
             }
             if (hdrCompatible) {
-                fputs(" [HDR Compatible]", stdout);
+                ffOutputWriteS(" [HDR Compatible]");
             }
-            putchar('\n');
+            ffOutputWriteC('\n');
         } else {
             char buf[32];
             if (display->serial) {
@@ -120,6 +120,7 @@ FFModuleBaseInfo ffMonitorModuleInfo = {
     .printModule = (void*) ffPrintMonitor,
     .generateJsonResult = (void*) ffGenerateMonitorJsonResult,
     .generateJsonConfig = (void*) ffGenerateMonitorJsonConfig,
+    .serialized = true,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "Display name", "name" },
         { "Native resolution width in pixels", "width" },
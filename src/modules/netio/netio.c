@@ -66,7 +66,7 @@ bool ffPrintNetIO(FFNetIOOptions* options) {
             if (inf->defaultRoute && !options->defaultRouteOnly) {
                 ffStrbufAppendS(&buffer, " *");
             }
-            ffStrbufPutTo(&buffer, stdout);
+            ffOutputPutStrbuf(&buffer);
         } else {
             ffStrbufClear(&buffer2);
             ffSizeAppendNum(inf->rxBytes, &buffer);
@@ -198,6 +198,11 @@ void ffDestroyNetIOOptions(FFNetIOOptions* options) {
     ffStrbufDestroy(&options->namePrefix);
 }
 
+// Total counters are read directly
+static bool isNetIOSampling(FFNetIOOptions* options) {
+    return !options->detectTotal;
+}
+
 FFModuleBaseInfo ffNetIOModuleInfo = {
     .name = FF_NETIO_MODULE_NAME,
     .description = "Print network I/O throughput",
@@ -207,6 +212,7 @@ FFModuleBaseInfo ffNetIOModuleInfo = {
     .printModule = (void*) ffPrintNetIO,
     .generateJsonResult = (void*) ffGenerateNetIOJsonResult,
     .generateJsonConfig = (void*) ffGenerateNetIOJsonConfig,
+    .isSampling = (void*) isNetIOSampling,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "Size of data received [per second] (formatted)", "rx-size" },
         { "Size of data sent [per second] (formatted)", "tx-size" },
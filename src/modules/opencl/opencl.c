@@ -15,7 +15,7 @@ bool ffPrintOpenCL(FFOpenCLOptions* options) {
 
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_OPENCL_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-        ffStrbufPutTo(&result->version, stdout);
+        ffOutputPutStrbuf(&result->version);
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_OPENCL_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                            FF_ARG(result->version, "version"),
@@ -128,6 +128,7 @@ FFModuleBaseInfo ffOpenCLModuleInfo = {
     .printModule = (void*) ffPrintOpenCL,
     .generateJsonResult = (void*) ffGenerateOpenCLJsonResult,
     .generateJsonConfig = (void*) ffGenerateOpenCLJsonConfig,
+    .serialized = true,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "Platform version", "version" },
         { "Platform name", "name" },
@@ -19,7 +19,7 @@ bool ffPrintOpenGL(FFOpenGLOptions* options) {
     } else {
         if (options->moduleArgs.outputFormat.length == 0) {
             ffPrintLogoAndKey(FF_OPENGL_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-            puts(result.version.chars);
+            ffOutputPutS(result.version.chars);
         } else {
             FF_PRINT_FORMAT_CHECKED(FF_OPENGL_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                                FF_ARG(result.version, "version"),
@@ -135,6 +135,7 @@ FFModuleBaseInfo ffOpenGLModuleInfo = {
     .printModule = (void*) ffPrintOpenGL,
     .generateJsonResult = (void*) ffGenerateOpenGLJsonResult,
     .generateJsonConfig = (void*) ffGenerateOpenGLJsonConfig,
+    .serialized = true,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "OpenGL version", "version" },
         { "OpenGL renderer", "renderer" },
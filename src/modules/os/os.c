@@ -82,7 +82,7 @@ bool ffPrintOS(FFOSOptions* options) {
         }
 
         ffPrintLogoAndKey(key.chars, 0, &options->moduleArgs, FF_PRINT_TYPE_NO_CUSTOM_KEY);
-        ffStrbufPutTo(&result, stdout);
+        ffOutputPutStrbuf(&result);
     } else {
         FF_PRINT_FORMAT_CHECKED(key.chars, 0, &options->moduleArgs, FF_PRINT_TYPE_NO_CUSTOM_KEY, ((FFformatarg[]) {
                                                                                                      FF_ARG(instance.state.platform.sysinfo.name, "sysname"),
@@ -180,6 +180,7 @@ FFModuleBaseInfo ffOSModuleInfo = {
     .printModule = (void*) ffPrintOS,
     .generateJsonResult = (void*) ffGenerateOSJsonResult,
     .generateJsonConfig = (void*) ffGenerateOSJsonConfig,
+    .isInvariant = ffOptionIsInvariant,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "Name of the kernel", "sysname" },
         { "Name of the OS", "name" },
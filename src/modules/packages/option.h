@@ -43,6 +43,9 @@ typedef enum FF_A_PACKED FFPackagesFlags {
 } FFPackagesFlags;
 static_assert(sizeof(FFPackagesFlags) == sizeof(uint64_t), "");
 
+#define FF_PACKAGES_FLAG_COUNT 35 // Number of package manager bits
+static_assert(FF_PACKAGES_FLAG_CARDS_BIT == 1ULL << (FF_PACKAGES_FLAG_COUNT - 1), "FF_PACKAGES_FLAG_COUNT is outdated");
+
 typedef struct FFPackagesOptions {
     FFModuleArgs moduleArgs;
 
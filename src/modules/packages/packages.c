@@ -137,7 +137,7 @@ bool ffPrintPackages(FFPackagesOptions* options) {
         assert(output.length >= 2); // counts.all > 0 guarantees that at least one package count was printed, which guarantees that ", " was appended at least once
         ffStrbufSubstrBefore(&output, output.length - 1);
         output.chars[output.length - 1] = '\n';
-        ffStrbufWriteTo(&output, stdout);
+        ffOutputWriteStrbuf(&output);
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_PACKAGES_MODULE_NAME,
             0,
@@ -357,6 +357,47 @@ void ffParsePackagesJsonObject(FFPackagesOptions* options, yyjson_val* module) {
     }
 }
 
+// Every package manager flag. The JSON names are the lowercased flag names
+#define FF_PACKAGES_FOR_EACH_FLAG(X) \
+    X(AM)                            \
+    X(APK)                           \
+    X(APPIMAGE)                      \
+    X(BREW)                          \
+    X(CARDS)                         \
+    X(CHOCO)                         \
+    X(DPKG)                          \
+    X(EMERGE)                        \
+    X(EOPKG)                         \
+    X(FLATPAK)                       \
+    X(GUIX)                          \
+    X(HPKG)                          \
+    X(KISS)                          \
+    X(LINGLONG)                      \
+    X(LPKG)                          \
+    X(LPKGBUILD)                     \
+    X(MACPORTS)                      \
+    X(MOSS)                          \
+    X(MPORT)                         \
+    X(NIX)                           \
+    X(OPKG)                          \
+    X(PACMAN)                        \
+    X(PACSTALL)                      \
+    X(PALUDIS)                       \
+    X(PISI)                          \
+    X(PKG)                           \
+    X(PKGSRC)                        \
+    X(PKGTOOL)                       \
+    X(RPM)                           \
+    X(SCOOP)                         \
+    X(SNAP)                          \
+    X(SOAR)                          \
+    X(SORCERY)                       \
+    X(WINGET)                        \
+    X(XBPS)
+#define FF_PACKAGES_COUNT_FLAG(name) +1
+static_assert(0 FF_PACKAGES_FOR_EACH_FLAG(FF_PACKAGES_COUNT_FLAG) == FF_PACKAGES_FLAG_COUNT, "FF_PACKAGES_FOR_EACH_FLAG is outdated");
+#undef FF_PACKAGES_COUNT_FLAG
+
 void ffGeneratePackagesJsonConfig(FFPackagesOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module) {
     ffJsonConfigGenerateModuleArgsConfig(doc, module, &options->moduleArgs);
 
@@ -370,41 +411,7 @@ void ffGeneratePackagesJsonConfig(FFPackagesOptions* options, yyjson_mut_doc* do
     }
     if (false)
         ;
-    FF_TEST_PACKAGE_NAME(AM)
-    FF_TEST_PACKAGE_NAME(APK)
-    FF_TEST_PACKAGE_NAME(APPIMAGE)
-    FF_TEST_PACKAGE_NAME(BREW)
-    FF_TEST_PACKAGE_NAME(CARDS)
-    FF_TEST_PACKAGE_NAME(CHOCO)
-    FF_TEST_PACKAGE_NAME(DPKG)
-    FF_TEST_PACKAGE_NAME(EMERGE)
-    FF_TEST_PACKAGE_NAME(EOPKG)
-    FF_TEST_PACKAGE_NAME(FLATPAK)
-    FF_TEST_PACKAGE_NAME(GUIX)
-    FF_TEST_PACKAGE_NAME(HPKG)
-    FF_TEST_PACKAGE_NAME(KISS)
-    FF_TEST_PACKAGE_NAME(LINGLONG)
-    FF_TEST_PACKAGE_NAME(LPKG)
-    FF_TEST_PACKAGE_NAME(LPKGBUILD)
-    FF_TEST_PACKAGE_NAME(MACPORTS)
-    FF_TEST_PACKAGE_NAME(MOSS)
-    FF_TEST_PACKAGE_NAME(MPORT)
-    FF_TEST_PACKAGE_NAME(NIX)
-    FF_TEST_PACKAGE_NAME(OPKG)
-    FF_TEST_PACKAGE_NAME(PACMAN)
-    FF_TEST_PACKAGE_NAME(PACSTALL)
-    FF_TEST_PACKAGE_NAME(PALUDIS)
-    FF_TEST_PACKAGE_NAME(PISI)
-    FF_TEST_PACKAGE_NAME(PKG)
-    FF_TEST_PACKAGE_NAME(PKGSRC)
-    FF_TEST_PACKAGE_NAME(PKGTOOL)
-    FF_TEST_PACKAGE_NAME(RPM)
-    FF_TEST_PACKAGE_NAME(SCOOP)
-    FF_TEST_PACKAGE_NAME(SNAP)
-    FF_TEST_PACKAGE_NAME(SOAR)
-    FF_TEST_PACKAGE_NAME(SORCERY)
-    FF_TEST_PACKAGE_NAME(WINGET)
-    FF_TEST_PACKAGE_NAME(XBPS)
+    FF_PACKAGES_FOR_EACH_FLAG(FF_TEST_PACKAGE_NAME)
 #undef FF_TEST_PACKAGE_NAME
 
     yyjson_mut_obj_add_bool(doc, module, "combined", options->combined);
@@ -475,6 +482,22 @@ bool ffGeneratePackagesJsonResult(FF_A_UNUSED FFPackagesOptions* options, yyjson
         yyjson_mut_obj_add_strbuf(doc, obj, "pacmanBranch", &counts.pacmanBranch);
     }
 
+    FF_STRBUF_AUTO_DESTROY buf = ffStrbufCreate();
+    yyjson_mut_val* elapsed = NULL;
+#define FF_APPEND_PACKAGE_ELAPSED(name)                                                            \
+    if (counts.elapsed[__builtin_ctzll(FF_PACKAGES_FLAG_##name##_BIT)] > 0) {                      \
+        if (!elapsed) {                                                                            \
+            elapsed = yyjson_mut_obj_add_obj(doc, obj, "elapsed");                                 \
+        }                                                                                          \
+        ffStrbufSetS(&buf, #name);                                                                 \
+        ffStrbufLowerCase(&buf);                                                                   \
+        yyjson_mut_obj_add(elapsed,                                                                \
+            yyjson_mut_strbuf(doc, &buf),                                                          \
+            yyjson_mut_real(doc, counts.elapsed[__builtin_ctzll(FF_PACKAGES_FLAG_##name##_BIT)])); \
+    }
+    FF_PACKAGES_FOR_EACH_FLAG(FF_APPEND_PACKAGE_ELAPSED)
+#undef FF_APPEND_PACKAGE_ELAPSED
+
     return true;
 }
 
@@ -33,31 +33,31 @@ bool ffPrintPhysicalMemory(FFPhysicalMemoryOptions* options) {
             ffPrintLogoAndKey(FF_PHYSICALMEMORY_DISPLAY_NAME, result.length == 1 ? 0 : (uint8_t) (i + 1), &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
 
             if (device->installed) {
-                fputs(prettySize.chars, stdout);
-                fputs(" - ", stdout);
-                ffStrbufWriteTo(&device->type, stdout);
+                ffOutputWriteS(prettySize.chars);
+                ffOutputWriteS(" - ");
+                ffOutputWriteStrbuf(&device->type);
                 if (device->maxSpeed > 0) {
-                    printf("-%u", device->maxSpeed);
+                    ffOutputWriteF("-%u", device->maxSpeed);
                 }
                 if (device->runningSpeed > 0 && device->runningSpeed != device->maxSpeed) {
-                    printf(" @ %u MT/s", device->runningSpeed);
+                    ffOutputWriteF(" @ %u MT/s", device->runningSpeed);
                 }
                 if (device->vendor.length > 0) {
-                    printf(" (%s)", device->vendor.chars);
+                    ffOutputWriteF(" (%s)", device->vendor.chars);
                 }
                 if (device->ecc) {
-                    fputs(" - ECC", stdout);
+                    ffOutputWriteS(" - ECC");
                 }
             } else {
-                fputs("Empty", stdout);
+                ffOutputWriteS("Empty");
                 if (device->formFactor.length > 0) {
-                    printf(" - %s", device->formFactor.chars);
+                    ffOutputWriteF(" - %s", device->formFactor.chars);
                 }
                 if (device->locator.length > 0) {
-                    printf(" (%s)", device->locator.chars);
+                    ffOutputWriteF(" (%s)", device->locator.chars);
                 }
             }
-            putchar('\n');
+            ffOutputWriteC('\n');
         } else {
             FF_PRINT_FORMAT_CHECKED(FF_PHYSICALMEMORY_DISPLAY_NAME, (uint8_t) (i + 1), &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                                                         FF_ARG(device->size, "bytes"),
@@ -28,9 +28,9 @@ bool ffPrintPowerAdapter(FFPowerAdapterOptions* options) {
             ffPrintLogoAndKey(FF_POWERADAPTER_DISPLAY_NAME, i, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
 
             if (result->name.length > 0) {
-                puts(result->name.chars);
+                ffOutputPutS(result->name.chars);
             } else {
-                printf("%dW\n", result->watts);
+                ffOutputWriteF("%dW\n", result->watts);
             }
         } else {
             FF_PRINT_FORMAT_CHECKED(FF_POWERADAPTER_DISPLAY_NAME, i, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
@@ -4,6 +4,8 @@
 
 typedef struct FFProcessesOptions {
     FFModuleArgs moduleArgs;
+
+    bool threads;
 } FFProcessesOptions;
 
 static_assert(sizeof(FFProcessesOptions) <= FF_OPTION_MAX_SIZE, "FFProcessesOptions size exceeds maximum allowed size");
@@ -6,7 +6,7 @@
 
 bool ffPrintProcesses(FFProcessesOptions* options) {
     uint32_t numProcesses = 0;
-    const char* error = ffDetectProcesses(&numProcesses);
+    const char* error = ffDetectProcesses(options->threads, &numProcesses);
 
     if (error) {
         ffPrintError(FF_PROCESSES_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "%s", error);
@@ -16,7 +16,7 @@ bool ffPrintProcesses(FFProcessesOptions* options) {
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_PROCESSES_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
 
-        printf("%u\n", numProcesses);
+        ffOutputWriteF("%u\n", numProcesses);
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_PROCESSES_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) { FF_ARG(numProcesses, "result") }));
     }
@@ -32,17 +32,24 @@ void ffParseProcessesJsonObject(FFProcessesOptions* options, yyjson_val* module)
             continue;
         }
 
+        if (unsafe_yyjson_equals_str(key, "threads")) {
+            options->threads = yyjson_get_bool(val);
+            continue;
+        }
+
         ffPrintError(FF_PROCESSES_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "Unknown JSON key %s", unsafe_yyjson_get_str(key));
     }
 }
 
 void ffGenerateProcessesJsonConfig(FFProcessesOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module) {
     ffJsonConfigGenerateModuleArgsConfig(doc, module, &options->moduleArgs);
+
+    yyjson_mut_obj_add_bool(doc, module, "threads", options->threads);
 }
 
-bool ffGenerateProcessesJsonResult(FF_A_UNUSED FFProcessesOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module) {
+bool ffGenerateProcessesJsonResult(FFProcessesOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module) {
     uint32_t result;
-    const char* error = ffDetectProcesses(&result);
+    const char* error = ffDetectProcesses(options->threads, &result);
 
     if (error) {
         yyjson_mut_obj_add_str(doc, module, "error", error);
@@ -56,6 +63,7 @@ bool ffGenerateProcessesJsonResult(FF_A_UNUSED FFProcessesOptions* options, yyjs
 
 void ffInitProcessesOptions(FFProcessesOptions* options) {
     ffOptionInitModuleArg(&options->moduleArgs, "");
+    options->threads = false;
 }
 
 void ffDestroyProcessesOptions(FFProcessesOptions* options) {
@@ -64,7 +72,7 @@ void ffDestroyProcessesOptions(FFProcessesOptions* options) {
 
 FFModuleBaseInfo ffProcessesModuleInfo = {
     .name = FF_PROCESSES_MODULE_NAME,
-    .description = "Print number of running processes",
+    .description = "Print number of running processes or threads",
     .initOptions = (void*) ffInitProcessesOptions,
     .destroyOptions = (void*) ffDestroyProcessesOptions,
     .parseJsonObject = (void*) ffParseProcessesJsonObject,
@@ -72,5 +80,5 @@ FFModuleBaseInfo ffProcessesModuleInfo = {
     .generateJsonResult = (void*) ffGenerateProcessesJsonResult,
     .generateJsonConfig = (void*) ffGenerateProcessesJsonConfig,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
-        { "Process count", "result" } }))
+        { "Process (or thread) count", "result" } }))
 };
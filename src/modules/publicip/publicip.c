@@ -20,9 +20,9 @@ bool ffPrintPublicIp(FFPublicIPOptions* options) {
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_PUBLICIP_DISPLAY_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
         if (result.location.length) {
-            printf("%s (%s)\n", result.ip.chars, result.location.chars);
+            ffOutputWriteF("%s (%s)\n", result.ip.chars, result.location.chars);
         } else {
-            ffStrbufPutTo(&result.ip, stdout);
+            ffOutputPutStrbuf(&result.ip);
         }
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_PUBLICIP_DISPLAY_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
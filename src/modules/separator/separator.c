@@ -71,7 +71,7 @@ bool ffPrintSeparator(FFSeparatorOptions* options) {
             ffPrintCharTimes(options->string.chars[0], options->times);
         } else {
             for (uint32_t i = 0; i < options->times; i++) {
-                fputs(options->string.chars, stdout);
+                ffOutputWriteS(options->string.chars);
             }
         }
     } else {
@@ -90,7 +90,7 @@ bool ffPrintSeparator(FFSeparatorOptions* options) {
             int remaining = (int) titleLength;
             // Write the whole separator as often as it fits fully into titleLength
             for (; remaining >= (int) wcsLength; remaining -= (int) wcsLength) {
-                ffStrbufWriteTo(&options->string, stdout);
+                ffOutputWriteStrbuf(&options->string);
             }
 
             if (remaining > 0) {
@@ -104,9 +104,9 @@ bool ffPrintSeparator(FFSeparatorOptions* options) {
                         remaining -= (int) getMbrWidth(ptr, (uint32_t) (options->string.length - (ptr - options->string.chars)), &next, &state);
                         ptr = next;
                     }
-                    fwrite(options->string.chars, (size_t) (ptr - options->string.chars), 1, stdout);
+                    ffOutputWrite(options->string.chars, (uint32_t) (ptr - options->string.chars));
                 } else {
-                    fwrite(options->string.chars, (size_t) remaining, 1, stdout);
+                    ffOutputWrite(options->string.chars, (uint32_t) remaining);
                 }
             }
         }
@@ -114,9 +114,9 @@ bool ffPrintSeparator(FFSeparatorOptions* options) {
     }
 
     if (options->outputColor.length && !instance.config.display.pipe) {
-        fputs(FASTFETCH_TEXT_MODIFIER_RESET, stdout);
+        ffOutputWriteS(FASTFETCH_TEXT_MODIFIER_RESET);
     }
-    putchar('\n');
+    ffOutputWriteC('\n');
 
     return true;
 }
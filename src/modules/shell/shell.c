@@ -14,14 +14,14 @@ bool ffPrintShell(FFShellOptions* options) {
 
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_SHELL_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-        ffStrbufWriteTo(&result->prettyName, stdout);
+        ffOutputWriteStrbuf(&result->prettyName);
 
         if (result->version.length > 0) {
-            putchar(' ');
-            ffStrbufWriteTo(&result->version, stdout);
+            ffOutputWriteC(' ');
+            ffOutputWriteStrbuf(&result->version);
         }
 
-        putchar('\n');
+        ffOutputWriteC('\n');
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_SHELL_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                           FF_ARG(result->processName, "process-name"),
@@ -16,9 +16,9 @@ bool ffPrintTerminal(FFTerminalOptions* options) {
         ffPrintLogoAndKey(FF_TERMINAL_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
 
         if (result->version.length) {
-            printf("%s %s\n", result->prettyName.chars, result->version.chars);
+            ffOutputWriteF("%s %s\n", result->prettyName.chars, result->version.chars);
         } else {
-            ffStrbufPutTo(&result->prettyName, stdout);
+            ffOutputPutStrbuf(&result->prettyName);
         }
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_TERMINAL_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
@@ -18,12 +18,12 @@ bool ffPrintTerminalFont(FFTerminalFontOptions* options) {
     } else {
         if (options->moduleArgs.outputFormat.length == 0) {
             ffPrintLogoAndKey(FF_TERMINALFONT_DISPLAY_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-            ffStrbufWriteTo(&terminalFont.font.pretty, stdout);
+            ffOutputWriteStrbuf(&terminalFont.font.pretty);
             if (terminalFont.fallback.pretty.length) {
-                fputs(" / ", stdout);
-                ffStrbufWriteTo(&terminalFont.fallback.pretty, stdout);
+                ffOutputWriteS(" / ");
+                ffOutputWriteStrbuf(&terminalFont.fallback.pretty);
             }
-            putchar('\n');
+            ffOutputWriteC('\n');
         } else {
             FF_PRINT_FORMAT_CHECKED(FF_TERMINALFONT_DISPLAY_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                                       FF_ARG(terminalFont.font.pretty, "combined"),
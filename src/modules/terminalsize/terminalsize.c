@@ -16,13 +16,13 @@ bool ffPrintTerminalSize(FFTerminalSizeOptions* options) {
 
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_TERMINALSIZE_DISPLAY_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
-        printf("%u columns x %u rows", result.columns, result.rows);
+        ffOutputWriteF("%u columns x %u rows", result.columns, result.rows);
 
         if (result.width != 0 && result.height != 0) {
-            printf(" (%upx x %upx)", result.width, result.height);
+            ffOutputWriteF(" (%upx x %upx)", result.width, result.height);
         }
 
-        putchar('\n');
+        ffOutputWriteC('\n');
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_TERMINALSIZE_DISPLAY_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                                   FF_ARG(result.rows, "rows"),
@@ -47,9 +47,9 @@ bool ffPrintTitle(FFTitleOptions* options) {
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_TITLE_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
 
-        ffStrbufWriteTo(&userNameColored, stdout);
-        ffStrbufWriteTo(&atColored, stdout);
-        ffStrbufPutTo(&hostNameColored, stdout);
+        ffOutputWriteStrbuf(&userNameColored);
+        ffOutputWriteStrbuf(&atColored);
+        ffOutputPutStrbuf(&hostNameColored);
     } else {
         FF_STRBUF_AUTO_DESTROY cwdTilde = ffStrbufCreate();
         if (
@@ -19,9 +19,9 @@ bool ffPrintTPM(FFTPMOptions* options) {
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_TPM_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
         if (result.description.length > 0) {
-            ffStrbufPutTo(&result.description, stdout);
+            ffOutputPutStrbuf(&result.description);
         } else {
-            ffStrbufPutTo(&result.version, stdout);
+            ffOutputPutStrbuf(&result.version);
         }
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_TPM_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
@@ -17,22 +17,22 @@ bool ffPrintVulkan(FFVulkanOptions* options) {
         ffPrintLogoAndKey(FF_VULKAN_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
 
         if (vulkan->apiVersion.length == 0 && vulkan->driver.length == 0) {
-            ffStrbufWriteTo(&vulkan->instanceVersion, stdout);
-            puts(" [Software only]");
+            ffOutputWriteStrbuf(&vulkan->instanceVersion);
+            ffOutputPutS(" [Software only]");
         } else {
             if (vulkan->apiVersion.length > 0) {
-                ffStrbufWriteTo(&vulkan->apiVersion, stdout);
+                ffOutputWriteStrbuf(&vulkan->apiVersion);
 
                 if (vulkan->driver.length > 0) {
-                    fputs(" - ", stdout);
+                    ffOutputWriteS(" - ");
                 }
             }
 
             if (vulkan->driver.length > 0) {
-                ffStrbufWriteTo(&vulkan->driver, stdout);
+                ffOutputWriteStrbuf(&vulkan->driver);
             }
 
-            putchar('\n');
+            ffOutputWriteC('\n');
         }
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_VULKAN_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
@@ -140,6 +140,7 @@ FFModuleBaseInfo ffVulkanModuleInfo = {
     .printModule = (void*) ffPrintVulkan,
     .generateJsonResult = (void*) ffGenerateVulkanJsonResult,
     .generateJsonConfig = (void*) ffGenerateVulkanJsonConfig,
+    .serialized = true,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "Driver name", "driver" },
         { "API version", "api-version" },
@@ -26,26 +26,26 @@ bool ffPrintWM(FFWMOptions* options) {
     if (options->moduleArgs.outputFormat.length == 0) {
         ffPrintLogoAndKey(FF_WM_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
 
-        ffStrbufWriteTo(&result->wmPrettyName, stdout);
+        ffOutputWriteStrbuf(&result->wmPrettyName);
 
         if (version.length > 0) {
-            putchar(' ');
-            ffStrbufWriteTo(&version, stdout);
+            ffOutputWriteC(' ');
+            ffOutputWriteStrbuf(&version);
         }
 
         if (result->wmProtocolName.length > 0) {
-            fputs(" (", stdout);
-            ffStrbufWriteTo(&result->wmProtocolName, stdout);
-            putchar(')');
+            ffOutputWriteS(" (");
+            ffOutputWriteStrbuf(&result->wmProtocolName);
+            ffOutputWriteC(')');
         }
 
         if (pluginName.length > 0) {
-            fputs(" (with ", stdout);
-            ffStrbufWriteTo(&pluginName, stdout);
-            putchar(')');
+            ffOutputWriteS(" (with ");
+            ffOutputWriteStrbuf(&pluginName);
+            ffOutputWriteC(')');
         }
 
-        putchar('\n');
+        ffOutputWriteC('\n');
     } else {
         FF_PRINT_FORMAT_CHECKED(FF_WM_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]) {
                                                                                                        FF_ARG(result->wmProcessName, "process-name"),
@@ -128,6 +128,7 @@ FFModuleBaseInfo ffWMModuleInfo = {
     .printModule = (void*) ffPrintWM,
     .generateJsonResult = (void*) ffGenerateWMJsonResult,
     .generateJsonConfig = (void*) ffGenerateWMJsonConfig,
+    .serialized = true,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
         { "WM process name", "process-name" },
         { "WM pretty name", "pretty-name" },
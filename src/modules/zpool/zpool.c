@@ -52,7 +52,7 @@ static void printZpool(FFZpoolOptions* options, FFZpoolResult* result, uint8_t i
         if (result->readOnly) {
             ffStrbufAppendS(&buffer, " [Read-only]");
         }
-        ffStrbufPutTo(&buffer, stdout);
+        ffOutputPutStrbuf(&buffer);
     } else {
         FF_STRBUF_AUTO_DESTROY usedPercentageNum = ffStrbufCreate();
         if (percentType & FF_PERCENTAGE_TYPE_NUM_BIT) {
@@ -20,6 +20,8 @@ const char* ffOptionsParseGeneralJsonConfig(FFOptionsGeneral* options, yyjson_va
     yyjson_obj_foreach (object, idx, max, key, val) {
         if (unsafe_yyjson_equals_str(key, "thread")) {
             options->multithreading = yyjson_get_bool(val);
+        } else if (unsafe_yyjson_equals_str(key, "parallel")) {
+            options->parallel = yyjson_get_bool(val);
         } else if (unsafe_yyjson_equals_str(key, "processingTimeout")) {
             options->processingTimeout = (int32_t) yyjson_get_int(val);
         } else if (unsafe_yyjson_equals_str(key, "preRun")) {
@@ -31,6 +33,8 @@ const char* ffOptionsParseGeneralJsonConfig(FFOptionsGeneral* options, yyjson_va
             }
         } else if (unsafe_yyjson_equals_str(key, "detectVersion")) {
             options->detectVersion = yyjson_get_bool(val);
+        } else if (unsafe_yyjson_equals_str(key, "detectionCache")) {
+            options->detectionCache = yyjson_get_bool(val);
         } else if (unsafe_yyjson_equals_str(key, "playerName")) {
             ffStrbufSetJsonVal(&options->playerName, val);
         }
@@ -65,10 +69,14 @@ const char* ffOptionsParseGeneralJsonConfig(FFOptionsGeneral* options, yyjson_va
 bool ffOptionsParseGeneralCommandLine(FFOptionsGeneral* options, const char* key, const char* value) {
     if (ffStrEqualsIgnCase(key, "--thread") || ffStrEqualsIgnCase(key, "--multithreading")) {
         options->multithreading = ffOptionParseBoolean(value);
+    } else if (ffStrEqualsIgnCase(key, "--parallel")) {
+        options->parallel = ffOptionParseBoolean(value);
     } else if (ffStrEqualsIgnCase(key, "--processing-timeout")) {
         options->processingTimeout = ffOptionParseInt32(key, value);
     } else if (ffStrEqualsIgnCase(key, "--detect-version")) {
         options->detectVersion = ffOptionParseBoolean(value);
+    } else if (ffStrEqualsIgnCase(key, "--detection-cache")) {
+        options->detectionCache = ffOptionParseBoolean(value);
     } else if (ffStrEqualsIgnCase(key, "--player-name")) {
         ffOptionParseString(key, value, &options->playerName);
     }
@@ -93,7 +101,9 @@ bool ffOptionsParseGeneralCommandLine(FFOptionsGeneral* options, const char* key
 void ffOptionsInitGeneral(FFOptionsGeneral* options) {
     options->processingTimeout = 5000;
     options->multithreading = true;
+    options->parallel = false;
     options->detectVersion = true;
+    options->detectionCache = true;
     ffStrbufInit(&options->playerName);
 
 #if defined(__linux__) || defined(__FreeBSD__) || defined(__sun) || defined(__OpenBSD__) || defined(__NetBSD__) || defined(__HAIKU__) || defined(__GNU__)
@@ -111,10 +121,14 @@ void ffOptionsGenerateGeneralJsonConfig(FFdata* data, FFOptionsGeneral* options)
 
     yyjson_mut_obj_add_bool(doc, obj, "thread", options->multithreading);
 
+    yyjson_mut_obj_add_bool(doc, obj, "parallel", options->parallel);
+
     yyjson_mut_obj_add_int(doc, obj, "processingTimeout", options->processingTimeout);
 
     yyjson_mut_obj_add_bool(doc, obj, "detectVersion", options->detectVersion);
 
+    yyjson_mut_obj_add_bool(doc, obj, "detectionCache", options->detectionCache);
+
     yyjson_mut_obj_add_strbuf(doc, obj, "playerName", &options->playerName);
 
 #if defined(__linux__) || defined(__FreeBSD__) || defined(__sun) || defined(__OpenBSD__) || defined(__NetBSD__) || defined(__HAIKU__) || defined(__GNU__)
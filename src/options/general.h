@@ -10,8 +10,10 @@ typedef enum FF_A_PACKED FFDsForceDrmType {
 
 typedef struct FFOptionsGeneral {
     bool multithreading;
+    bool parallel; // Detect modules on worker threads. Requires `multithreading`
     int32_t processingTimeout;
     bool detectVersion;
+    bool detectionCache;
     FFstrbuf playerName;
 
 // Module options that cannot be put in module option structure
@@ -0,0 +1,349 @@
+#include "fastfetch.h"
+#include "common/init.h"
+#include "common/io.h"
+#include "common/option.h"
+#include "common/output.h"
+#include "common/stringUtils.h"
+#include "common/time.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+
+// Measures detection latency of modules, optionally against a snapshot of another machine:
+//   fastfetch-bench --snapshot <dir> [module...]           Records files read by the modules into <dir>
+//   fastfetch-bench [--root <dir>] [-n <count>] [module...] Reports latency percentiles of each module
+// Every iteration runs in a forked child, so results cached in memory by detectors are never reused
+
+static const char* defaultModules[] = { "OS", "Kernel", "Uptime", "Packages", "CPU", "GPU", "Memory", "Swap", "Disk", NULL };
+
+static FFModuleBaseInfo* findModule(const char* name) {
+    if (!ffCharIsEnglishAlphabet(name[0])) {
+        return NULL;
+    }
+
+    for (FFModuleBaseInfo** modules = ffModuleInfos[toupper(name[0]) - 'A']; *modules; ++modules) {
+        if (ffStrEqualsIgnCase(name, (*modules)->name)) {
+            return *modules;
+        }
+    }
+    return NULL;
+}
+
+static double runModule(FFModuleBaseInfo* baseInfo) {
+    FFOutputCapture capture;
+    ffOutputCaptureInit(&capture);
+    FFOutputCapture* previous = ffOutputSetCapture(&capture);
+
+    uint8_t options[FF_OPTION_MAX_SIZE];
+    baseInfo->initOptions(options);
+    double start = ffTimeGetTick();
+    baseInfo->printModule(options);
+    double ms = ffTimeGetTick() - start;
+    baseInfo->destroyOptions(options);
+
+    ffOutputSetCapture(previous);
+    ffOutputCaptureDestroy(&capture);
+    return ms;
+}
+
+// Returns a negative value if the child failed
+static double runModuleForked(FFModuleBaseInfo* baseInfo) {
+    int pipes[2];
+    if (pipe(pipes) < 0) {
+        return -1;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(pipes[0]);
+        close(pipes[1]);
+        return -1;
+    }
+
+    if (pid == 0) {
+        close(pipes[0]);
+        double ms = runModule(baseInfo);
+        _exit(write(pipes[1], &ms, sizeof(ms)) == sizeof(ms) ? 0 : 1);
+    }
+
+    close(pipes[1]);
+    double ms = -1;
+    if (read(pipes[0], &ms, sizeof(ms)) != sizeof(ms)) {
+        ms = -1;
+    }
+    close(pipes[0]);
+    waitpid(pid, NULL, 0);
+    return ms;
+}
+
+static int compareDouble(const void* a, const void* b) {
+    double x = *(const double*) a, y = *(const double*) b;
+    return x < y ? -1 : x > y;
+}
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const double* samples, uint32_t count, uint32_t pct) {
+    uint32_t rank = (count * pct + 99) / 100;
+    return samples[rank > 0 ? rank - 1 : 0];
+}
+
+static void benchModule(FFModuleBaseInfo* baseInfo, uint32_t iterations) {
+    double* samples = malloc(sizeof(*samples) * iterations);
+    uint32_t count = 0;
+    double sum = 0;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        double ms = runModuleForked(baseInfo);
+        if (ms >= 0) {
+            samples[count++] = ms;
+            sum += ms;
+        }
+    }
+
+    if (count == 0) {
+        printf("%-16s failed\n", baseInfo->name);
+    } else {
+        qsort(samples, count, sizeof(*samples), compareDouble);
+        printf("%-16s %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+            baseInfo->name,
+            percentile(samples, count, 50),
+            percentile(samples, count, 90),
+            percentile(samples, count, 99),
+            samples[count - 1],
+            sum / count);
+    }
+    free(samples);
+}
+
+static void snapshotPath(const char* root, const char* path, bool listDir, uint32_t depth);
+
+// Recreates the symlink `linkPath` -> `target` in the snapshot and continues with the path it points to
+static void snapshotSymlink(const char* root, const FFstrbuf* linkPath, const char* rest, bool listDir, uint32_t depth) {
+    char target[PATH_MAX];
+    ssize_t length = readlink(linkPath->chars, target, ARRAY_SIZE(target) - 1);
+    if (length <= 0) {
+        return;
+    }
+    target[length] = '\0';
+
+    FF_STRBUF_AUTO_DESTROY snapshotLink = ffStrbufCreateS(root);
+    ffStrbufAppend(&snapshotLink, linkPath);
+    FF_STRBUF_AUTO_DESTROY snapshotTarget = ffStrbufCreate();
+    if (target[0] == '/') {
+        ffStrbufAppendS(&snapshotTarget, root);
+    }
+    ffStrbufAppendS(&snapshotTarget, target);
+    if (symlink(snapshotTarget.chars, snapshotLink.chars) < 0 && errno != EEXIST) {
+        return;
+    }
+
+    FF_STRBUF_AUTO_DESTROY resolved = ffStrbufCreate();
+    if (target[0] != '/') {
+        ffStrbufAppendNS(&resolved, ffStrbufLastIndexC(linkPath, '/'), linkPath->chars);
+        ffStrbufAppendC(&resolved, '/');
+    }
+    ffStrbufAppendS(&resolved, target);
+    ffStrbufAppendS(&resolved, rest);
+    snapshotPath(root, resolved.chars, listDir, depth + 1);
+}
+
+// Creates every entry of the directory, so that detectors listing it see the same entries.
+// Files that are read are copied separately
+static void snapshotDirEntries(const char* root, const FFstrbuf* dirPath, uint32_t depth) {
+    FF_AUTO_CLOSE_DIR DIR* dir = opendir(dirPath->chars);
+    if (!dir) {
+        return;
+    }
+
+    FF_STRBUF_AUTO_DESTROY entryPath = ffStrbufCreateCopy(dirPath);
+    ffStrbufEnsureEndsWithC(&entryPath, '/');
+    uint32_t dirLength = entryPath.length;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.' && (entry->d_name[1] == '\0' || (entry->d_name[1] == '.' && entry->d_name[2] == '\0'))) {
+            continue;
+        }
+
+        ffStrbufSubstrBefore(&entryPath, dirLength);
+        ffStrbufAppendS(&entryPath, entry->d_name);
+
+        struct stat st;
+        if (lstat(entryPath.chars, &st) < 0) {
+            continue;
+        }
+
+        if (S_ISLNK(st.st_mode)) {
+            snapshotSymlink(root, &entryPath, "", false, depth);
+        } else {
+            FF_STRBUF_AUTO_DESTROY snapshotEntry = ffStrbufCreateS(root);
+            ffStrbufAppend(&snapshotEntry, &entryPath);
+            if (S_ISDIR(st.st_mode)) {
+                mkdir(snapshotEntry.chars, 0755);
+            } else {
+                int fd = open(snapshotEntry.chars, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+                if (fd >= 0) {
+                    close(fd);
+                }
+            }
+        }
+    }
+}
+
+// Recreates `path` in the snapshot. Symlinks in the path are recreated and followed
+static void snapshotPath(const char* root, const char* path, bool listDir, uint32_t depth) {
+    if (depth > 16) {
+        return;
+    }
+
+    FF_STRBUF_AUTO_DESTROY current = ffStrbufCreate();
+    FF_STRBUF_AUTO_DESTROY snapshotCurrent = ffStrbufCreate();
+    const char* p = path;
+    while (true) {
+        while (*p == '/') {
+            ++p;
+        }
+        if (*p == '\0') {
+            break;
+        }
+
+        const char* end = strchr(p, '/');
+        if (!end) {
+            end = p + strlen(p);
+        }
+        uint32_t length = (uint32_t) (end - p);
+        if (length == 1 && p[0] == '.') {
+            p = end;
+            continue;
+        }
+        if (length == 2 && p[0] == '.' && p[1] == '.') {
+            ffStrbufSubstrBefore(&current, ffStrbufLastIndexC(&current, '/'));
+            p = end;
+            continue;
+        }
+        ffStrbufAppendC(&current, '/');
+        ffStrbufAppendNS(&current, length, p);
+        p = end;
+
+        struct stat st;
+        if (lstat(current.chars, &st) < 0) {
+            return;
+        }
+
+        ffStrbufSetS(&snapshotCurrent, root);
+        ffStrbufAppend(&snapshotCurrent, &current);
+
+        if (S_ISLNK(st.st_mode)) {
+            snapshotSymlink(root, &current, p, listDir, depth);
+            return;
+        }
+
+        if (S_ISDIR(st.st_mode)) {
+            mkdir(snapshotCurrent.chars, 0755);
+            continue;
+        }
+
+        if (*p == '\0' && S_ISREG(st.st_mode)) {
+            FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+            if (ffAppendFileBuffer(current.chars, &content)) {
+                ffWriteFileBuffer(snapshotCurrent.chars, &content);
+            }
+        }
+        return;
+    }
+
+    if (listDir) {
+        snapshotDirEntries(root, &current, depth);
+    }
+}
+
+static int takeSnapshot(const char* snapshotDir, const char** moduleNames) {
+    // Absolute symlinks in the snapshot point into it
+    char root[PATH_MAX];
+    if ((mkdir(snapshotDir, 0755) < 0 && errno != EEXIST) || !realpath(snapshotDir, root)) {
+        fprintf(stderr, "Error: failed to create `%s`\n", snapshotDir);
+        return 1;
+    }
+
+    FF_LIST_AUTO_DESTROY paths = ffListCreate();
+    ffIoRecordedPaths = &paths;
+    for (const char** name = moduleNames; *name; ++name) {
+        FFModuleBaseInfo* baseInfo = findModule(*name);
+        if (baseInfo) {
+            runModule(baseInfo);
+        }
+    }
+    ffIoRecordedPaths = NULL;
+
+    FF_LIST_FOR_EACH (FFstrbuf, path, paths) {
+        bool listDir = ffStrbufEndsWithC(path, '/');
+        snapshotPath(root, path->chars, listDir, 0);
+        ffStrbufDestroy(path);
+    }
+
+    printf("Recorded %u paths into %s\n", paths.length, root);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    uint32_t iterations = 100;
+    const char* snapshotDir = NULL;
+    const char* rootDir = NULL;
+    const char** moduleNames = defaultModules;
+
+    int i = 1;
+    for (; i < argc; ++i) {
+        if (ffStrEquals(argv[i], "-n") && i + 1 < argc) {
+            iterations = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (ffStrEquals(argv[i], "--root") && i + 1 < argc) {
+            rootDir = argv[++i];
+        } else if (ffStrEquals(argv[i], "--snapshot") && i + 1 < argc) {
+            snapshotDir = argv[++i];
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Usage: %s [--snapshot <dir>] [--root <dir>] [-n <iterations>] [module...]\n", argv[0]);
+            return 400;
+        } else {
+            break;
+        }
+    }
+    if (i < argc) {
+        moduleNames = (const char**) argv + i;
+    }
+
+    for (const char** name = moduleNames; *name; ++name) {
+        if (!findModule(*name)) {
+            fprintf(stderr, "Error: unknown module: %s\n", *name);
+            return 400;
+        }
+    }
+
+    ffInitInstance();
+    instance.config.general.detectionCache = false; // Measure the detection, not the cache
+    instance.config.display.pipe = true;
+
+    int result = 0;
+    if (snapshotDir) {
+        result = takeSnapshot(snapshotDir, moduleNames);
+    } else {
+        if (rootDir) {
+            char resolved[PATH_MAX];
+            if (!realpath(rootDir, resolved)) {
+                fprintf(stderr, "Error: invalid root directory: %s\n", rootDir);
+                return 400;
+            }
+            ffStrbufInitS(&ffIoRootPrefix, resolved);
+            ffStrbufTrimRight(&ffIoRootPrefix, '/');
+        }
+
+        printf("%-16s %10s %10s %10s %10s %10s   (ms, %u iterations)\n", "Module", "p50", "p90", "p99", "max", "mean", iterations);
+        for (const char** name = moduleNames; *name; ++name) {
+            benchModule(findModule(*name), iterations > 0 ? iterations : 1);
+        }
+    }
+
+    ffDestroyInstance();
+    return result;
+}
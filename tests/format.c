@@ -110,6 +110,15 @@ int main(void) {
         VERIFY("output({?1}OK{?}{/1}NOT OK{/})", "", "output(NOT OK)");
     }
 
+    {
+        VERIFY("output({?1}A{?1}B{?}C{?}D)", "12345 67890", "output(ABCD)");
+        VERIFY("output({?1}A{?1}B{?}C{?}D)", "", "output(C{?}D)");
+        VERIFY("output({?1}x{{?}y)", "12345 67890", "output(x{?}y)");
+        VERIFY("output({?1}x{{?}y)", "", "output(y)");
+        VERIFY("output({?1}x)", "", "output(");
+        VERIFY("output({}{-}{})", "12345 67890", "output(12345 67890");
+    }
+
 #ifndef _WIN32 // Windows doesn't have setenv
     {
         ffListInit(&instance.config.display.constants);
@@ -0,0 +1,88 @@
+#include "logo/logo.h"
+#include "common/textModifier.h"
+#include "fastfetch.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The linear scan `ffLogoGetBuiltinForName` replaced with the generated name index
+static const FFlogo* getBuiltinLinear(const FFstrbuf* name, FFLogoSize size) {
+    if (name->length == 0 || !isalpha(name->chars[0])) {
+        return NULL;
+    }
+
+    for (const FFlogo* logo = ffLogoBuiltins[toupper(name->chars[0]) - 'A']; *logo->names; ++logo) {
+        if (size == FF_LOGO_SIZE_NORMAL && logo->type != FF_LOGO_LINE_TYPE_NORMAL) {
+            continue;
+        }
+        if (size == FF_LOGO_SIZE_SMALL && logo->type != FF_LOGO_LINE_TYPE_SMALL_BIT) {
+            continue;
+        }
+
+        for (const char* const* logoName = logo->names; *logoName != NULL && logoName <= &logo->names[FASTFETCH_LOGO_MAX_NAMES]; ++logoName) {
+            if (size == FF_LOGO_SIZE_SMALL) {
+                uint32_t logoNameLength = (uint32_t) (strlen(*logoName) - strlen("_small"));
+                if (name->length == logoNameLength && strncasecmp(*logoName, name->chars, logoNameLength) == 0) {
+                    return logo;
+                }
+            }
+            if (ffStrbufIgnCaseEqualS(name, *logoName)) {
+                return logo;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void verify(const char* name, FFLogoSize size) {
+    FF_STRBUF_AUTO_DESTROY buf = ffStrbufCreateS(name);
+    const FFlogo* expected = getBuiltinLinear(&buf, size);
+    const FFlogo* result = ffLogoGetBuiltinForName(&buf, size);
+    if (result != expected) {
+        fprintf(stderr, FASTFETCH_TEXT_MODIFIER_ERROR "%s (size %d): expected %s, got %s\n" FASTFETCH_TEXT_MODIFIER_RESET,
+            name,
+            (int) size,
+            expected ? expected->names[0] : "NULL",
+            result ? result->names[0] : "NULL");
+        exit(1);
+    }
+}
+
+static void verifyAllSizes(const char* name) {
+    verify(name, FF_LOGO_SIZE_UNKNOWN);
+    verify(name, FF_LOGO_SIZE_NORMAL);
+    verify(name, FF_LOGO_SIZE_SMALL);
+}
+
+int main(void) {
+    uint32_t count = 0;
+    for (uint8_t ch = 0; ch < 26; ++ch) {
+        for (const FFlogo* logo = ffLogoBuiltins[ch]; *logo->names; ++logo) {
+            for (const char* const* logoName = logo->names; *logoName != NULL && logoName < &logo->names[FASTFETCH_LOGO_MAX_NAMES]; ++logoName) {
+                FF_STRBUF_AUTO_DESTROY name = ffStrbufCreateS(*logoName);
+                verifyAllSizes(name.chars);
+
+                ffStrbufUpperCase(&name);
+                verifyAllSizes(name.chars);
+
+                if (name.length > strlen("_small")) {
+                    ffStrbufSubstrBefore(&name, name.length - (uint32_t) strlen("_small"));
+                    verifyAllSizes(name.chars);
+                }
+                ++count;
+            }
+        }
+    }
+
+    // Unknown names
+    verifyAllSizes("");
+    verifyAllSizes("1");
+    verifyAllSizes("unknown-distribution");
+    verifyAllSizes("archlinux_tiny");
+    verifyAllSizes("a");
+
+    // Success
+    printf("\e[32mAll tests passed! (%u names)" FASTFETCH_TEXT_MODIFIER_RESET "\n", count);
+}
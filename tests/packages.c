@@ -0,0 +1,88 @@
+#include "detection/packages/packages.h"
+#include "common/io.h"
+#include "common/textModifier.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// The `memmem` loop `ffPackagesCountStrings` replaced
+static uint32_t countLinear(const FFstrbuf* content, const char* needle) {
+    uint32_t count = 0;
+    const char* iter = content->chars;
+    size_t needleLength = strlen(needle);
+    while ((iter = memmem(iter, content->length - (size_t) (iter - content->chars), needle, needleLength)) != NULL) {
+        ++count;
+        iter += needleLength;
+    }
+    return count;
+}
+
+static void verify(const char* path, const FFstrbuf* content, const char* needle) {
+    if (!ffWriteFileBuffer(path, content)) {
+        fprintf(stderr, FASTFETCH_TEXT_MODIFIER_ERROR "Failed to write %s\n" FASTFETCH_TEXT_MODIFIER_RESET, path);
+        exit(1);
+    }
+
+    uint32_t expected = countLinear(content, needle);
+    uint32_t result = ffPackagesCountStrings(path, needle);
+    if (result != expected) {
+        fprintf(stderr, FASTFETCH_TEXT_MODIFIER_ERROR "\"%s\" in %u bytes: expected %u, got %u\n" FASTFETCH_TEXT_MODIFIER_RESET,
+            needle,
+            content->length,
+            expected,
+            result);
+        exit(1);
+    }
+}
+
+int main(void) {
+    const char* tmpDir = getenv("TMPDIR");
+    FF_STRBUF_AUTO_DESTROY pathBuf = ffStrbufCreateS(tmpDir && *tmpDir ? tmpDir : "/tmp");
+    ffStrbufEnsureEndsWithC(&pathBuf, '/');
+    ffStrbufAppendS(&pathBuf, "fastfetch-test-packages-XXXXXX");
+    const char* path = pathBuf.chars;
+    int fd = mkstemp(pathBuf.chars);
+    if (fd < 0) {
+        fputs(FASTFETCH_TEXT_MODIFIER_ERROR "Failed to create a temporary file\n" FASTFETCH_TEXT_MODIFIER_RESET, stderr);
+        return 1;
+    }
+    close(fd);
+
+    const char* needles[] = { "\n", "ab", "aa", "aba", "C:Q", "Status: install ok installed", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" };
+
+    // Empty file, not mappable
+    if (ffPackagesCountStrings(path, "\n") != 0) {
+        fputs(FASTFETCH_TEXT_MODIFIER_ERROR "Empty file: expected 0\n" FASTFETCH_TEXT_MODIFIER_RESET, stderr);
+        return 1;
+    }
+
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+
+    // Overlapping and adjacent matches crossing the block boundaries
+    srand(42);
+    for (uint32_t length = 1; length < 300; length += 7) {
+        for (uint32_t round = 0; round < 8; ++round) {
+            ffStrbufClear(&content);
+            for (uint32_t i = 0; i < length; ++i) {
+                ffStrbufAppendC(&content, "ab\n"[rand() % (round < 4 ? 2 : 3)]);
+            }
+            for (uint32_t i = 0; i < ARRAY_SIZE(needles); ++i) {
+                verify(path, &content, needles[i]);
+            }
+        }
+    }
+
+    // Something like a dpkg status file
+    ffStrbufClear(&content);
+    for (uint32_t i = 0; i < 5000; ++i) {
+        ffStrbufAppendF(&content, "Package: pkg%u\nStatus: %s\nC:Q%u\n\n", i, i % 3 ? "install ok installed" : "deinstall ok config-files", i);
+    }
+    for (uint32_t i = 0; i < ARRAY_SIZE(needles); ++i) {
+        verify(path, &content, needles[i]);
+    }
+
+    unlink(path);
+
+    // Success
+    printf("\e[32mAll tests passed!" FASTFETCH_TEXT_MODIFIER_RESET "\n");
+}